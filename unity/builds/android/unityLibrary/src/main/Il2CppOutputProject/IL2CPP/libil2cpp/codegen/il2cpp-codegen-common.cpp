@@ -1,6 +1,10 @@
 #include "il2cpp-config.h"
 
 #include "gc/GarbageCollector.h"
+#include "utils/FloatConversion.h"
+
+#include <algorithm>
+#include <string.h>
 
 #if IL2CPP_ENABLE_WRITE_BARRIERS
 void Il2CppCodeGenWriteBarrier(void** targetAddress, void* object)
@@ -81,6 +85,35 @@ void Il2CppCodeGenWriteBarrierForClass(Il2CppClass* klass, void** targetAddress,
 
 #endif // !RUNTIME_TINY
 
+template<typename T>
+static int FloatToRoundTripString(T value, uint8_t* buffer, int bufferLength)
+{
+    char text[il2cpp::utils::FloatConversion::kMaxRoundTripLength];
+    const int length = il2cpp::utils::FloatConversion::FormatRoundTrip(value, text);
+    memcpy(buffer, text, std::max(0, std::min(length, bufferLength)));
+    return length;
+}
+
+int il2cpp_codegen_double_to_round_trip_string(double value, uint8_t* buffer, int bufferLength)
+{
+    return FloatToRoundTripString(value, buffer, bufferLength);
+}
+
+int il2cpp_codegen_float_to_round_trip_string(float value, uint8_t* buffer, int bufferLength)
+{
+    return FloatToRoundTripString(value, buffer, bufferLength);
+}
+
+int il2cpp_codegen_parse_double(const uint8_t* chars, int length, double* value)
+{
+    return il2cpp::utils::FloatConversion::Parse(reinterpret_cast<const char*>(chars), length, value);
+}
+
+int il2cpp_codegen_parse_float(const uint8_t* chars, int length, float* value)
+{
+    return il2cpp::utils::FloatConversion::Parse(reinterpret_cast<const char*>(chars), length, value);
+}
+
 #if IL2CPP_TINY
 
 #include <cstdio>
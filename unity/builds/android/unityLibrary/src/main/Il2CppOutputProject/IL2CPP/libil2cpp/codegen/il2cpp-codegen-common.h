@@ -236,6 +236,16 @@ inline int32_t il2cpp_codegen_get_array_length(Il2CppArray* szArray)
 
 int il2cpp_codegen_double_to_string(double value, uint8_t* format, uint8_t* buffer, int bufferLength);
 
+// Write the shortest text that parses back to value, the way the "R" format does in the invariant culture. Like
+// il2cpp_codegen_double_to_string, they return the length of the text, which only fits when it is no more than bufferLength.
+int il2cpp_codegen_double_to_round_trip_string(double value, uint8_t* buffer, int bufferLength);
+int il2cpp_codegen_float_to_round_trip_string(float value, uint8_t* buffer, int bufferLength);
+
+// Parse the invariant culture number at the start of chars, returning how many characters it takes up or 0 when
+// there is none there.
+int il2cpp_codegen_parse_double(const uint8_t* chars, int length, double* value);
+int il2cpp_codegen_parse_float(const uint8_t* chars, int length, float* value);
+
 struct Delegate_t;
 
 inline intptr_t il2cpp_codegen_marshal_get_function_pointer_for_delegate(const Delegate_t* d)
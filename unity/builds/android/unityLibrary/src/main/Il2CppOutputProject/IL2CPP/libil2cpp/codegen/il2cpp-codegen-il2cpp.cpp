@@ -124,11 +124,6 @@ const RuntimeMethod* il2cpp_codegen_get_generic_instance_method_from_method_defi
     return il2cpp::vm::Class::GetGenericInstanceMethodFromDefintion(genericInstanceClass, methodDefinition);
 }
 
-void* il2cpp_codegen_get_thread_static_data(RuntimeClass* klass)
-{
-    return il2cpp::vm::Thread::GetThreadStaticData(klass->thread_static_fields_offset);
-}
-
 void il2cpp_codegen_assert_field_size(RuntimeField* field, size_t size)
 {
     IL2CPP_ASSERT(size == il2cpp_codegen_sizeof(InitializedTypeInfo(il2cpp::vm::Class::FromIl2CppType(field->type))));
@@ -15,6 +15,7 @@
 #include "vm/ScopedThreadAttacher.h"
 #include "vm/Il2CppHStringReference.h"
 #include "vm/String.h"
+#include "vm/Thread.h"
 
 #include "utils/ExceptionSupportStack.h"
 #include "utils/Output.h"
@@ -166,7 +167,10 @@ void il2cpp_codegen_register_metadata_initialized_cleanup(MetadataInitializerCle
 
 // type registration
 
-void* il2cpp_codegen_get_thread_static_data(RuntimeClass* klass);
+inline void* il2cpp_codegen_get_thread_static_data(RuntimeClass* klass)
+{
+    return il2cpp::vm::Thread::GetThreadStaticData(klass->thread_static_fields_offset);
+}
 
 String_t* il2cpp_codegen_string_new_wrapper(const char* str);
 
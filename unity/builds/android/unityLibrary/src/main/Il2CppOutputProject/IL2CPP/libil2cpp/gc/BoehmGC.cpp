@@ -46,6 +46,9 @@ clear_ephemerons(void);
 static GC_ms_entry*
 push_ephemerons(GC_ms_entry* mark_stack_ptr, GC_ms_entry* mark_stack_limit);
 
+static void
+on_ephemeron_gc_event(GC_EventType eventType);
+
 #if !IL2CPP_ENABLE_WRITE_BARRIER_VALIDATION
 #define ELEMENT_CHUNK_SIZE 256
 #define VECTOR_PROC_INDEX 6
@@ -450,6 +453,27 @@ il2cpp::gc::GarbageCollector::FreeFixed(void* addr)
     GC_FREE(addr);
 }
 
+void*
+il2cpp::gc::GarbageCollector::MakeDescriptorForTypedMemory(size_t *bitmap, int numbits)
+{
+    // An empty bitmap yields 0, which we hand out as the NULL "no references" descriptor.
+    return (void*)GC_make_descriptor((GC_bitmap)bitmap, numbits);
+}
+
+void*
+il2cpp::gc::GarbageCollector::AllocateTyped(size_t size, void *descr)
+{
+    if (descr == NULL)
+    {
+        void* memory = GC_MALLOC_ATOMIC(size);
+        if (memory != NULL)
+            memset(memory, 0, size);
+        return memory;
+    }
+
+    return GC_MALLOC_EXPLICITLY_TYPED(size, (GC_descr)descr);
+}
+
 #if !RUNTIME_TINY
 int32_t
 il2cpp::gc::GarbageCollector::InvokeFinalizers()
@@ -490,6 +514,8 @@ il2cpp::gc::GarbageCollector::IsIncremental()
 void on_gc_event(GC_EventType eventType)
 {
 #if !RUNTIME_TINY
+    on_ephemeron_gc_event(eventType);
+
     if (eventType == GC_EVENT_RECLAIM_START)
     {
         clear_ephemerons();
@@ -575,8 +601,44 @@ struct ephemeron_node
 {
     ephemeron_node* next;
     void* ephemeron_array_weak_link;
+    /* indices of the entries whose key was not marked yet, valid while epoch is the current world stop */
+    uint32_t* pending;
+    uint32_t pending_count;
+    uint32_t epoch;
 };
 
+/*
+ * While the world is stopped nothing can store into an ephemeron array, so the entries whose key was already
+ * marked (or that are empty) can be skipped by every later pass over the array during the same stop. With the
+ * world running (incremental marking, or builds without thread events) every pass rescans all the entries.
+ */
+static uint32_t ephemeron_epoch;
+static uint32_t ephemeron_marked_epoch;
+static bool ephemeron_world_stopped;
+
+static void
+on_ephemeron_gc_event(GC_EventType eventType)
+{
+    switch (eventType)
+    {
+        case GC_EVENT_POST_STOP_WORLD:
+            /* 0 marks an array that has not been scanned during a stop */
+            if (++ephemeron_epoch == 0)
+                ephemeron_epoch = 1;
+            ephemeron_world_stopped = true;
+            break;
+        case GC_EVENT_MARK_END:
+            /* the pending entries of this stop are the only candidates clear_ephemerons has to look at */
+            ephemeron_marked_epoch = ephemeron_world_stopped ? ephemeron_epoch : 0;
+            break;
+        case GC_EVENT_PRE_START_WORLD:
+            ephemeron_world_stopped = false;
+            break;
+        default:
+            break;
+    }
+}
+
 
 static void*
 ephemeron_array_add(void* arg)
@@ -595,6 +657,13 @@ struct Ephemeron
     Il2CppObject* value;
 };
 
+/* keys outside the GC heap, such as frozen string literals, are never collected and have no mark bit */
+static inline bool
+is_ephemeron_key_marked(Il2CppObject* key)
+{
+    return !GC_is_heap_ptr(key) || GC_is_marked(key);
+}
+
 static void
 clear_ephemerons(void)
 {
@@ -625,6 +694,24 @@ clear_ephemerons(void)
         array_end = current_ephemeron + array->max_length;
         tombstone = il2cpp::vm::Domain::GetCurrent()->ephemeron_tombstone;
 
+        if (ephemeron_marked_epoch != 0 && current_node->epoch == ephemeron_marked_epoch)
+        {
+            /* every entry that is not pending had its key marked when marking finished */
+            Ephemeron* ephemerons = current_ephemeron;
+            for (uint32_t i = 0; i < current_node->pending_count; ++i)
+            {
+                current_ephemeron = &ephemerons[current_node->pending[i]];
+                if (current_ephemeron->key && current_ephemeron->key != tombstone && !is_ephemeron_key_marked(current_ephemeron->key))
+                {
+                    il2cpp::gc::WriteBarrier::GenericStore(&current_ephemeron->key, tombstone);
+                    current_ephemeron->value = NULL;
+                }
+            }
+
+            current_node->epoch = 0;
+            continue;
+        }
+
         for (; current_ephemeron < array_end; ++current_ephemeron)
         {
             /* skip a null or tombstone (empty) key */
@@ -632,12 +719,14 @@ clear_ephemerons(void)
                 continue;
 
             /* If the key is not marked, then set it to the tombstone and the value to NULL. */
-            if (!GC_is_marked(current_ephemeron->key))
+            if (!is_ephemeron_key_marked(current_ephemeron->key))
             {
                 il2cpp::gc::WriteBarrier::GenericStore(&current_ephemeron->key, tombstone);
                 current_ephemeron->value = NULL;
             }
         }
+
+        current_node->epoch = 0;
     }
 }
 
@@ -667,6 +756,35 @@ push_ephemerons(GC_ms_entry* mark_stack_ptr, GC_ms_entry* mark_stack_limit)
         array_end = current_ephemeron + array->max_length;
         tombstone = il2cpp::vm::Domain::GetCurrent()->ephemeron_tombstone;
 
+        Ephemeron* ephemerons = current_ephemeron;
+
+        if (ephemeron_world_stopped && current_node->epoch == ephemeron_epoch)
+        {
+            /* only the entries whose key was not marked on the previous pass can have anything left to push */
+            uint32_t still_pending = 0;
+            for (uint32_t i = 0; i < current_node->pending_count; ++i)
+            {
+                const uint32_t index = current_node->pending[i];
+                current_ephemeron = &ephemerons[index];
+                if (!is_ephemeron_key_marked(current_ephemeron->key))
+                {
+                    current_node->pending[still_pending++] = index;
+                    continue;
+                }
+
+                if (current_ephemeron->value)
+                {
+                    mark_stack_ptr = GC_mark_and_push((void*)current_ephemeron->value, mark_stack_ptr, mark_stack_limit, (void**)&current_ephemeron->value);
+                }
+            }
+
+            current_node->pending_count = still_pending;
+            continue;
+        }
+
+        const bool track_pending = ephemeron_world_stopped;
+        uint32_t pending_count = 0;
+
         for (; current_ephemeron < array_end; ++current_ephemeron)
         {
             /* skip a null or tombstone (empty) key */
@@ -674,14 +792,21 @@ push_ephemerons(GC_ms_entry* mark_stack_ptr, GC_ms_entry* mark_stack_limit)
                 continue;
 
             /* If the key is not marked, then don't mark value. */
-            if (!GC_is_marked(current_ephemeron->key))
+            if (!is_ephemeron_key_marked(current_ephemeron->key))
+            {
+                if (track_pending)
+                    current_node->pending[pending_count++] = (uint32_t)(current_ephemeron - ephemerons);
                 continue;
+            }
 
             if (current_ephemeron->value)
             {
                 mark_stack_ptr = GC_mark_and_push((void*)current_ephemeron->value, mark_stack_ptr, mark_stack_limit, (void**)&current_ephemeron->value);
             }
         }
+
+        current_node->pending_count = pending_count;
+        current_node->epoch = track_pending ? ephemeron_epoch : 0;
     }
 
     return mark_stack_ptr;
@@ -692,6 +817,9 @@ bool il2cpp::gc::GarbageCollector::EphemeronArrayAdd(Il2CppObject* obj)
     ephemeron_node* item = (ephemeron_node*)GC_MALLOC(sizeof(ephemeron_node));
     memset(item, 0, sizeof(ephemeron_node));
 
+    /* allocated up front, the marker cannot allocate */
+    il2cpp::gc::WriteBarrier::GenericStore(&item->pending, (uint32_t*)GC_MALLOC_ATOMIC(((Il2CppArray*)obj)->max_length * sizeof(uint32_t)));
+
     AddWeakLink(&item->ephemeron_array_weak_link, obj, false);
 
     GC_call_with_alloc_lock(ephemeron_array_add, item);
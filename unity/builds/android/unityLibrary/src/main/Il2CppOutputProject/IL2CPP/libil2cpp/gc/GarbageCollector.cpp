@@ -1,16 +1,22 @@
 #include "il2cpp-config.h"
 #include "il2cpp-object-internals.h"
+#include "il2cpp-runtime-stats.h"
 #include "GarbageCollector.h"
+#include "os/Atomic.h"
 #include "os/Event.h"
 #include "os/Mutex.h"
 #include "os/Semaphore.h"
 #include "os/Thread.h"
+#include "os/Time.h"
 #include "utils/Il2CppHashMap.h"
 #include "utils/HashUtils.h"
 
 #include "Baselib.h"
 #include "Cpp/ReentrantLock.h"
 
+#include <algorithm>
+#include <vector>
+
 #if !RUNTIME_TINY
 #include "vm/CCW.h"
 #include "vm/Class.h"
@@ -81,6 +87,17 @@ namespace gc
     static baselib::ReentrantLock s_CCWCacheMutex;
     static CCWCache s_CCWCache;
 
+    static void InvokeFinalizer(Il2CppObject* obj)
+    {
+        Il2CppException *exc = NULL;
+        const MethodInfo* finalizer = Class::GetFinalizer(obj->klass);
+
+        Runtime::Invoke(finalizer, obj, NULL, &exc);
+
+        if (exc)
+            Runtime::UnhandledException(exc);
+    }
+
 #if IL2CPP_SUPPORT_THREADS
 
     static bool s_StopFinalizer = false;
@@ -90,32 +107,210 @@ namespace gc
     static Event s_FinalizersThreadStartedEvent;
     static Event s_FinalizersCompletedEvent(true, false);
 
+#if IL2CPP_FINALIZER_THREAD_COUNT > 1
+// The GC Finalizer thread drains the objects bdwgc has ready into batches, instead of running their finalizers
+// one at a time, and then runs the batches together with the worker threads. Each thread claims the next batch
+// through an atomic index, so there is no lock between them. Finalizers of CriticalFinalizerObjects get batches
+// of their own, which only start once all the others have run.
+    const uint32_t kFinalizerBatchSize = 256;
+    const int32_t kFinalizerWorkerCount = IL2CPP_FINALIZER_THREAD_COUNT - 1;
+
+    // Allocated uncollectable, which keeps the objects in it alive until their finalizer has run.
+    struct FinalizerBatch
+    {
+        uint32_t count;
+        Il2CppObject* objects[kFinalizerBatchSize];
+    };
+
+    typedef std::vector<FinalizerBatch*> FinalizerBatchList;
+
+    // Only touched by the GC Finalizer thread, apart from the batches the workers run.
+    static bool s_CollectingFinalizers;
+    static Il2CppClass* s_CriticalFinalizerObjectClass;
+    static FinalizerBatchList s_FinalizerBatches;
+    static FinalizerBatchList s_CriticalFinalizerBatches;
+
+    static il2cpp::os::Thread* s_FinalizerWorkers[kFinalizerWorkerCount];
+    static Il2CppThread* s_FinalizerWorkerObjects[kFinalizerWorkerCount];
+    static Semaphore s_FinalizerWorkSemaphore(0, 32767);
+    static Semaphore s_FinalizerWorkDoneSemaphore(0, 32767);
+
+    static FinalizerBatch* const* s_RunningFinalizerBatches;
+    static int32_t s_RunningFinalizerBatchCount;
+    static int32_t s_NextFinalizerBatch;
+
+    static void QueueFinalizer(Il2CppObject* obj)
+    {
+        FinalizerBatchList& batches = s_CriticalFinalizerObjectClass != NULL && Class::HasParent(obj->klass, s_CriticalFinalizerObjectClass)
+            ? s_CriticalFinalizerBatches : s_FinalizerBatches;
+
+        if (batches.empty() || batches.back()->count == kFinalizerBatchSize)
+            batches.push_back(static_cast<FinalizerBatch*>(GarbageCollector::AllocateFixed(sizeof(FinalizerBatch), NULL)));
+
+        FinalizerBatch* batch = batches.back();
+        batch->objects[batch->count++] = obj;
+        ++il2cpp_runtime_stats.finalizer_queue_depth;
+    }
+
+    static void RunClaimedFinalizerBatches()
+    {
+        for (;;)
+        {
+            const int32_t index = Atomic::Increment(&s_NextFinalizerBatch) - 1;
+            if (index >= s_RunningFinalizerBatchCount)
+                break;
+
+            FinalizerBatch* batch = s_RunningFinalizerBatches[index];
+            for (uint32_t i = 0; i < batch->count; ++i)
+                InvokeFinalizer(batch->objects[i]);
+
+            il2cpp_runtime_stats.finalizer_count += batch->count;
+            il2cpp_runtime_stats.finalizer_queue_depth -= batch->count;
+        }
+    }
+
+    static void RunFinalizerBatches(FinalizerBatchList& batches)
+    {
+        if (batches.empty())
+            return;
+
+        s_RunningFinalizerBatches = &batches[0];
+        s_RunningFinalizerBatchCount = static_cast<int32_t>(batches.size());
+        s_NextFinalizerBatch = 0;
+
+        // The semaphores order the setup above before the workers and their batches before the frees below.
+        const int32_t workers = std::min(kFinalizerWorkerCount, s_RunningFinalizerBatchCount - 1);
+        if (workers > 0)
+            s_FinalizerWorkSemaphore.Post(workers, NULL);
+
+        RunClaimedFinalizerBatches();
+
+        for (int32_t i = 0; i < workers; ++i)
+            s_FinalizerWorkDoneSemaphore.Wait();
+
+        for (FinalizerBatchList::iterator it = batches.begin(); it != batches.end(); ++it)
+            GarbageCollector::FreeFixed(*it);
+
+        batches.clear();
+    }
+
+    static void InvokeFinalizersInBatches()
+    {
+        s_CollectingFinalizers = true;
+        GarbageCollector::InvokeFinalizers();
+        s_CollectingFinalizers = false;
+
+        RunFinalizerBatches(s_FinalizerBatches);
+        RunFinalizerBatches(s_CriticalFinalizerBatches);
+    }
+
+    static void FinalizerWorkerThread(void* arg)
+    {
+        const int32_t index = static_cast<int32_t>(reinterpret_cast<intptr_t>(arg));
+        s_FinalizerWorkerObjects[index] = il2cpp::vm::Thread::Attach(Domain::GetCurrent());
+        s_FinalizerWorkers[index]->SetName("GC Finalizer Worker");
+
+        s_FinalizerWorkDoneSemaphore.Post(1, NULL);
+
+        for (;;)
+        {
+            s_FinalizerWorkSemaphore.Wait();
+            if (s_StopFinalizer)
+                break;
+
+            RunClaimedFinalizerBatches();
+
+            s_FinalizerWorkDoneSemaphore.Post(1, NULL);
+        }
+
+        il2cpp::vm::Thread::Detach(s_FinalizerWorkerObjects[index]);
+    }
+
+    static void StartFinalizerWorkers()
+    {
+        s_CriticalFinalizerObjectClass = Class::FromName(il2cpp_defaults.corlib, "System.Runtime.ConstrainedExecution", "CriticalFinalizerObject");
+
+        for (int32_t i = 0; i < kFinalizerWorkerCount; ++i)
+        {
+            s_FinalizerWorkers[i] = new il2cpp::os::Thread;
+            s_FinalizerWorkers[i]->Run(&FinalizerWorkerThread, reinterpret_cast<void*>(static_cast<intptr_t>(i)));
+        }
+
+        for (int32_t i = 0; i < kFinalizerWorkerCount; ++i)
+            s_FinalizerWorkDoneSemaphore.Wait();
+    }
+
+    static void StopFinalizerWorkers()
+    {
+        s_FinalizerWorkSemaphore.Post(kFinalizerWorkerCount, NULL);
+
+        for (int32_t i = 0; i < kFinalizerWorkerCount; ++i)
+        {
+            s_FinalizerWorkers[i]->Join();
+            delete s_FinalizerWorkers[i];
+            s_FinalizerWorkers[i] = NULL;
+            s_FinalizerWorkerObjects[i] = NULL;
+        }
+    }
+
+#endif
+
     static void FinalizerThread(void* arg)
     {
         s_FinalizerThreadObject = il2cpp::vm::Thread::Attach(Domain::GetCurrent());
         s_FinalizerThread->SetName("GC Finalizer");
 
+#if IL2CPP_FINALIZER_THREAD_COUNT > 1
+        StartFinalizerWorkers();
+#endif
+
         s_FinalizersThreadStartedEvent.Set();
 
         while (!s_StopFinalizer)
         {
             s_FinalizerSemaphore.Wait();
 
+            const int64_t start = Time::GetTicks100NanosecondsMonotonic();
+#if IL2CPP_FINALIZER_THREAD_COUNT > 1
+            InvokeFinalizersInBatches();
+#else
             GarbageCollector::InvokeFinalizers();
+#endif
+            il2cpp_runtime_stats.finalizer_time_usecs += (Time::GetTicks100NanosecondsMonotonic() - start) / 10;
 
             s_FinalizersCompletedEvent.Set();
         }
 
+#if IL2CPP_FINALIZER_THREAD_COUNT > 1
+        StopFinalizerWorkers();
+#endif
+
         il2cpp::vm::Thread::Detach(s_FinalizerThreadObject);
     }
 
     bool GarbageCollector::IsFinalizerThread(Il2CppThread *thread)
     {
+#if IL2CPP_FINALIZER_THREAD_COUNT > 1
+        for (int32_t i = 0; i < kFinalizerWorkerCount; ++i)
+        {
+            if (s_FinalizerWorkerObjects[i] == thread)
+                return true;
+        }
+#endif
+
         return s_FinalizerThreadObject == thread;
     }
 
     bool GarbageCollector::IsFinalizerInternalThread(Il2CppInternalThread *thread)
     {
+#if IL2CPP_FINALIZER_THREAD_COUNT > 1
+        for (int32_t i = 0; i < kFinalizerWorkerCount; ++i)
+        {
+            if (s_FinalizerWorkerObjects[i] != NULL && s_FinalizerWorkerObjects[i]->GetInternalThread() == thread)
+                return true;
+        }
+#endif
+
         return s_FinalizerThreadObject->GetInternalThread() == thread;
     }
 
@@ -167,18 +362,18 @@ namespace gc
     {
         IL2CPP_NOT_IMPLEMENTED_NO_ASSERT(GarbageCollector::RunFinalizer, "Compare to mono implementation special cases");
 
-        Il2CppException *exc = NULL;
-        Il2CppObject *o;
-        const MethodInfo* finalizer = NULL;
-
-        o = (Il2CppObject*)obj;
-
-        finalizer = Class::GetFinalizer(o->klass);
+        Il2CppObject* o = (Il2CppObject*)obj;
 
-        Runtime::Invoke(finalizer, o, NULL, &exc);
+#if IL2CPP_SUPPORT_THREADS && IL2CPP_FINALIZER_THREAD_COUNT > 1
+        if (s_CollectingFinalizers && vm::Thread::Current() == s_FinalizerThreadObject)
+        {
+            QueueFinalizer(o);
+            return;
+        }
+#endif
 
-        if (exc)
-            Runtime::UnhandledException(exc);
+        InvokeFinalizer(o);
+        ++il2cpp_runtime_stats.finalizer_count;
     }
 
     void GarbageCollector::RegisterFinalizerForNewObject(Il2CppObject* obj)
@@ -82,6 +82,12 @@ namespace gc
         static void* AllocateFixed(size_t size, void *descr);
         static void FreeFixed(void* addr);
 
+        // Zeroed memory that is only kept alive by references from memory the collector scans, and of
+        // which only the words set in the descriptor's bitmap are scanned. A NULL descriptor means the
+        // memory holds no references at all.
+        static void* MakeDescriptorForTypedMemory(size_t *bitmap, int numbits);
+        static void* AllocateTyped(size_t size, void *descr);
+
         static void RegisterThread();
         static bool UnregisterThread();
 
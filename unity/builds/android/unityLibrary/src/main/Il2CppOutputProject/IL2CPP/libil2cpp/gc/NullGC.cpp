@@ -23,6 +23,19 @@ il2cpp::gc::GarbageCollector::AllocateFixed(size_t size, void *descr)
     return IL2CPP_MALLOC_ZERO(size);
 }
 
+void*
+il2cpp::gc::GarbageCollector::MakeDescriptorForTypedMemory(size_t *bitmap, int numbits)
+{
+    return NULL;
+}
+
+void*
+il2cpp::gc::GarbageCollector::AllocateTyped(size_t size, void *descr)
+{
+    // Nothing is ever collected with the null GC, so this memory is never given back either.
+    return IL2CPP_MALLOC_ZERO(size);
+}
+
 void*
 il2cpp::gc::GarbageCollector::MakeDescriptorForObject(size_t *bitmap, int numbits)
 {
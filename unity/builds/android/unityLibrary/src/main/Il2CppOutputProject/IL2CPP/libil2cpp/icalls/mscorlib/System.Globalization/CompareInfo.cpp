@@ -8,11 +8,15 @@
 #include "vm/Exception.h"
 #include "vm/Array.h"
 #include "utils/StringUtils.h"
+#include "utils/Utf16Simd.h"
 #include "vm-utils/VmStringUtils.h"
 #include <cwctype>
 #include <wctype.h>
 #include <algorithm>
 
+#include "Baselib.h"
+#include "Cpp/Algorithm.h"
+
 namespace il2cpp
 {
 namespace icalls
@@ -54,68 +58,178 @@ namespace Globalization
         return ((result < 0) ? -1 : (result > 0) ? 1 : 0);
     }
 
+#if IL2CPP_UTF16_SIMD
+    using namespace utils::Utf16Simd;
+#endif
+
+    // Index of the first position below length where the two strings hold different code units, or length.
+    static int32_t FindFirstMismatchOrdinal(const Il2CppChar* str1, const Il2CppChar* str2, int32_t length)
+    {
+        int32_t pos = 0;
+
+#if IL2CPP_UTF16_SIMD
+        for (; pos + kCharsPerVector <= length; pos += kCharsPerVector)
+        {
+            const uint32_t equal = LaneMask(EqualChars(LoadChars(str1 + pos), LoadChars(str2 + pos)));
+            if (equal != kAllLanes)
+                return pos + baselib::Algorithm::LowestBitNonZero(~equal & kAllLanes);
+        }
+#endif
+
+        for (; pos < length; pos++)
+        {
+            if (str1[pos] != str2[pos])
+                return pos;
+        }
+
+        return length;
+    }
+
+    // The same for IgnoreCase. Runs of ASCII are case folded in bulk, anything else goes through towlower
+    // like string_invariant_compare_char does.
+    static int32_t FindFirstMismatchIgnoreCase(const Il2CppChar* str1, const Il2CppChar* str2, int32_t length)
+    {
+        int32_t pos = 0;
+
+#if IL2CPP_UTF16_SIMD
+        for (; pos + kCharsPerVector <= length; pos += kCharsPerVector)
+        {
+            const CharVector chars1 = LoadChars(str1 + pos);
+            const CharVector chars2 = LoadChars(str2 + pos);
+
+            if (IsAscii(OrChars(chars1, chars2)))
+            {
+                const uint32_t equal = LaneMask(EqualChars(ToLowerAscii(chars1), ToLowerAscii(chars2)));
+                if (equal != kAllLanes)
+                    return pos + baselib::Algorithm::LowestBitNonZero(~equal & kAllLanes);
+            }
+            else
+            {
+                for (int32_t i = pos; i < pos + kCharsPerVector; i++)
+                {
+                    if (str1[i] != str2[i] && towlower(str1[i]) != towlower(str2[i]))
+                        return i;
+                }
+            }
+        }
+#endif
+
+        for (; pos < length; pos++)
+        {
+            if (str1[pos] != str2[pos] && towlower(str1[pos]) != towlower(str2[pos]))
+                return pos;
+        }
+
+        return length;
+    }
+
     int32_t CompareInfo::internal_compare_icall(Il2CppChar* str1, int32_t length1, Il2CppChar* str2, int32_t length2, int32_t options)
     {
         // Do a normal ascii string compare, as we only know the invariant locale if we dont have ICU.
-        /* c translation of C# code from old string.cs.. :) */
-        const int length = std::max(length1, length2);
-        int charcmp;
-        int pos = 0;
+        // Every option other than IgnoreCase compares code units as they are, see string_invariant_compare_char.
+        const int32_t length = std::min(length1, length2);
+        const bool ignoreCase = (options & CompareOptions_IgnoreCase) != 0 && (options & CompareOptions_Ordinal) == 0;
+        const int32_t pos = ignoreCase ? FindFirstMismatchIgnoreCase(str1, str2, length) : FindFirstMismatchOrdinal(str1, str2, length);
+
+        if (pos < length)
+            return string_invariant_compare_char(str1[pos], str2[pos], options);
 
-        for (pos = 0; pos != length; pos++)
+        /* the lesser wins */
+        if (length1 == length2)
+            return 0;
+
+        return length1 < length2 ? -1 : 1;
+    }
+
+    static inline bool MatchesAt(const Il2CppChar* source, const Il2CppChar* value, int32_t value_length)
+    {
+        return memcmp(source, value, value_length * sizeof(Il2CppChar)) == 0;
+    }
+
+    // Candidate positions are the ones where both the first and the last character of value match, which rules out
+    // nearly all of them before a full comparison (see "SIMD-friendly algorithms for substring searching", W. Mula).
+    static int32_t IndexOfForward(const Il2CppChar* source, int32_t start, int32_t last, const Il2CppChar* value, int32_t value_length)
+    {
+        int32_t pos = start;
+
+#if IL2CPP_UTF16_SIMD
+        const CharVector firstChar = SplatChar(value[0]);
+        const CharVector lastChar = SplatChar(value[value_length - 1]);
+
+        for (; pos + kCharsPerVector - 1 <= last; pos += kCharsPerVector)
         {
-            if (pos >= length1 || pos >= length2)
-                break;
+            const CharVector firstMatches = EqualChars(LoadChars(source + pos), firstChar);
+            const CharVector lastMatches = EqualChars(LoadChars(source + pos + value_length - 1), lastChar);
 
-            charcmp = string_invariant_compare_char(str1[pos], str2[pos],
-                options);
-            if (charcmp != 0)
-                return (charcmp);
+            for (uint32_t candidates = LaneMask(AndChars(firstMatches, lastMatches)); candidates != 0; candidates &= candidates - 1)
+            {
+                const int32_t candidate = pos + baselib::Algorithm::LowestBitNonZero(candidates);
+                if (MatchesAt(source + candidate, value, value_length))
+                    return candidate;
+            }
+        }
+#endif
+
+        for (; pos <= last; pos++)
+        {
+            if (source[pos] == value[0] && MatchesAt(source + pos, value, value_length))
+                return pos;
         }
 
-        /* the lesser wins, so if we have looped until length we just
-         * need to check the last char
-         */
-        if (pos == length)
-            return (string_invariant_compare_char(str1[pos - 1], str2[pos - 1], options));
+        return -1;
+    }
+
+    static int32_t IndexOfBackward(const Il2CppChar* source, int32_t start, int32_t last, const Il2CppChar* value, int32_t value_length)
+    {
+        int32_t pos = start;
+
+#if IL2CPP_UTF16_SIMD
+        const CharVector firstChar = SplatChar(value[0]);
+        const CharVector lastChar = SplatChar(value[value_length - 1]);
+
+        for (; pos - (kCharsPerVector - 1) >= last; pos -= kCharsPerVector)
+        {
+            const int32_t base = pos - (kCharsPerVector - 1);
+            const CharVector firstMatches = EqualChars(LoadChars(source + base), firstChar);
+            const CharVector lastMatches = EqualChars(LoadChars(source + base + value_length - 1), lastChar);
 
-        /* Test if one of the strings has been compared to the end */
-        if (pos >= length1)
+            for (uint32_t candidates = LaneMask(AndChars(firstMatches, lastMatches)); candidates != 0;)
+            {
+                const int32_t lane = baselib::Algorithm::HighestBitNonZero(candidates);
+                if (MatchesAt(source + base + lane, value, value_length))
+                    return base + lane;
+
+                candidates &= ~(1u << lane);
+            }
+        }
+#endif
+
+        for (; pos >= last; pos--)
         {
-            if (pos >= length2)
-                return (0);
-            return (-1);
+            if (source[pos] == value[0] && MatchesAt(source + pos, value, value_length))
+                return pos;
         }
-        else if (pos >= length2)
-            return (1);
 
-        /* if not, check our last char only.. (can this happen?) */
-        return (string_invariant_compare_char(str1[pos], str2[pos], options));
+        return -1;
     }
 
     int32_t CompareInfo::internal_index_icall(Il2CppChar* source, int32_t sindex, int32_t count, Il2CppChar* value, int32_t value_length, bool first)
     {
-        int pos, i;
+        if (value_length <= 0)
+            return sindex;
 
         if (first)
         {
-            count -= value_length;
-            for (pos = sindex; pos <= sindex + count; pos++)
-                for (i = 0; source[pos + i] == value[i];)
-                    if (++i == value_length)
-                        return (pos);
-
-            return (-1);
+            // Searches the positions [sindex, sindex + count - value_length].
+            return IndexOfForward(source, sindex, sindex + count - value_length, value, value_length);
         }
         else
         {
-            for (pos = sindex - value_length + 1; pos > sindex - count; pos--)
-                if (memcmp(source + pos, value, value_length * sizeof(Il2CppChar)) == 0)
-                    return (pos);
-
-            return (-1);
+            // Searches the positions [sindex - count + 1, sindex - value_length + 1], from the end.
+            return IndexOfBackward(source, sindex - value_length + 1, sindex - count + 1, value, value_length);
         }
     }
+
 } /* namespace Globalization */
 } /* namespace System */
 } /* namespace mscorlib */
@@ -237,7 +237,7 @@ namespace Reflection
         il2cpp::vm::Class::SetupMethods(klass);
 
         IL2CPP_ASSERT(offset >= 0 && offset < klass->method_count);
-        return klass->methods[offset];
+        return il2cpp::vm::Class::GetMethodAt(klass, static_cast<uint16_t>(offset));
     }
 
     Il2CppReflectionMethod* RuntimeMethodInfo::GetMethodFromHandleInternalType_native(intptr_t method_handle, intptr_t type_handle, bool genericCheck)
@@ -215,6 +215,20 @@ namespace InteropServices
         return vm::String::NewUtf16(value, len);
     }
 
+    static inline void ConstructStructure(const Il2CppMarshalDescriptor* descriptor, Il2CppObject* structure)
+    {
+        typedef void (*Constructor)(Il2CppObject*);
+        reinterpret_cast<Constructor>(descriptor->defaultConstructor)(structure);
+    }
+
+    static void RaiseNotMarshalableStructure(Il2CppClass* type, const char* paramName)
+    {
+        if (type->generic_class != NULL || type->is_generic)
+            vm::Exception::Raise(vm::Exception::GetArgumentException(paramName, "The specified object must not be an instance of a generic type."));
+
+        vm::Exception::Raise(vm::Exception::GetArgumentException(paramName, "The specified structure must be blittable or have layout information."));
+    }
+
     Il2CppObject* Marshal::PtrToStructure(intptr_t ptr, Il2CppReflectionType* structureType)
     {
         if (ptr == 0)
@@ -224,55 +238,46 @@ namespace InteropServices
             vm::Exception::Raise(vm::Exception::GetArgumentNullException("structureType"));
 
         Il2CppClass* type = vm::Class::FromIl2CppType(structureType->type);
+        const Il2CppMarshalDescriptor* descriptor = utils::MarshalingUtils::GetMarshalDescriptor(type);
 
         Il2CppTypeEnum typeType = structureType->type->type;
 
-        if (typeType == IL2CPP_TYPE_STRING || typeType == IL2CPP_TYPE_SZARRAY || (typeType == IL2CPP_TYPE_CLASS && !vm::Class::HasDefaultConstructor(type)))
+        if (typeType == IL2CPP_TYPE_STRING || typeType == IL2CPP_TYPE_SZARRAY || (typeType == IL2CPP_TYPE_CLASS && !descriptor->hasDefaultConstructor))
         {
             vm::Exception::Raise(vm::Exception::GetMissingMethodException("No parameterless constructor defined for this object."));
         }
 
-        if (type->interopData != NULL && type->interopData->pinvokeMarshalFromNativeFunction != NULL)
+        if (descriptor->marshalFromNativeFunction != NULL)
         {
             Il2CppObject* result = vm::Object::New(type);
 
             if (typeType == IL2CPP_TYPE_CLASS)
             {
-                typedef void (*Constructor)(Il2CppObject*);
-                Constructor ctor = reinterpret_cast<Constructor>(vm::Class::GetMethodFromName(type, ".ctor", 0)->virtualMethodPointer);
-                ctor(result);
-                utils::MarshalingUtils::MarshalStructFromNative(reinterpret_cast<void*>(ptr), result, type->interopData);
+                ConstructStructure(descriptor, result);
+                descriptor->marshalFromNativeFunction(reinterpret_cast<void*>(ptr), result);
             }
             else
             {
-                utils::MarshalingUtils::MarshalStructFromNative(reinterpret_cast<void*>(ptr), vm::Object::Unbox(result), type->interopData);
+                descriptor->marshalFromNativeFunction(reinterpret_cast<void*>(ptr), vm::Object::Unbox(result));
             }
 
             return result;
         }
 
+        // We may also need to throw a NotSupportedException for an ArgIterator.
+        if (type->native_size != -1 && typeType == IL2CPP_TYPE_VOID)
+            vm::Exception::Raise(vm::Exception::GetNotSupportedException("Cannot dynamically create an instance of System.Void."));
+
         // If there's no custom marshal function, it means it's either a primitive, or invalid argument
-        if (type->native_size != -1)
+        if (descriptor->isBlittable)
         {
-            // We may also need to throw a NotSupportedException for an ArgIterator.
-            if (structureType->type->type == IL2CPP_TYPE_VOID)
-                vm::Exception::Raise(vm::Exception::GetNotSupportedException("Cannot dynamically create an instance of System.Void."));
-
-            // PtrToStructure is supposed to throw on enums
-            if (!type->enumtype)
-            {
-                Il2CppObject* result = vm::Object::New(type);
-                memcpy(vm::Object::Unbox(result), reinterpret_cast<void*>(ptr), type->native_size);
-                return result;
-            }
+            Il2CppObject* result = vm::Object::New(type);
+            memcpy(vm::Object::Unbox(result), reinterpret_cast<void*>(ptr), descriptor->nativeSize);
+            return result;
         }
 
         // If we got this far, throw an exception
-
-        if (type->generic_class != NULL || type->is_generic)
-            vm::Exception::Raise(vm::Exception::GetArgumentException("structure", "The specified object must not be an instance of a generic type."));
-
-        vm::Exception::Raise(vm::Exception::GetArgumentException("structure", "The specified structure must be blittable or have layout information."));
+        RaiseNotMarshalableStructure(type, "structure");
         return NULL;
     }
 
@@ -292,16 +297,14 @@ namespace InteropServices
             vm::Exception::Raise(vm::Exception::GetArgumentException("structure", "The specified structure must be an instance of a formattable class."));
         }
 
-        if (type->interopData != NULL && type->interopData->pinvokeMarshalFromNativeFunction != NULL)
+        const Il2CppMarshalDescriptor* descriptor = utils::MarshalingUtils::GetMarshalDescriptor(type);
+        if (descriptor->marshalFromNativeFunction != NULL)
         {
-            utils::MarshalingUtils::MarshalStructFromNative(reinterpret_cast<void*>(ptr), structure, type->interopData);
+            descriptor->marshalFromNativeFunction(reinterpret_cast<void*>(ptr), structure);
             return;
         }
 
-        if (type->generic_class || type->is_generic)
-            vm::Exception::Raise(vm::Exception::GetArgumentException("structure", "The specified object must not be an instance of a generic type."));
-
-        vm::Exception::Raise(vm::Exception::GetArgumentException("structure", "The specified structure must be blittable or have layout information."));
+        RaiseNotMarshalableStructure(type, "structure");
     }
 
     int32_t Marshal::QueryInterfaceInternal(intptr_t pUnk, mscorlib_System_Guid * iid, intptr_t* ppv)
@@ -431,42 +434,28 @@ namespace InteropServices
             vm::Exception::Raise(vm::Exception::GetArgumentNullException("ptr"));
 
         Il2CppClass* type = structure->klass;
+        const Il2CppMarshalDescriptor* descriptor = utils::MarshalingUtils::GetMarshalDescriptor(type);
 
-        if (type->interopData != NULL && type->interopData->pinvokeMarshalToNativeFunction != NULL)
+        if (descriptor->marshalToNativeFunction != NULL)
         {
-            if (deleteOld)
-                utils::MarshalingUtils::MarshalFreeStruct(reinterpret_cast<void*>(ptr), type->interopData);
+            if (deleteOld && descriptor->marshalCleanupFunction != NULL)
+                descriptor->marshalCleanupFunction(reinterpret_cast<void*>(ptr));
 
             void* objectPtr = (type->byval_arg.type == IL2CPP_TYPE_CLASS) ? structure : vm::Object::Unbox(structure);
-            utils::MarshalingUtils::MarshalStructToNative(objectPtr, reinterpret_cast<void*>(ptr), type->interopData);
+            descriptor->marshalToNativeFunction(objectPtr, reinterpret_cast<void*>(ptr));
             return;
         }
 
-        // If there's no custom marshal function, it means it's either a primitive, or invalid argument
-
-        if (type->native_size != -1)
+        // If there's no custom marshal function, it means it's either a primitive, or invalid argument.
+        // StructureToPtr is supposed to throw on strings and enums, which are never blittable.
+        if (descriptor->isBlittable)
         {
-            // StructureToPtr is supposed to throw on strings and enums
-            if (!type->enumtype && type->byval_arg.type != IL2CPP_TYPE_STRING)
-            {
-                memcpy(reinterpret_cast<void*>(ptr), vm::Object::Unbox(structure), type->native_size);
-                return;
-            }
+            memcpy(reinterpret_cast<void*>(ptr), vm::Object::Unbox(structure), descriptor->nativeSize);
+            return;
         }
 
         // If we got this far, throw an exception
-        Il2CppException* exception;
-
-        if (type->generic_class != NULL || type->is_generic)
-        {
-            exception = vm::Exception::GetArgumentException("structure", "The specified object must not be an instance of a generic type.");
-        }
-        else
-        {
-            exception = vm::Exception::GetArgumentException("structure", "The specified structure must be blittable or have layout information.");
-        }
-
-        vm::Exception::Raise(exception);
+        RaiseNotMarshalableStructure(type, "structure");
     }
 
     template<typename T>
@@ -509,11 +498,14 @@ namespace InteropServices
             vm::Exception::Raise(vm::Exception::GetArgumentNullException("structureType"));
 
         Il2CppClass* type = vm::Class::FromIl2CppType(structureType->type);
+        const Il2CppMarshalDescriptor* descriptor = utils::MarshalingUtils::GetMarshalDescriptor(type);
 
-        // If cleanup function exists, it will call it and return true
-        // In that case, we're done.
-        if (utils::MarshalingUtils::MarshalFreeStruct(reinterpret_cast<void*>(ptr), type->interopData))
+        // If cleanup function exists, call it and we're done.
+        if (descriptor->marshalCleanupFunction != NULL)
+        {
+            descriptor->marshalCleanupFunction(reinterpret_cast<void*>(ptr));
             return;
+        }
 
         if (type->is_generic || type->generic_class != NULL)
         {
@@ -79,11 +79,11 @@ namespace Threading
             return map_native_wait_result_to_managed(status, 1);
         }
 
-        std::vector<os::Handle*> osWaitHandles((os::Handle**)handles, (os::Handle**)handles + numHandles);
+        os::Handle** osWaitHandles = (os::Handle**)handles;
 
         if (waitAll)
         {
-            if (os::Handle::WaitAll(osWaitHandles, timeouts))
+            if (os::Handle::WaitAll(osWaitHandles, numHandles, timeouts))
             {
                 return map_native_wait_result_to_managed(kWaitStatusSuccess, numHandles);
             }
@@ -93,7 +93,7 @@ namespace Threading
             }
         }
         else
-            return os::Handle::WaitAny(osWaitHandles, timeouts);
+            return os::Handle::WaitAny(osWaitHandles, numHandles, timeouts);
     }
 } /* namespace Threading */
 } /* namespace System */
@@ -0,0 +1,63 @@
+#include "il2cpp-config.h"
+#include "il2cpp-object-internals.h"
+#include "icalls/mscorlib/System/Number.h"
+#include "utils/FloatConversion.h"
+#include "utils/StringUtils.h"
+#include "vm/String.h"
+
+namespace il2cpp
+{
+namespace icalls
+{
+namespace mscorlib
+{
+namespace System
+{
+    template<typename T>
+    static Il2CppString* FormatRoundTrip(T value)
+    {
+        char buffer[utils::FloatConversion::kMaxRoundTripLength];
+        const int32_t length = utils::FloatConversion::FormatRoundTrip(value, buffer);
+
+        Il2CppString* result = vm::String::NewSize(length);
+        Il2CppChar* chars = utils::StringUtils::GetChars(result);
+        for (int32_t i = 0; i < length; ++i)
+            chars[i] = buffer[i];
+
+        return result;
+    }
+
+    // Only succeeds when all of s is the number.
+    template<typename T>
+    static bool TryParseInvariant(Il2CppString* s, T* result)
+    {
+        if (s == NULL)
+            return false;
+
+        const int32_t length = utils::StringUtils::GetLength(s);
+        return length != 0 && utils::FloatConversion::Parse(utils::StringUtils::GetChars(s), length, result) == length;
+    }
+
+    Il2CppString* Number::FormatDoubleRoundTrip(double value)
+    {
+        return FormatRoundTrip(value);
+    }
+
+    Il2CppString* Number::FormatSingleRoundTrip(float value)
+    {
+        return FormatRoundTrip(value);
+    }
+
+    bool Number::TryParseDoubleInvariant(Il2CppString* s, double* result)
+    {
+        return TryParseInvariant(s, result);
+    }
+
+    bool Number::TryParseSingleInvariant(Il2CppString* s, float* result)
+    {
+        return TryParseInvariant(s, result);
+    }
+} /* namespace System */
+} /* namespace mscorlib */
+} /* namespace icalls */
+} /* namespace il2cpp */
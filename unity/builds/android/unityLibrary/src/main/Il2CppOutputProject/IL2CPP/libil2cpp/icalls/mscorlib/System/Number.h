@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+#include "il2cpp-config.h"
+
+struct Il2CppString;
+
+namespace il2cpp
+{
+namespace icalls
+{
+namespace mscorlib
+{
+namespace System
+{
+    class LIBIL2CPP_CODEGEN_API Number
+    {
+    public:
+        static Il2CppString* FormatDoubleRoundTrip(double value);
+        static Il2CppString* FormatSingleRoundTrip(float value);
+        static bool TryParseDoubleInvariant(Il2CppString* s, double* result);
+        static bool TryParseSingleInvariant(Il2CppString* s, float* result);
+    };
+} /* namespace System */
+} /* namespace mscorlib */
+} /* namespace icalls */
+} /* namespace il2cpp */
@@ -798,16 +798,16 @@ namespace System
         else
             format = IL2CPP_TYPE_NAME_FORMAT_REFLECTION;
 
-        std::string name(vm::Type::GetName(_type->type.type, format));
-        if (name.empty())
-            return NULL;
-
         if (full_name && (_type->type.type->type == IL2CPP_TYPE_VAR || _type->type.type->type == IL2CPP_TYPE_MVAR))
         {
             return NULL;
         }
 
-        return il2cpp::vm::String::NewWrapper(name.c_str());
+        const char* name = vm::Type::GetCachedName(_type->type.type, format);
+        if (*name == '\0')
+            return NULL;
+
+        return il2cpp::vm::String::NewWrapper(name);
     }
 
     Il2CppReflectionType* RuntimeType::get_DeclaringType(Il2CppReflectionRuntimeType* _this)
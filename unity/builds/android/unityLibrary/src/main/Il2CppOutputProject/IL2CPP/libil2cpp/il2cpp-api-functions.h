@@ -188,6 +188,10 @@ DO_API(void, il2cpp_profiler_install_allocation, (Il2CppProfileAllocFunc callbac
 DO_API(void, il2cpp_profiler_install_gc, (Il2CppProfileGCFunc callback, Il2CppProfileGCResizeFunc heap_resize_callback));
 DO_API(void, il2cpp_profiler_install_fileio, (Il2CppProfileFileIOFunc callback));
 DO_API(void, il2cpp_profiler_install_thread, (Il2CppProfileThreadFunc start, Il2CppProfileThreadFunc end));
+DO_API(bool, il2cpp_profiler_start_capture, (const char* path, Il2CppProfileFlags events, uint32_t allocation_sample_interval));
+DO_API(void, il2cpp_profiler_stop_capture, ());
+DO_API(bool, il2cpp_profiler_start_sampling, (uint32_t interval_microseconds, bool include_line_numbers));
+DO_API(bool, il2cpp_profiler_stop_sampling, (const char* path));
 
 #endif
 
@@ -101,6 +101,18 @@ typedef enum
     //IL2CPP_STAT_MAJOR_GC_COUNT,
     //IL2CPP_STAT_MINOR_GC_TIME_USECS,
     //IL2CPP_STAT_MAJOR_GC_TIME_USECS
+    IL2CPP_STAT_METADATA_MEMORY_RESERVED_SIZE,
+    IL2CPP_STAT_METADATA_MEMORY_USED_SIZE,
+    IL2CPP_STAT_GENERIC_CLASS_MEMORY_RESERVED_SIZE,
+    IL2CPP_STAT_GENERIC_CLASS_MEMORY_USED_SIZE,
+    IL2CPP_STAT_GENERIC_METHOD_MEMORY_RESERVED_SIZE,
+    IL2CPP_STAT_GENERIC_METHOD_MEMORY_USED_SIZE,
+    IL2CPP_STAT_TYPE_INITIALIZER_COUNT,
+    IL2CPP_STAT_TYPE_INITIALIZER_TIME_USECS,
+    IL2CPP_STAT_TYPE_INITIALIZER_WAIT_TIME_USECS,
+    IL2CPP_STAT_FINALIZER_COUNT,
+    IL2CPP_STAT_FINALIZER_TIME_USECS,
+    IL2CPP_STAT_FINALIZER_QUEUE_DEPTH
 } Il2CppStat;
 
 typedef enum
@@ -473,6 +473,18 @@ bool il2cpp_stats_dump_to_file(const char *path)
     fs << "Initialized class count: " << il2cpp_stats_get_value(IL2CPP_STAT_INITIALIZED_CLASS_COUNT) << "\n";
     fs << "Generic instance count: " << il2cpp_stats_get_value(IL2CPP_STAT_GENERIC_INSTANCE_COUNT) << "\n";
     fs << "Generic class count: " << il2cpp_stats_get_value(IL2CPP_STAT_GENERIC_CLASS_COUNT) << "\n";
+    fs << "Metadata memory reserved size: " << il2cpp_stats_get_value(IL2CPP_STAT_METADATA_MEMORY_RESERVED_SIZE) << "\n";
+    fs << "Metadata memory used size: " << il2cpp_stats_get_value(IL2CPP_STAT_METADATA_MEMORY_USED_SIZE) << "\n";
+    fs << "Generic class memory reserved size: " << il2cpp_stats_get_value(IL2CPP_STAT_GENERIC_CLASS_MEMORY_RESERVED_SIZE) << "\n";
+    fs << "Generic class memory used size: " << il2cpp_stats_get_value(IL2CPP_STAT_GENERIC_CLASS_MEMORY_USED_SIZE) << "\n";
+    fs << "Generic method memory reserved size: " << il2cpp_stats_get_value(IL2CPP_STAT_GENERIC_METHOD_MEMORY_RESERVED_SIZE) << "\n";
+    fs << "Generic method memory used size: " << il2cpp_stats_get_value(IL2CPP_STAT_GENERIC_METHOD_MEMORY_USED_SIZE) << "\n";
+    fs << "Type initializer count: " << il2cpp_stats_get_value(IL2CPP_STAT_TYPE_INITIALIZER_COUNT) << "\n";
+    fs << "Type initializer time (usecs): " << il2cpp_stats_get_value(IL2CPP_STAT_TYPE_INITIALIZER_TIME_USECS) << "\n";
+    fs << "Type initializer wait time (usecs): " << il2cpp_stats_get_value(IL2CPP_STAT_TYPE_INITIALIZER_WAIT_TIME_USECS) << "\n";
+    fs << "Finalizer count: " << il2cpp_stats_get_value(IL2CPP_STAT_FINALIZER_COUNT) << "\n";
+    fs << "Finalizer time (usecs): " << il2cpp_stats_get_value(IL2CPP_STAT_FINALIZER_TIME_USECS) << "\n";
+    fs << "Finalizer queue depth: " << il2cpp_stats_get_value(IL2CPP_STAT_FINALIZER_QUEUE_DEPTH) << "\n";
 
     fs.close();
 
@@ -517,6 +529,42 @@ uint64_t il2cpp_stats_get_value(Il2CppStat stat)
         case IL2CPP_STAT_INFLATED_TYPE_COUNT:
             return il2cpp_runtime_stats.inflated_type_count;
 
+        case IL2CPP_STAT_METADATA_MEMORY_RESERVED_SIZE:
+            return il2cpp_runtime_stats.metadata_memory.reserved_size;
+
+        case IL2CPP_STAT_METADATA_MEMORY_USED_SIZE:
+            return il2cpp_runtime_stats.metadata_memory.used_size;
+
+        case IL2CPP_STAT_GENERIC_CLASS_MEMORY_RESERVED_SIZE:
+            return il2cpp_runtime_stats.generic_class_memory.reserved_size;
+
+        case IL2CPP_STAT_GENERIC_CLASS_MEMORY_USED_SIZE:
+            return il2cpp_runtime_stats.generic_class_memory.used_size;
+
+        case IL2CPP_STAT_GENERIC_METHOD_MEMORY_RESERVED_SIZE:
+            return il2cpp_runtime_stats.generic_method_memory.reserved_size;
+
+        case IL2CPP_STAT_GENERIC_METHOD_MEMORY_USED_SIZE:
+            return il2cpp_runtime_stats.generic_method_memory.used_size;
+
+        case IL2CPP_STAT_TYPE_INITIALIZER_COUNT:
+            return il2cpp_runtime_stats.type_initializer_count;
+
+        case IL2CPP_STAT_TYPE_INITIALIZER_TIME_USECS:
+            return il2cpp_runtime_stats.type_initializer_time_usecs;
+
+        case IL2CPP_STAT_TYPE_INITIALIZER_WAIT_TIME_USECS:
+            return il2cpp_runtime_stats.type_initializer_wait_time_usecs;
+
+        case IL2CPP_STAT_FINALIZER_COUNT:
+            return il2cpp_runtime_stats.finalizer_count;
+
+        case IL2CPP_STAT_FINALIZER_TIME_USECS:
+            return il2cpp_runtime_stats.finalizer_time_usecs;
+
+        case IL2CPP_STAT_FINALIZER_QUEUE_DEPTH:
+            return il2cpp_runtime_stats.finalizer_queue_depth;
+
             /*case IL2CPP_STAT_DELEGATE_CREATIONS:
                 return il2cpp_runtime_stats.delegate_creations;
 
@@ -1008,6 +1056,26 @@ void il2cpp_profiler_install_thread(Il2CppProfileThreadFunc start, Il2CppProfile
     Profiler::InstallThread(start, end);
 }
 
+bool il2cpp_profiler_start_capture(const char* path, Il2CppProfileFlags events, uint32_t allocation_sample_interval)
+{
+    return Profiler::StartCapture(path, events, allocation_sample_interval);
+}
+
+void il2cpp_profiler_stop_capture()
+{
+    Profiler::StopCapture();
+}
+
+bool il2cpp_profiler_start_sampling(uint32_t interval_microseconds, bool include_line_numbers)
+{
+    return Profiler::StartSampling(interval_microseconds, include_line_numbers);
+}
+
+bool il2cpp_profiler_stop_sampling(const char* path)
+{
+    return Profiler::StopSampling(path);
+}
+
 #endif
 
 // property
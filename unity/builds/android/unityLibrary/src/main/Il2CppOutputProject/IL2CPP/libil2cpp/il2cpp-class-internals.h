@@ -23,6 +23,7 @@ typedef struct Il2CppAppDomainSetup Il2CppAppDomainSetup;
 typedef struct Il2CppDelegate Il2CppDelegate;
 typedef struct Il2CppAppContext Il2CppAppContext;
 typedef struct Il2CppNameToTypeHandleHashTable Il2CppNameToTypeHandleHashTable;
+typedef struct Il2CppMethodNameIndex Il2CppMethodNameIndex;
 typedef struct Il2CppCodeGenModule Il2CppCodeGenModule;
 typedef struct Il2CppMetadataRegistration Il2CppMetadataRegistration;
 typedef struct Il2CppCodeRegistration Il2CppCodeRegistration;
@@ -403,6 +404,13 @@ typedef struct Il2CppClass
 
     void *unity_user_data;
 
+    const Il2CppMarshalDescriptor* marshalDescriptor; // Created on first use by MarshalingUtils::GetMarshalDescriptor
+    const Il2CppMethodNameIndex* methodNameIndex; // Created on first use by Class::GetMethodFromNameFlagsAndSig
+
+    // Published by ArrayMetadata::GetBoundedArrayClass so array classes can be found without the array class maps
+    Il2CppClass* szArrayClass; // the single dimensional, zero based array of this class
+    Il2CppClass* mdArrayClass; // the last multi-dimensional or bounded array of this class that was asked for
+
     uint32_t initializationExceptionGCHandle;
 
     uint32_t cctor_started;
@@ -130,6 +130,9 @@ typedef void (STDCALL *CultureInfoChangedCallback)(const Il2CppChar* arg);
 /* Platform support to cleanup attached threads even when native threads are not exited cleanly */
 #define IL2CPP_HAS_NATIVE_THREAD_CLEANUP (IL2CPP_THREADS_PTHREAD || IL2CPP_THREADS_WIN32 || IL2CPP_TARGET_SWITCH)
 
+/* Events, mutexes and semaphores are os/Generic WaitObjects, which wake multi-handle waits when they get signaled */
+#define IL2CPP_HAS_WAIT_OBJECTS ((IL2CPP_THREADS_PTHREAD || IL2CPP_THREADS_WIN32) && !RUNTIME_TINY)
+
 #define IL2CPP_THREAD_IMPL_HAS_COM_APARTMENTS IL2CPP_TARGET_WINDOWS
 
 #if !defined(IL2CPP_ENABLE_PLATFORM_THREAD_STACKSIZE) && IL2CPP_TARGET_IOS
@@ -388,6 +391,35 @@ static const uint16_t kInvalidIl2CppMethodSlot = 65535;
 #define IL2CPP_SIZEOF_STRUCT_WITH_NO_INSTANCE_FIELDS 1
 #define IL2CPP_VALIDATE_FIELD_LAYOUT 0
 
+// Logs how long each type initializer takes to run
+#ifndef IL2CPP_TRACE_TYPE_INITIALIZERS
+#define IL2CPP_TRACE_TYPE_INITIALIZERS 0
+#endif
+
+// Looks methods up by name through a per-class hash index, built the first time a class with many methods
+// (counting inherited ones) is searched. The indexes are never freed.
+#ifndef IL2CPP_ENABLE_METHOD_NAME_INDEX
+#define IL2CPP_ENABLE_METHOD_NAME_INDEX 0
+#endif
+
+// Creates the MethodInfo of a method defined in metadata the first time it is asked for, rather than those of all
+// the methods of a class at once. klass->methods entries of such classes may be NULL, use Class::GetMethodAt.
+#ifndef IL2CPP_ENABLE_LAZY_METHOD_INFOS
+#define IL2CPP_ENABLE_LAZY_METHOD_INFOS 0
+#endif
+
+// Number of threads that run finalizers. Above 1, the GC Finalizer thread hands the objects it collects out in
+// batches to IL2CPP_FINALIZER_THREAD_COUNT - 1 worker threads and runs batches itself too.
+#ifndef IL2CPP_FINALIZER_THREAD_COUNT
+#define IL2CPP_FINALIZER_THREAD_COUNT 1
+#endif
+
+// Keeps string literals out of the GC heap. They are used in place from global-metadata-literals.dat when the build
+// has one, otherwise transcoded once into metadata memory. Either way the GC neither allocates nor scans them.
+#ifndef IL2CPP_ENABLE_FROZEN_STRING_LITERALS
+#define IL2CPP_ENABLE_FROZEN_STRING_LITERALS 0
+#endif
+
 #if IL2CPP_MONO_DEBUGGER
 #define STORE_SEQ_POINT(storage, seqPoint) (storage).currentSequencePoint = seqPoint;
 #define STORE_TRY_ID(storage, id) (storage).tryId = id;
@@ -36,6 +36,18 @@ typedef struct Il2CppInteropData
     const Il2CppType* type;
 } Il2CppInteropData;
 
+// What Marshal.PtrToStructure and friends need to know about a type, see MarshalingUtils::GetMarshalDescriptor
+typedef struct Il2CppMarshalDescriptor
+{
+    PInvokeMarshalToNativeFunc marshalToNativeFunction;
+    PInvokeMarshalFromNativeFunc marshalFromNativeFunction;
+    PInvokeMarshalCleanupFunc marshalCleanupFunction;
+    Il2CppMethodPointer defaultConstructor; // formatted classes only
+    int32_t nativeSize;
+    uint8_t isBlittable : 1; // no marshal functions, the nativeSize bytes are copied as they are
+    uint8_t hasDefaultConstructor : 1;
+} Il2CppMarshalDescriptor;
+
 #if defined(__cplusplus)
 
 #include "utils/StringView.h"
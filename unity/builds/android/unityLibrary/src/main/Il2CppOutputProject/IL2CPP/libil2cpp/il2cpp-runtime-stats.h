@@ -3,6 +3,14 @@
 #include <atomic>
 #include <stdint.h>
 
+struct Il2CppMemoryPoolStats
+{
+    // Bytes obtained from the system allocator.
+    std::atomic<uint64_t> reserved_size;
+    // Bytes handed out. Allocations from a chunk a thread is still using are counted once it moves on.
+    std::atomic<uint64_t> used_size;
+};
+
 struct Il2CppRuntimeStats
 {
     std::atomic<uint64_t> new_object_count;
@@ -16,6 +24,19 @@ struct Il2CppRuntimeStats
     std::atomic<uint64_t> generic_class_count;
     std::atomic<uint64_t> inflated_method_count;
     std::atomic<uint64_t> inflated_type_count;
+    std::atomic<uint64_t> type_initializer_count;
+    // Inclusive of nested type initializers.
+    std::atomic<uint64_t> type_initializer_time_usecs;
+    // Time threads spent blocked on type initializers running on other threads.
+    std::atomic<uint64_t> type_initializer_wait_time_usecs;
+    std::atomic<uint64_t> finalizer_count;
+    // Time the finalizer threads spent running finalizers, finalizer_count divided by it is the throughput.
+    std::atomic<uint64_t> finalizer_time_usecs;
+    // Objects handed to the finalizer threads whose finalizer has not run yet.
+    std::atomic<uint64_t> finalizer_queue_depth;
+    Il2CppMemoryPoolStats metadata_memory;
+    Il2CppMemoryPoolStats generic_class_memory;
+    Il2CppMemoryPoolStats generic_method_memory;
     // uint64_t delegate_creations;
     // uint64_t minor_gc_count;
     // uint64_t major_gc_count;
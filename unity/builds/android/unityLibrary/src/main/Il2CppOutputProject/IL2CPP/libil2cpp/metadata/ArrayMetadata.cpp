@@ -101,7 +101,7 @@ namespace metadata
     static GenericArrayMethods s_GenericArrayMethods;
 
     static size_t GetArrayGenericMethodsCount();
-    static void PopulateArrayGenericMethods(Il2CppClass* klass, uint16_t offset);
+    static void PopulateArrayGenericMethods(Il2CppClass* klass, const MethodInfo** methods, uint16_t offset);
 
     static void CollectImplicitArrayInterfaces(Il2CppClass* elementClass, ::std::vector<Il2CppClass*>& interfaces);
 
@@ -115,39 +115,41 @@ namespace metadata
         size_t methodCount = 3 + (rank > 1 ? 2 : 1) + interfaces.size() * GetArrayGenericMethodsCount();
         IL2CPP_ASSERT(methodCount <= std::numeric_limits<uint16_t>::max());
         arrayClass->method_count = static_cast<uint16_t>(methodCount);
-        arrayClass->methods = (const MethodInfo**)MetadataCalloc(methodCount, sizeof(MethodInfo*));
+        const MethodInfo** methods = (const MethodInfo**)MetadataCalloc(methodCount, sizeof(MethodInfo*));
 
         const Il2CppType** parameters = (const Il2CppType**)alloca(rank * sizeof(Il2CppType*));
         for (uint8_t i = 0; i < rank; i++)
             parameters[i] = &il2cpp_defaults.int32_class->byval_arg;
-        arrayClass->methods[methodIndex++] = ConstructArrayMethod(arrayClass, ".ctor", &il2cpp_defaults.void_class->byval_arg, rank, parameters);
+        methods[methodIndex++] = ConstructArrayMethod(arrayClass, ".ctor", &il2cpp_defaults.void_class->byval_arg, rank, parameters);
 
         if (rank > 1)
         {
             parameters = (const Il2CppType**)alloca(2 * rank * sizeof(Il2CppType*));
             for (uint8_t i = 0; i < 2 * rank; i++)
                 parameters[i] = &il2cpp_defaults.int32_class->byval_arg;
-            arrayClass->methods[methodIndex++] = ConstructArrayMethod(arrayClass, ".ctor", &il2cpp_defaults.void_class->byval_arg, 2 * rank, parameters);
+            methods[methodIndex++] = ConstructArrayMethod(arrayClass, ".ctor", &il2cpp_defaults.void_class->byval_arg, 2 * rank, parameters);
         }
 
         parameters = (const Il2CppType**)alloca((rank + 1) * sizeof(Il2CppType*));
         for (uint8_t i = 0; i < rank; i++)
             parameters[i] = &il2cpp_defaults.int32_class->byval_arg;
         parameters[rank] = &arrayClass->element_class->byval_arg;
-        arrayClass->methods[methodIndex++] = ConstructArrayMethod(arrayClass, "Set", &il2cpp_defaults.void_class->byval_arg, rank + 1, parameters);
+        methods[methodIndex++] = ConstructArrayMethod(arrayClass, "Set", &il2cpp_defaults.void_class->byval_arg, rank + 1, parameters);
 
         parameters = (const Il2CppType**)alloca(rank * sizeof(Il2CppType*));
         for (uint8_t i = 0; i < rank; i++)
             parameters[i] = &il2cpp_defaults.int32_class->byval_arg;
-        arrayClass->methods[methodIndex++] = ConstructArrayMethod(arrayClass, "Address", &arrayClass->element_class->this_arg, rank, parameters);
+        methods[methodIndex++] = ConstructArrayMethod(arrayClass, "Address", &arrayClass->element_class->this_arg, rank, parameters);
 
         parameters = (const Il2CppType**)alloca(rank * sizeof(Il2CppType*));
         for (uint8_t i = 0; i < rank; i++)
             parameters[i] = &il2cpp_defaults.int32_class->byval_arg;
-        arrayClass->methods[methodIndex++] = ConstructArrayMethod(arrayClass, "Get", &arrayClass->element_class->byval_arg, rank, parameters);
+        methods[methodIndex++] = ConstructArrayMethod(arrayClass, "Get", &arrayClass->element_class->byval_arg, rank, parameters);
 
         IL2CPP_ASSERT(methodIndex <= std::numeric_limits<uint16_t>::max());
-        PopulateArrayGenericMethods(arrayClass, static_cast<uint16_t>(methodIndex));
+        PopulateArrayGenericMethods(arrayClass, methods, static_cast<uint16_t>(methodIndex));
+
+        PublishMetadata(arrayClass->methods, methods);
     }
 
     static void CollectImplicitArrayInterfacesFromElementClass(Il2CppClass* elementClass, ::std::vector<Il2CppClass*>& interfaces)
@@ -247,7 +249,7 @@ namespace metadata
             const MethodInfo* matchingInterfacesMethod = NULL;
             for (int methodIndex = 0; methodIndex < implementingInterface->method_count; methodIndex++)
             {
-                const MethodInfo* interfaceMethod = implementingInterface->methods[methodIndex];
+                const MethodInfo* interfaceMethod = Class::GetMethodAt(implementingInterface, static_cast<uint16_t>(methodIndex));
                 if (methodName == interfaceMethod->name)
                     matchingInterfacesMethod = interfaceMethod;
             }
@@ -292,7 +294,7 @@ namespace metadata
         return inflatedMethod;
     }
 
-    static void PopulateArrayGenericMethods(Il2CppClass* klass, uint16_t offset)
+    static void PopulateArrayGenericMethods(Il2CppClass* klass, const MethodInfo** methods, uint16_t offset)
     {
         for (int i = 0; i < klass->interface_offsets_count; i++)
         {
@@ -311,7 +313,7 @@ namespace metadata
                     continue;
 
                 MethodInfo* arrayMethod = ConstructGenericArrayMethod(*iter, klass, &context);
-                klass->methods[offset++] = arrayMethod;
+                methods[offset++] = arrayMethod;
 
                 size_t vtableIndex = klass->interfaceOffsets[i].offset + iter->interfaceMethodDefinition->slot;
                 klass->vtable[vtableIndex].method = arrayMethod;
@@ -392,17 +394,19 @@ namespace metadata
             const Il2CppType* genericArguments = &klass->element_class->byval_arg;
 
             IL2CPP_ASSERT(klass->interfaces_count == kImplicitArrayInterfaceCount);
-            klass->implementedInterfaces = (Il2CppClass**)MetadataMalloc(klass->interfaces_count * sizeof(Il2CppClass*));
-            klass->implementedInterfaces[0] = Class::GetInflatedGenericInstanceClass(il2cpp_defaults.generic_ilist_class, &genericArguments, 1);
-            IL2CPP_ASSERT(klass->implementedInterfaces[0]);
-            klass->implementedInterfaces[1] = Class::GetInflatedGenericInstanceClass(il2cpp_defaults.generic_icollection_class, &genericArguments, 1);
-            IL2CPP_ASSERT(klass->implementedInterfaces[1]);
-            klass->implementedInterfaces[2] = Class::GetInflatedGenericInstanceClass(il2cpp_defaults.generic_ienumerable_class, &genericArguments, 1);
-            IL2CPP_ASSERT(klass->implementedInterfaces[2]);
-            klass->implementedInterfaces[3] = Class::GetInflatedGenericInstanceClass(il2cpp_defaults.generic_ireadonlylist_class, &genericArguments, 1);
-            IL2CPP_ASSERT(klass->implementedInterfaces[3]);
-            klass->implementedInterfaces[4] = Class::GetInflatedGenericInstanceClass(il2cpp_defaults.generic_ireadonlycollection_class, &genericArguments, 1);
-            IL2CPP_ASSERT(klass->implementedInterfaces[4]);
+            Il2CppClass** interfaces = (Il2CppClass**)MetadataMalloc(klass->interfaces_count * sizeof(Il2CppClass*));
+            interfaces[0] = Class::GetInflatedGenericInstanceClass(il2cpp_defaults.generic_ilist_class, &genericArguments, 1);
+            IL2CPP_ASSERT(interfaces[0]);
+            interfaces[1] = Class::GetInflatedGenericInstanceClass(il2cpp_defaults.generic_icollection_class, &genericArguments, 1);
+            IL2CPP_ASSERT(interfaces[1]);
+            interfaces[2] = Class::GetInflatedGenericInstanceClass(il2cpp_defaults.generic_ienumerable_class, &genericArguments, 1);
+            IL2CPP_ASSERT(interfaces[2]);
+            interfaces[3] = Class::GetInflatedGenericInstanceClass(il2cpp_defaults.generic_ireadonlylist_class, &genericArguments, 1);
+            IL2CPP_ASSERT(interfaces[3]);
+            interfaces[4] = Class::GetInflatedGenericInstanceClass(il2cpp_defaults.generic_ireadonlycollection_class, &genericArguments, 1);
+            IL2CPP_ASSERT(interfaces[4]);
+
+            PublishMetadata(klass->implementedInterfaces, interfaces);
         }
     }
 
@@ -482,6 +486,29 @@ namespace metadata
         return NULL;
     }
 
+    static Il2CppClass* GetArrayClassFromElementClass(Il2CppClass* elementClass, uint32_t rank, bool bounded)
+    {
+        if (rank > 1 || bounded)
+        {
+            Il2CppClass* arrayClass = LoadPublishedMetadata(elementClass->mdArrayClass);
+            return arrayClass != NULL && arrayClass->rank == rank ? arrayClass : NULL;
+        }
+
+        return LoadPublishedMetadata(elementClass->szArrayClass);
+    }
+
+    static Il2CppClass* CacheArrayClassOnElementClass(Il2CppClass* elementClass, Il2CppClass* arrayClass, uint32_t rank, bool bounded)
+    {
+        // Racing threads can only ever store the same class for the single dimensional array. The multi-dimensional
+        // slot just keeps whichever rank was stored last.
+        if (rank > 1 || bounded)
+            PublishMetadata(elementClass->mdArrayClass, arrayClass);
+        else
+            PublishMetadata(elementClass->szArrayClass, arrayClass);
+
+        return arrayClass;
+    }
+
     Il2CppClass* ArrayMetadata::GetBoundedArrayClass(Il2CppClass* elementClass, uint32_t rank, bool bounded)
     {
         IL2CPP_ASSERT(rank <= 255);
@@ -489,17 +516,21 @@ namespace metadata
         if (rank > 1)
             bounded = false;
 
-        // Check for a cached array class using the reader lock only
-        Il2CppClass* cachedArrayClass = FindBoundedArrayClass(elementClass, rank, bounded);
+        Il2CppClass* cachedArrayClass = GetArrayClassFromElementClass(elementClass, rank, bounded);
         if (cachedArrayClass != NULL)
             return cachedArrayClass;
 
+        // Check for a cached array class using the reader lock only
+        cachedArrayClass = FindBoundedArrayClass(elementClass, rank, bounded);
+        if (cachedArrayClass != NULL)
+            return CacheArrayClassOnElementClass(elementClass, cachedArrayClass, rank, bounded);
+
         FastAutoLock lock(&il2cpp::vm::g_MetadataLock);
 
         // Check if the array class was created while we were waiting for the g_MetadataLock
         cachedArrayClass = FindBoundedArrayClass(elementClass, rank, bounded);
         if (cachedArrayClass != NULL)
-            return cachedArrayClass;
+            return CacheArrayClassOnElementClass(elementClass, cachedArrayClass, rank, bounded);
 
         Il2CppClass* arrayClass = il2cpp_defaults.array_class;
         Class::Init(arrayClass);
@@ -582,7 +613,7 @@ namespace metadata
         else
             s_SZArrayClassMap.Add(klass->element_class, klass);
 
-        return klass;
+        return CacheArrayClassOnElementClass(elementClass, klass, rank, bounded);
     }
 
     void ArrayMetadata::WalkSZArrays(ArrayTypeWalkCallback callback, void* context)
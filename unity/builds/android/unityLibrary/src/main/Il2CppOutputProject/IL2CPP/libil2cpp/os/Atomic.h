@@ -78,6 +78,18 @@ namespace os
             return (T*)Baselib_atomic_load_ptr_relaxed((const intptr_t*)addr);
         }
 
+        template<typename T>
+        static inline T* LoadPointerAcquire(const T* const * addr)
+        {
+            return (T*)Baselib_atomic_load_ptr_acquire((const intptr_t*)addr);
+        }
+
+        template<typename T>
+        static inline void StorePointerRelease(T** addr, T* value)
+        {
+            Baselib_atomic_store_ptr_release((intptr_t*)addr, (intptr_t)value);
+        }
+
         template<typename T>
         static inline T* ReadPointer(T** pointer)
         {
@@ -5,6 +5,7 @@
 
 #include "os/ClassLibraryPAL/pal_mirror_structs.h"
 #include "os/File.h"
+#include "os/FileSystemWatcher.h"
 #include "os/Posix/FileHandle.h"
 
 #include <stdlib.h>
@@ -12,6 +13,10 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#if IL2CPP_HAVE_INOTIFY
+#include <sys/inotify.h>
+#endif
+
 #if IL2CPP_HAVE_FCOPYFILE
 #include <copyfile.h>
 #endif
@@ -48,6 +53,12 @@ extern "C"
     IL2CPP_EXPORT int32_t SystemNative_CopyFile(intptr_t sourceFd, intptr_t destinationFd); // 1251
     IL2CPP_EXPORT int32_t SystemNative_LChflags(const char* path, uint32_t flags);
     IL2CPP_EXPORT int32_t SystemNative_LChflagsCanSetHiddenFlag(); // 1482
+
+    // Items needed by System for the inotify file system watcher
+    IL2CPP_EXPORT intptr_t SystemNative_INotifyInit(void);
+    IL2CPP_EXPORT int32_t SystemNative_INotifyAddWatch(intptr_t fd, const char* pathName, uint32_t mask);
+    IL2CPP_EXPORT int32_t SystemNative_INotifyRemoveWatch(intptr_t fd, int32_t wd);
+    IL2CPP_EXPORT int32_t SystemNative_Read(intptr_t fd, void* buffer, int32_t bufferSize);
 }
 
 
@@ -708,4 +719,63 @@ int32_t SystemNative_LChflagsCanSetHiddenFlag(void)
 #endif
 }
 
+static int ToFileDescriptor(intptr_t fd)
+{
+    return il2cpp::os::File::IsHandleOpenFileHandle(fd) ? reinterpret_cast<il2cpp::os::FileHandle*>(fd)->fd : static_cast<int>(fd);
+}
+
+// The instance goes back to managed code as the handle of a SafeFileHandle, which closes it through MonoIO.
+intptr_t SystemNative_INotifyInit(void)
+{
+#if IL2CPP_HAVE_INOTIFY
+    const int fd = inotify_init1(IN_CLOEXEC);
+    if (fd == -1)
+        return -1;
+
+    il2cpp::os::FileHandle* handle = il2cpp::os::File::CreateHandleForDescriptor(fd, kFileTypeUnknown, kFileAccessRead);
+    handle->isNotifyInstance = true;
+    return reinterpret_cast<intptr_t>(handle);
+#else
+    errno = ENOTSUP;
+    return -1;
+#endif
+}
+
+int32_t SystemNative_INotifyAddWatch(intptr_t fd, const char* pathName, uint32_t mask)
+{
+#if IL2CPP_HAVE_INOTIFY
+    return inotify_add_watch(ToFileDescriptor(fd), REMAP_PATH(pathName), mask);
+#else
+    errno = ENOTSUP;
+    return -1;
+#endif
+}
+
+int32_t SystemNative_INotifyRemoveWatch(intptr_t fd, int32_t wd)
+{
+#if IL2CPP_HAVE_INOTIFY
+    return inotify_rm_watch(ToFileDescriptor(fd), wd);
+#else
+    errno = ENOTSUP;
+    return -1;
+#endif
+}
+
+int32_t SystemNative_Read(intptr_t fd, void* buffer, int32_t bufferSize)
+{
+    const il2cpp::os::FileHandle* handle = il2cpp::os::File::IsHandleOpenFileHandle(fd) ? reinterpret_cast<il2cpp::os::FileHandle*>(fd) : NULL;
+    const int inFd = handle != NULL ? handle->fd : static_cast<int>(fd);
+
+    int32_t count;
+    while ((count = (int32_t)read(inFd, buffer, (size_t)bufferSize)) < 0 && errno == EINTR)
+        ;
+
+    // The watcher raises one event per notification, bursts of writes to a file only need the first. The first
+    // record of a read is always kept, a read of 0 bytes would stop the watcher.
+    if (handle != NULL && handle->isNotifyInstance && count > 0)
+        count = il2cpp::os::FileSystemWatcher::CoalesceEvents(static_cast<uint8_t*>(buffer), count);
+
+    return count;
+}
+
 #endif
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace il2cpp
+{
+namespace os
+{
+    struct CpuSample
+    {
+        uint64_t threadId;
+        uint32_t frameCount;
+        // Innermost first. All but the first one are return addresses.
+        void* frames[64];
+    };
+
+    // Statistical CPU sampler driven by a process wide CPU time timer. Only the threads that registered
+    // themselves are sampled, and their stacks are captured by walking frame pointers from the signal
+    // handler, so they are only complete for code compiled with frame pointers.
+    class CpuSampler
+    {
+    public:
+        static const uint32_t kMaxFrames = sizeof(((CpuSample*)0)->frames) / sizeof(void*);
+
+        static bool IsSupported();
+
+        static bool Start(uint32_t intervalMicroseconds, int* error);
+        static void Stop();
+
+        // Must only be called from one thread at a time. Returns false when there is nothing to read.
+        static bool ReadSample(CpuSample* sample);
+
+        // Samples lost because the reader did not keep up or too many threads are registered.
+        static uint32_t GetDroppedSampleCount();
+
+        // Threads that ran while the sampler was on but were never sampled, because they could not register
+        // when they started, in practice because all the slots were taken.
+        static uint32_t GetUnsampledThreadCount();
+
+        static void RegisterCurrentThread();
+        static void UnregisterCurrentThread();
+    };
+}
+}
@@ -48,6 +48,15 @@ namespace os
     {
         return m_Event->GetOSHandle();
     }
+
+    WaitObject* Event::GetWaitObject()
+    {
+#if IL2CPP_HAS_WAIT_OBJECTS
+        return m_Event;
+#else
+        return NULL;
+#endif
+    }
 }
 }
 
@@ -89,6 +98,11 @@ namespace os
     {
         return NULL;
     }
+
+    WaitObject* Event::GetWaitObject()
+    {
+        return NULL;
+    }
 }
 }
 
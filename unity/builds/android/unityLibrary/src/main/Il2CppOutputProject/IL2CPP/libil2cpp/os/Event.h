@@ -22,6 +22,7 @@ namespace os
         WaitStatus Wait(bool interruptible = false);
         WaitStatus Wait(uint32_t ms, bool interruptible = false);
         void* GetOSHandle();
+        WaitObject* GetWaitObject();
 
     private:
         EventImpl* m_Event;
@@ -40,6 +41,7 @@ namespace os
         virtual WaitStatus Wait(uint32_t ms, bool interruptible) { return m_Event->Wait(ms, interruptible); }
         virtual void Signal() { m_Event->Set(); }
         virtual void* GetOSHandle() { return m_Event->GetOSHandle(); }
+        virtual WaitObject* GetWaitObject() { return m_Event->GetWaitObject(); }
         Event& Get() { return *m_Event; }
 
     private:
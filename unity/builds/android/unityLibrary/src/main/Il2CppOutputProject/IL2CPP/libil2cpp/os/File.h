@@ -33,6 +33,13 @@ namespace os
         int64_t last_write_time;
     };
 
+    // One buffer of a scatter read or gather write.
+    struct FileIOBuffer
+    {
+        char* buffer;
+        int32_t count;
+    };
+
     class LIBIL2CPP_CODEGEN_API File
     {
     public:
@@ -60,6 +67,13 @@ namespace os
         static int64_t Seek(FileHandle* handle, int64_t offset, int origin, int *error);
         static int Read(FileHandle* handle, char *dest, int count, int *error);
         static int32_t Write(FileHandle* handle, const char* buffer, int count, int *error);
+        // The *At, ReadScatter and WriteGather variants take the file position to start at and leave the
+        // handle's own position alone where the platform allows it, so they can be used from several threads at once.
+        static int ReadAt(FileHandle* handle, char *dest, int count, int64_t position, int *error);
+        static int32_t WriteAt(FileHandle* handle, const char* buffer, int count, int64_t position, int *error);
+        static int64_t ReadScatter(FileHandle* handle, const FileIOBuffer* buffers, int32_t bufferCount, int64_t position, int *error);
+        static int64_t WriteGather(FileHandle* handle, const FileIOBuffer* buffers, int32_t bufferCount, int64_t position, int *error);
+        static bool Advise(FileHandle* handle, int64_t position, int64_t length, FileAdvice advice, int *error);
         static bool Flush(FileHandle* handle, int* error);
         static void Lock(FileHandle* handle,  int64_t position, int64_t length, int* error);
         static void Unlock(FileHandle* handle,  int64_t position, int64_t length, int* error);
@@ -71,6 +85,10 @@ namespace os
             FileHandle** target_handle, int access, int inherit, int options, int* error);
 
         static bool IsHandleOpenFileHandle(intptr_t lookup);
+
+        // Wraps a descriptor opened outside of File, such as an inotify instance, in a handle that
+        // IsHandleOpenFileHandle finds and Close closes.
+        static FileHandle* CreateHandleForDescriptor(int fd, FileType type, int accessMode);
     };
 }
 }
@@ -1,12 +1,20 @@
 #pragma once
 
+#include <stdint.h>
+
 namespace il2cpp
 {
 namespace os
 {
 namespace FileSystemWatcher
 {
+    // Watcher mode reported to System.IO.FileSystemWatcher. Where inotify works this is 6, as with the Mono runtime,
+    // which makes the class libraries run their inotify watcher over the System.Native INotify entry points.
     int IsSupported();
+
+    // Takes a buffer of inotify_event records read from an inotify instance and drops, in place, the modify and
+    // attrib notifications that repeat the last one reported for the same entry. Returns the length left.
+    int32_t CoalesceEvents(uint8_t* events, int32_t length);
 }
 }
 }
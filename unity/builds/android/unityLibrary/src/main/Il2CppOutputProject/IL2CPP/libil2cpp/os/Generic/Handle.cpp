@@ -4,56 +4,105 @@
 
 #if IL2CPP_SUPPORT_THREADS
 
-#include <algorithm>
+#include <limits.h>
 #include "os/Thread.h"
+#include "os/Time.h"
+
+#if IL2CPP_HAS_WAIT_OBJECTS
+#include "os/Generic/WaitObject.h"
+#endif
 
 namespace il2cpp
 {
 namespace os
 {
-    int32_t Handle::WaitAny(const std::vector<Handle*>& handles, int32_t ms)
+    static int32_t GetRemainingWaitTime(int32_t ms, int64_t waitStartTime)
+    {
+        if (ms == -1)
+            return -1;
+
+        const int64_t waitedMs = (Time::GetTicks100NanosecondsMonotonic() - waitStartTime) / 10000;
+        return waitedMs >= ms ? 0 : ms - static_cast<int32_t>(waitedMs);
+    }
+
+    void Handle::WaitForSignal(Handle* const* handles, int32_t count, uint64_t acquiredHandles, int32_t ms)
+    {
+#if IL2CPP_HAS_WAIT_OBJECTS
+        WaitObject* waitObjects[kMaximumWaitHandles];
+        uint32_t waitObjectCount = 0;
+
+        int32_t i = 0;
+        for (; i < count; ++i)
+        {
+            if (acquiredHandles & (static_cast<uint64_t>(1) << i))
+                continue;
+
+            WaitObject* waitObject = handles[i]->GetWaitObject();
+            if (waitObject == NULL)
+                break;
+
+            waitObjects[waitObjectCount++] = waitObject;
+        }
+
+        if (i == count)
+        {
+            WaitObject::WaitForAnySignaled(waitObjects, waitObjectCount, ms == -1 ? UINT_MAX : static_cast<uint32_t>(ms), true);
+            return;
+        }
+#endif
+
+        // Some of the handles cannot tell us when they get signaled, so we have to poll them.
+        os::Thread::Sleep(ms == -1 || ms > m_waitIntervalMs ? m_waitIntervalMs : ms, true);
+    }
+
+    int32_t Handle::WaitAny(Handle* const* handles, int32_t count, int32_t ms)
     {
-        int timeWaitedMs = 0;
-        while (ms == -1 || timeWaitedMs <= ms)
+        IL2CPP_ASSERT(count <= kMaximumWaitHandles);
+
+        const int64_t waitStartTime = Time::GetTicks100NanosecondsMonotonic();
+        for (;;)
         {
-            int32_t numberOfOsHandles = (int32_t)handles.size();
-            for (int32_t i = 0; i < numberOfOsHandles; ++i)
+            for (int32_t i = 0; i < count; ++i)
             {
                 if (handles[i]->Wait(0U))
                     return i;
             }
 
-            os::Thread::Sleep(m_waitIntervalMs, true);
-            timeWaitedMs += m_waitIntervalMs;
-        }
+            const int32_t remainingWaitTime = GetRemainingWaitTime(ms, waitStartTime);
+            if (remainingWaitTime == 0)
+                return 258; // WAIT_TIMEOUT value
 
-        return 258; // WAIT_TIMEOUT value
+            WaitForSignal(handles, count, 0, remainingWaitTime);
+        }
     }
 
-    bool Handle::WaitAll(std::vector<Handle*>& handles, int32_t ms)
+    bool Handle::WaitAll(Handle* const* handles, int32_t count, int32_t ms)
     {
-        int timeWaitedMs = 0;
-        while (ms == -1 || timeWaitedMs <= ms)
+        IL2CPP_ASSERT(count <= kMaximumWaitHandles);
+
+        // Handles are acquired as they get signaled, and stay acquired until all of them are.
+        const uint64_t allHandles = count == 64 ? ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << count) - 1;
+        uint64_t acquiredHandles = 0;
+
+        const int64_t waitStartTime = Time::GetTicks100NanosecondsMonotonic();
+        for (;;)
         {
-            size_t numberOfOsHandles = handles.size();
-            std::vector<Handle*> signaledHandles;
-            for (size_t i = 0; i < numberOfOsHandles; ++i)
+            for (int32_t i = 0; i < count; ++i)
             {
-                if (handles[i]->Wait(0U))
-                    signaledHandles.push_back(handles[i]);
+                const uint64_t handleBit = static_cast<uint64_t>(1) << i;
+                if (!(acquiredHandles & handleBit) && handles[i]->Wait(0U))
+                    acquiredHandles |= handleBit;
             }
 
-            if (signaledHandles.size() == numberOfOsHandles)
+            if (acquiredHandles == allHandles)
                 return true; // All handles have been signaled
 
-            for (size_t i = 0; i < signaledHandles.size(); ++i)
-                handles.erase(std::remove(handles.begin(), handles.end(), signaledHandles[i]), handles.end());
+            const int32_t remainingWaitTime = GetRemainingWaitTime(ms, waitStartTime);
+            if (remainingWaitTime == 0)
+                return false; // Timed out waiting for all handles to be signaled
 
-            os::Thread::Sleep(m_waitIntervalMs, true);
-            timeWaitedMs += m_waitIntervalMs;
+            WaitForSignal(handles, count, acquiredHandles, remainingWaitTime);
         }
-
-        return false; // Timed out waiting for all handles to be signaled
     }
 } // namespace os
 } // naemspace il2cpp
@@ -64,13 +113,13 @@ namespace il2cpp
 {
 namespace os
 {
-    int32_t Handle::WaitAny(const std::vector<Handle*>& handles, int32_t ms)
+    int32_t Handle::WaitAny(Handle* const* handles, int32_t count, int32_t ms)
     {
         IL2CPP_ASSERT(0 && "Threads are not enabled for this platform.");
         return 0;
     }
 
-    bool Handle::WaitAll(std::vector<Handle*>& handles, int32_t ms)
+    bool Handle::WaitAll(Handle* const* handles, int32_t count, int32_t ms)
     {
         IL2CPP_ASSERT(0 && "Threads are not enabled for this platform.");
         return false;
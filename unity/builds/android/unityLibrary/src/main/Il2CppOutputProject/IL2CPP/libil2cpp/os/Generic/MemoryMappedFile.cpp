@@ -183,6 +183,17 @@ namespace os
             return ViewRealFile(mappedFileHandle, length, offset, access, error);
     }
 
+    MemoryMappedFile::MemoryMappedFileHandle MemoryMappedFile::View(FileHandle* mappedFileHandle, int64_t* length, int64_t offset, MemoryMappedFileAccess access, int32_t viewOptions, int64_t* actualOffset, MemoryMappedFileError* error)
+    {
+        // Views are always read into memory up front here, so there is nothing to populate.
+        return View(mappedFileHandle, length, offset, access, actualOffset, error);
+    }
+
+    bool MemoryMappedFile::Advise(void* address, int64_t length, MemoryMappedAdvice advice)
+    {
+        return true;
+    }
+
     void MemoryMappedFile::Flush(MemoryMappedFileHandle memoryMappedFileData, int64_t length)
     {
     }
@@ -196,6 +196,82 @@ namespace os
         return kWaitStatusSuccess;
     }
 
+    void WaitObject::WaitForAnySignaled(WaitObject* const* objects, uint32_t count, uint32_t timeoutMS, bool interruptible)
+    {
+        // IMPORTANT: This function must be exception-safe! APCs may throw.
+        IL2CPP_ASSERT(count > 0);
+
+        ThreadImpl* currentThread = ThreadImpl::GetCurrentThread();
+
+        if (interruptible)
+        {
+            currentThread->CheckForUserAPCAndHandle();
+
+            // Any of the objects will do, this only tells QueueUserAPC() to wake us up.
+            currentThread->SetWaitObject(objects[0]);
+
+            try
+            {
+                // Check APC queue again to avoid race condition.
+                currentThread->CheckForUserAPCAndHandle();
+            }
+            catch (...)
+            {
+                currentThread->SetWaitObject(NULL);
+                throw;
+            }
+        }
+
+        // Register as a waiter on every object, the same way ConditionWait() does for a single one. From then
+        // on, signaling any of them releases our semaphore, so nothing gets lost between this check and the wait.
+        bool signaled = false;
+        uint32_t registeredCount = 0;
+        for (; registeredCount < count; ++registeredCount)
+        {
+            WaitObject* object = objects[registeredCount];
+            ReleaseOnDestroy lock(object->m_Mutex);
+
+            if (object->m_Count != 0)
+            {
+                signaled = true;
+                break;
+            }
+
+            object->PushThreadToWaitersList(object, currentThread);
+            ++object->m_WaitingThreadCount;
+        }
+
+        if (!signaled)
+        {
+            if (timeoutMS == UINT_MAX)
+                currentThread->AcquireSemaphore();
+            else
+                currentThread->TryTimedAcquireSemaphore(timeoutMS);
+        }
+
+        for (uint32_t i = 0; i < registeredCount; ++i)
+        {
+            WaitObject* object = objects[i];
+            ReleaseOnDestroy lock(object->m_Mutex);
+
+            object->PopThreadFromWaitersList(currentThread);
+            --object->m_WaitingThreadCount;
+
+            // Semaphores and mutexes only wake up one waiter. If that was us, we may end up acquiring
+            // another object instead, so hand the wakeup over to the next thread in line.
+            if (object->m_Count != 0 && object->HaveWaitingThreads())
+                object->WakeupOneThread();
+        }
+
+        if (interruptible)
+        {
+            currentThread->SetWaitObject(NULL);
+
+            // Avoid race condition by checking APC queue again after unsetting wait object.
+            currentThread->CheckForUserAPCAndHandle();
+        }
+    }
+
     // Register this thread as a waiter to be notified
     void WaitObject::PushThreadToWaitersList(WaitObject* owner, ThreadImpl* thread)
     {
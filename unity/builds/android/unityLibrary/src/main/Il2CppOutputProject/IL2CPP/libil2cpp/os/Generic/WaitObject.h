@@ -46,6 +46,11 @@ namespace os
         static void LockWaitObjectDeletion();
         static void UnlockWaitObjectDeletion();
 
+        /// Blocks the current thread until at least one of the given objects may have been signaled, the
+        /// timeout expires (UINT_MAX waits indefinitely) or, when interruptible, an APC gets queued to it.
+        /// None of the objects are acquired; callers are expected to try and acquire them again afterwards.
+        static void WaitForAnySignaled(WaitObject* const* objects, uint32_t count, uint32_t timeoutMS, bool interruptible);
+
     protected:
 
         enum Type
@@ -9,9 +9,14 @@ namespace il2cpp
 {
 namespace os
 {
+    class WaitObject;
+
     class Handle : public il2cpp::utils::NonCopyable
     {
     public:
+        /// Same as System.Threading.WaitHandle.MaxWaitHandles.
+        static const int32_t kMaximumWaitHandles = 64;
+
         virtual ~Handle() {}
         virtual bool Wait() = 0;
         virtual bool Wait(uint32_t ms) = 0;
@@ -19,10 +24,16 @@ namespace os
         virtual WaitStatus Wait(uint32_t ms, bool interruptible) = 0;
         virtual void Signal() = 0;
 
-        static int32_t WaitAny(const std::vector<Handle*>& handles, int32_t ms);
-        static bool WaitAll(std::vector<Handle*>& handles, int32_t ms);
+        /// Object that wakes up its waiters when it gets signaled, if any. Handles without one
+        /// have to be polled by WaitAny and WaitAll.
+        virtual WaitObject* GetWaitObject() { return NULL; }
+
+        static int32_t WaitAny(Handle* const* handles, int32_t count, int32_t ms);
+        static bool WaitAll(Handle* const* handles, int32_t count, int32_t ms);
     private:
         static const int m_waitIntervalMs = 10;
+
+        static void WaitForSignal(Handle* const* handles, int32_t count, uint64_t acquiredHandles, int32_t ms);
     };
 }
 }
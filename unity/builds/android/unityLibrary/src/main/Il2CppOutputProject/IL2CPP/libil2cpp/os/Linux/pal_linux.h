@@ -19,6 +19,7 @@
 #include <limits.h>
 #define IL2CPP_HAVE_SENDFILE_4 1
 #define IL2CPP_HAVE_SYS_UN 1
+#define IL2CPP_HAVE_INOTIFY 1
 
 #define stat_ stat
 #define fstat_ fstat
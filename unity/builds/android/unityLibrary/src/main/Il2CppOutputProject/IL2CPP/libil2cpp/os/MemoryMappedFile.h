@@ -48,6 +48,24 @@ namespace os
         FILE_MODE_APPEND = 6,
     };
 
+    enum MemoryMappedViewOptions
+    {
+        kMemoryMappedViewNone = 0,
+        // Read the whole view in when it is mapped, instead of faulting it in a page at a time.
+        kMemoryMappedViewPopulate = 1 << 0,
+    };
+
+    // Access pattern hints for a range of a view, platforms without the matching hint ignore it.
+    enum MemoryMappedAdvice
+    {
+        kMemoryMappedAdviceNormal,
+        kMemoryMappedAdviceSequential,
+        kMemoryMappedAdviceRandom,
+        kMemoryMappedAdviceWillNeed,
+        kMemoryMappedAdviceDontNeed,
+        kMemoryMappedAdviceHugePage,
+    };
+
     class MemoryMappedFile
     {
     public:
@@ -55,6 +73,8 @@ namespace os
 
         static FileHandle* Create(FileHandle* file, const char* mapName, int32_t mode, int64_t *capacity, MemoryMappedFileAccess access, int32_t options, MemoryMappedFileError* error);
         static MemoryMappedFileHandle View(FileHandle* mappedFileHandle, int64_t* length, int64_t offset, MemoryMappedFileAccess access, int64_t* actualOffset, MemoryMappedFileError* error);
+        static MemoryMappedFileHandle View(FileHandle* mappedFileHandle, int64_t* length, int64_t offset, MemoryMappedFileAccess access, int32_t viewOptions, int64_t* actualOffset, MemoryMappedFileError* error);
+        static bool Advise(void* address, int64_t length, MemoryMappedAdvice advice);
         static void Flush(MemoryMappedFileHandle memoryMappedFileData, int64_t length);
         static bool UnmapView(MemoryMappedFileHandle memoryMappedFileData, int64_t length);
         static bool Close(FileHandle* file);
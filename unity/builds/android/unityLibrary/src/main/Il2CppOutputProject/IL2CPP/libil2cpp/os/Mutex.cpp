@@ -53,6 +53,15 @@ namespace os
         return m_Mutex->GetOSHandle();
     }
 
+    WaitObject* Mutex::GetWaitObject()
+    {
+#if IL2CPP_HAS_WAIT_OBJECTS
+        return m_Mutex;
+#else
+        return NULL;
+#endif
+    }
+
     FastMutex::FastMutex()
         : m_Impl(new FastMutexImpl())
     {
@@ -112,6 +121,11 @@ namespace os
         return NULL;
     }
 
+    WaitObject* Mutex::GetWaitObject()
+    {
+        return NULL;
+    }
+
     FastMutex::FastMutex()
     {
     }
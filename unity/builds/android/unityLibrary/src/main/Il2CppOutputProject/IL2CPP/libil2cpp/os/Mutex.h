@@ -25,6 +25,7 @@ namespace os
         bool TryLock(uint32_t milliseconds = 0, bool interruptible = false);
         void Unlock();
         void* GetOSHandle();
+        WaitObject* GetWaitObject();
 
     private:
         MutexImpl* m_Mutex;
@@ -49,6 +50,7 @@ namespace os
         virtual WaitStatus Wait(uint32_t ms, bool interruptible) { return m_Mutex->TryLock(ms, interruptible) ? kWaitStatusSuccess : kWaitStatusFailure; }
         virtual void Signal() { m_Mutex->Unlock(); }
         virtual void* GetOSHandle() { return m_Mutex->GetOSHandle(); }
+        virtual WaitObject* GetWaitObject() { return m_Mutex->GetWaitObject(); }
         Mutex* Get() { return m_Mutex; }
 
     private:
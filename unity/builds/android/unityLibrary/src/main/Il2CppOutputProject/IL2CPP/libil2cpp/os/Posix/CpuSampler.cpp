@@ -0,0 +1,438 @@
+#include "il2cpp-config.h"
+
+#if IL2CPP_TARGET_POSIX && !RUNTIME_TINY
+
+#include "os/CpuSampler.h"
+#include "os/ErrorCodes.h"
+
+#if (IL2CPP_TARGET_LINUX || IL2CPP_TARGET_ANDROID) && (defined(__x86_64__) || defined(__i386__) || defined(__aarch64__) || defined(__arm__))
+#define IL2CPP_HAS_CPU_SAMPLER 1
+#else
+#define IL2CPP_HAS_CPU_SAMPLER 0
+#endif
+
+#if IL2CPP_HAS_CPU_SAMPLER
+
+#include "os/Posix/Error.h"
+
+#include "Baselib.h"
+#include "Cpp/Atomic.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+#endif
+
+namespace il2cpp
+{
+namespace os
+{
+#if IL2CPP_HAS_CPU_SAMPLER
+
+    static const uint32_t kMaxRegisteredThreads = 256;
+    static const uint32_t kSampleQueueSize = 256; // Must be a power of two.
+
+    struct RegisteredThread
+    {
+        // 0 when the slot is free, -1 while it is being filled in.
+        baselib::atomic<int32_t> threadId;
+        uintptr_t stackLow;
+        uintptr_t stackHigh;
+    };
+
+    // Bounded queue from "Bounded MPMC queue" by Dmitry Vyukov, which only needs atomics and so can be
+    // written to from signal handlers running on any number of threads at once.
+    struct SampleQueueCell
+    {
+        baselib::atomic<uint32_t> sequence;
+        CpuSample sample;
+    };
+
+    static RegisteredThread s_RegisteredThreads[kMaxRegisteredThreads];
+    static SampleQueueCell s_SampleQueue[kSampleQueueSize];
+    static baselib::atomic<uint32_t> s_EnqueuePosition;
+    static uint32_t s_DequeuePosition;
+    static baselib::atomic<uint32_t> s_DroppedSampleCount;
+    // Running threads that could not register, and how many threads ran unsampled since the sampler started.
+    static baselib::atomic<uint32_t> s_UnregisteredThreadCount;
+    static baselib::atomic<uint32_t> s_UnsampledThreadCount;
+
+    static baselib::atomic<bool> s_Running;
+    static bool s_SignalHandlerInstalled;
+    // What SIGPROF and the CPU time timer did before the sampler started: signals we did not cause are
+    // passed on to the previous handler, and both are put back when the sampler stops.
+    static struct sigaction s_PreviousAction;
+    static struct itimerval s_PreviousTimer;
+
+    static inline int32_t GetCurrentThreadId()
+    {
+        return static_cast<int32_t>(syscall(SYS_gettid));
+    }
+
+    static const RegisteredThread* FindRegisteredThread(int32_t threadId)
+    {
+        for (uint32_t i = 0; i < kMaxRegisteredThreads; ++i)
+        {
+            if (s_RegisteredThreads[i].threadId.load(baselib::memory_order_acquire) == threadId)
+                return &s_RegisteredThreads[i];
+        }
+
+        return NULL;
+    }
+
+    static void GetInterruptedRegisters(const void* context, uintptr_t* pc, uintptr_t* fp, uintptr_t* sp, uintptr_t* lr)
+    {
+        const ucontext_t* ucontext = static_cast<const ucontext_t*>(context);
+        *lr = 0;
+
+#if defined(__x86_64__)
+        *pc = ucontext->uc_mcontext.gregs[REG_RIP];
+        *fp = ucontext->uc_mcontext.gregs[REG_RBP];
+        *sp = ucontext->uc_mcontext.gregs[REG_RSP];
+#elif defined(__i386__)
+        *pc = ucontext->uc_mcontext.gregs[REG_EIP];
+        *fp = ucontext->uc_mcontext.gregs[REG_EBP];
+        *sp = ucontext->uc_mcontext.gregs[REG_ESP];
+#elif defined(__aarch64__)
+        *pc = ucontext->uc_mcontext.pc;
+        *fp = ucontext->uc_mcontext.regs[29];
+        *sp = ucontext->uc_mcontext.sp;
+#elif defined(__arm__)
+        // Thumb code does not keep a usable frame pointer chain, so only the caller is known.
+        *pc = ucontext->uc_mcontext.arm_pc;
+        *fp = 0;
+        *sp = ucontext->uc_mcontext.arm_sp;
+        *lr = ucontext->uc_mcontext.arm_lr;
+#endif
+    }
+
+    static void CaptureStack(const RegisteredThread* thread, const void* context, CpuSample* sample)
+    {
+        uintptr_t pc, fp, sp, lr;
+        GetInterruptedRegisters(context, &pc, &fp, &sp, &lr);
+
+        uint32_t frameCount = 0;
+        sample->frames[frameCount++] = reinterpret_cast<void*>(pc);
+
+        if (lr != 0)
+            sample->frames[frameCount++] = reinterpret_cast<void*>(lr);
+
+        // Every frame we follow has to be further up the stack we know the thread runs on, otherwise
+        // we would be reading through whatever the register happens to hold.
+        uintptr_t low = sp;
+        const uintptr_t high = thread->stackHigh;
+
+        if (sp < thread->stackLow || sp >= high)
+            fp = 0;
+
+        while (frameCount < CpuSampler::kMaxFrames && fp >= low && fp <= high - 2 * sizeof(uintptr_t) && (fp & (sizeof(uintptr_t) - 1)) == 0)
+        {
+            const uintptr_t* frame = reinterpret_cast<const uintptr_t*>(fp);
+            const uintptr_t returnAddress = frame[1];
+
+            if (returnAddress == 0)
+                break;
+
+            sample->frames[frameCount++] = reinterpret_cast<void*>(returnAddress);
+
+            low = fp + 2 * sizeof(uintptr_t);
+            fp = frame[0];
+        }
+
+        sample->frameCount = frameCount;
+    }
+
+    static void ForwardSignal(int signal, siginfo_t* info, void* context)
+    {
+        if (s_PreviousAction.sa_flags & SA_SIGINFO)
+        {
+            s_PreviousAction.sa_sigaction(signal, info, context);
+        }
+        else if (s_PreviousAction.sa_handler == SIG_DFL)
+        {
+            // The default action for SIGPROF terminates the process. The signal is blocked while we run, so
+            // raising it again delivers it with the default action as soon as we return.
+            struct sigaction action;
+            memset(&action, 0, sizeof(action));
+            action.sa_handler = SIG_DFL;
+            sigemptyset(&action.sa_mask);
+            sigaction(signal, &action, NULL);
+            raise(signal);
+        }
+        else if (s_PreviousAction.sa_handler != SIG_IGN)
+        {
+            s_PreviousAction.sa_handler(signal);
+        }
+    }
+
+    static void OnProfilingSignal(int signal, siginfo_t* info, void* context)
+    {
+        // The CPU time timer is the only source of SIGPROF with SI_KERNEL. Anything else (kill, sigqueue,
+        // timer_create) was sent for whoever handled SIGPROF before us.
+        if (info == NULL || info->si_code != SI_KERNEL)
+        {
+            ForwardSignal(signal, info, context);
+            return;
+        }
+
+        if (!s_Running.load(baselib::memory_order_relaxed))
+            return;
+
+        const int savedErrno = errno;
+        const int32_t threadId = GetCurrentThreadId();
+        const RegisteredThread* thread = FindRegisteredThread(threadId);
+
+        if (thread != NULL)
+        {
+            uint32_t position = s_EnqueuePosition.load(baselib::memory_order_relaxed);
+            SampleQueueCell* cell = NULL;
+
+            for (;;)
+            {
+                cell = &s_SampleQueue[position & (kSampleQueueSize - 1)];
+                const int32_t difference = static_cast<int32_t>(cell->sequence.load(baselib::memory_order_acquire) - position);
+
+                if (difference == 0)
+                {
+                    if (s_EnqueuePosition.compare_exchange_weak(position, position + 1, baselib::memory_order_relaxed, baselib::memory_order_relaxed))
+                        break;
+                }
+                else if (difference < 0)
+                {
+                    cell = NULL;
+                    break;
+                }
+                else
+                {
+                    position = s_EnqueuePosition.load(baselib::memory_order_relaxed);
+                }
+            }
+
+            if (cell != NULL)
+            {
+                cell->sample.threadId = static_cast<uint64_t>(threadId);
+                CaptureStack(thread, context, &cell->sample);
+                cell->sequence.store(position + 1, baselib::memory_order_release);
+            }
+            else
+            {
+                s_DroppedSampleCount.fetch_add(1, baselib::memory_order_relaxed);
+            }
+        }
+
+        errno = savedErrno;
+    }
+
+    bool CpuSampler::IsSupported()
+    {
+        return true;
+    }
+
+    bool CpuSampler::Start(uint32_t intervalMicroseconds, int* error)
+    {
+        if (s_Running.load())
+        {
+            *error = kErrorCodeAlreadyExists;
+            return false;
+        }
+
+        // A zero interval would disarm the timer rather than sample continuously.
+        if (intervalMicroseconds == 0)
+        {
+            *error = kErrorCodeInvalidParameter;
+            return false;
+        }
+
+        for (uint32_t i = 0; i < kSampleQueueSize; ++i)
+            s_SampleQueue[i].sequence.store(i, baselib::memory_order_relaxed);
+
+        s_EnqueuePosition.store(0, baselib::memory_order_relaxed);
+        s_DequeuePosition = 0;
+        s_DroppedSampleCount.store(0, baselib::memory_order_relaxed);
+        s_UnsampledThreadCount.store(s_UnregisteredThreadCount.load(baselib::memory_order_relaxed), baselib::memory_order_relaxed);
+
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = OnProfilingSignal;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+
+        if (sigaction(SIGPROF, &action, &s_PreviousAction) == -1)
+        {
+            *error = FileErrnoToErrorCode(errno);
+            return false;
+        }
+
+        s_SignalHandlerInstalled = true;
+        s_Running.store(true);
+
+        struct itimerval timer;
+        timer.it_interval.tv_sec = intervalMicroseconds / 1000000;
+        timer.it_interval.tv_usec = intervalMicroseconds % 1000000;
+        timer.it_value = timer.it_interval;
+
+        if (setitimer(ITIMER_PROF, &timer, &s_PreviousTimer) == -1)
+        {
+            *error = FileErrnoToErrorCode(errno);
+            memset(&s_PreviousTimer, 0, sizeof(s_PreviousTimer));
+            Stop();
+            return false;
+        }
+
+        *error = kErrorCodeSuccess;
+        return true;
+    }
+
+    void CpuSampler::Stop()
+    {
+        if (!s_SignalHandlerInstalled)
+            return;
+
+        // Timer signals are process directed and go to a thread that does not block them as soon as they
+        // are generated, so once our timer is replaced none of its signals can reach the previous handler.
+        setitimer(ITIMER_PROF, &s_PreviousTimer, NULL);
+
+        s_Running.store(false);
+
+        sigaction(SIGPROF, &s_PreviousAction, NULL);
+        s_SignalHandlerInstalled = false;
+    }
+
+    bool CpuSampler::ReadSample(CpuSample* sample)
+    {
+        SampleQueueCell* cell = &s_SampleQueue[s_DequeuePosition & (kSampleQueueSize - 1)];
+
+        if (cell->sequence.load(baselib::memory_order_acquire) != s_DequeuePosition + 1)
+            return false;
+
+        sample->threadId = cell->sample.threadId;
+        sample->frameCount = cell->sample.frameCount;
+        memcpy(sample->frames, cell->sample.frames, cell->sample.frameCount * sizeof(void*));
+
+        cell->sequence.store(s_DequeuePosition + kSampleQueueSize, baselib::memory_order_release);
+        s_DequeuePosition++;
+        return true;
+    }
+
+    uint32_t CpuSampler::GetDroppedSampleCount()
+    {
+        return s_DroppedSampleCount.load(baselib::memory_order_relaxed);
+    }
+
+    uint32_t CpuSampler::GetUnsampledThreadCount()
+    {
+        return s_UnsampledThreadCount.load(baselib::memory_order_relaxed);
+    }
+
+    static void CountUnregisteredThread()
+    {
+        s_UnregisteredThreadCount.fetch_add(1, baselib::memory_order_relaxed);
+        s_UnsampledThreadCount.fetch_add(1, baselib::memory_order_relaxed);
+    }
+
+    void CpuSampler::RegisterCurrentThread()
+    {
+        pthread_attr_t attributes;
+        if (pthread_getattr_np(pthread_self(), &attributes) != 0)
+        {
+            CountUnregisteredThread();
+            return;
+        }
+
+        void* stackAddress;
+        size_t stackSize;
+        const int result = pthread_attr_getstack(&attributes, &stackAddress, &stackSize);
+        pthread_attr_destroy(&attributes);
+
+        if (result != 0)
+        {
+            CountUnregisteredThread();
+            return;
+        }
+
+        for (uint32_t i = 0; i < kMaxRegisteredThreads; ++i)
+        {
+            RegisteredThread& thread = s_RegisteredThreads[i];
+            int32_t expected = 0;
+
+            if (thread.threadId.compare_exchange_strong(expected, -1, baselib::memory_order_acquire, baselib::memory_order_relaxed))
+            {
+                thread.stackLow = reinterpret_cast<uintptr_t>(stackAddress);
+                thread.stackHigh = reinterpret_cast<uintptr_t>(stackAddress) + stackSize;
+                thread.threadId.store(GetCurrentThreadId(), baselib::memory_order_release);
+                return;
+            }
+        }
+
+        // Out of slots: the thread is not sampled, which the sampler reports.
+        CountUnregisteredThread();
+    }
+
+    void CpuSampler::UnregisterCurrentThread()
+    {
+        const int32_t threadId = GetCurrentThreadId();
+
+        for (uint32_t i = 0; i < kMaxRegisteredThreads; ++i)
+        {
+            if (s_RegisteredThreads[i].threadId.load(baselib::memory_order_relaxed) == threadId)
+            {
+                s_RegisteredThreads[i].threadId.store(0, baselib::memory_order_release);
+                return;
+            }
+        }
+
+        // Every thread registers before it unregisters, so this one is one of those that could not.
+        s_UnregisteredThreadCount.fetch_sub(1, baselib::memory_order_relaxed);
+    }
+
+#else
+
+    bool CpuSampler::IsSupported()
+    {
+        return false;
+    }
+
+    bool CpuSampler::Start(uint32_t intervalMicroseconds, int* error)
+    {
+        *error = kErrorNotSupported;
+        return false;
+    }
+
+    void CpuSampler::Stop()
+    {
+    }
+
+    bool CpuSampler::ReadSample(CpuSample* sample)
+    {
+        return false;
+    }
+
+    uint32_t CpuSampler::GetDroppedSampleCount()
+    {
+        return 0;
+    }
+
+    uint32_t CpuSampler::GetUnsampledThreadCount()
+    {
+        return 0;
+    }
+
+    void CpuSampler::RegisterCurrentThread()
+    {
+    }
+
+    void CpuSampler::UnregisterCurrentThread()
+    {
+    }
+
+#endif
+}
+}
+
+#endif
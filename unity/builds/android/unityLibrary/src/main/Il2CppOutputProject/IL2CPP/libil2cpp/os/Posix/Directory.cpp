@@ -6,6 +6,7 @@
 #include "os/ErrorCodes.h"
 #include "os/File.h"
 #include "os/Posix/Error.h"
+#include "os/Posix/PosixHelpers.h"
 #include "utils/DirectoryUtils.h"
 #include "utils/Memory.h"
 #include "utils/PathUtils.h"
@@ -23,6 +24,9 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+// d_type, dirfd and fstatat let us skip the per-entry stat or at least the full path resolution.
+#define IL2CPP_HAS_DIRENT_TYPE (IL2CPP_TARGET_LINUX || IL2CPP_TARGET_ANDROID || IL2CPP_TARGET_DARWIN)
+
 namespace il2cpp
 {
 namespace os
@@ -89,76 +93,101 @@ namespace os
         return true;
     }
 
-    static void DirectoryGlob(DIR *dir, const std::string& pattern, std::set<std::string>& result)
+    static inline bool IsDotOrDotDot(const char* name)
     {
-        if (pattern.empty())
-            return;
+        return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+    }
 
-        std::string matchPattern = il2cpp::utils::CollapseAdjacentStars(pattern);
+    // The only attributes that can be derived from a directory entry without calling stat:
+    // read-only and normal depend on the mode bits and reparse point needs the link status.
+    static const int32_t kDirectoryEntryAttributesMask = kFileAttributeDirectory | kFileAttributeHidden;
 
-        struct dirent *entry;
+    static bool TryGetAttributesFromDirectoryEntry(const dirent* entry, int32_t mask, int32_t* attributes)
+    {
+#if IL2CPP_HAS_DIRENT_TYPE
+        if ((mask & ~kDirectoryEntryAttributesMask) != 0 || entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK)
+            return false;
 
-        while ((entry = readdir(dir)) != NULL)
-        {
-            const std::string filename(entry->d_name);
+        *attributes = entry->d_type == DT_DIR ? static_cast<int32_t>(kFileAttributeDirectory) : 0;
+        if (entry->d_name[0] == '.')
+            *attributes |= kFileAttributeHidden;
 
-            if (!il2cpp::utils::Match(filename, matchPattern))
-                continue;
+        return true;
+#else
+        return false;
+#endif
+    }
 
-            result.insert(filename);
-        }
+    static bool GetDirectoryEntryAttributes(DIR* dir, const dirent* entry, const std::string& entryPath, int32_t* attributes)
+    {
+        int attributeError;
+
+#if IL2CPP_HAS_DIRENT_TYPE
+        UnityPalFileAttributes entryAttributes;
+        attributeError = posix::GetFileAttributesAt(dirfd(dir), entry->d_name, &entryAttributes);
+        *attributes = static_cast<int32_t>(entryAttributes);
+#else
+        *attributes = static_cast<int32_t>(File::GetFileAttributes(entryPath, &attributeError));
+#endif
+
+        return attributeError == kErrorCodeSuccess;
     }
 
-    static bool DirectoryGlob(const std::string& directoryPath, const std::string& pattern, std::set<std::string>& result, int* error)
+    std::set<std::string> Directory::GetFileSystemEntries(const std::string& path, const std::string& pathWithPattern, int32_t attributes, int32_t mask, int* error)
     {
+        const std::string directoryPath(il2cpp::utils::PathUtils::DirectoryName(pathWithPattern));
+        const std::string pattern(il2cpp::utils::PathUtils::Basename(pathWithPattern));
+
+        std::set<std::string> result;
         DIR* dir = opendir(directoryPath.c_str());
 
         if (dir == NULL)
         {
             *error = PathErrnoToErrorCode(directoryPath, errno);
-            return false;
+            return result;
         }
 
-        DirectoryGlob(dir, pattern, result);
-
-        closedir(dir);
-
-        return true;
-    }
+        *error = kErrorCodeSuccess;
 
-    std::set<std::string> Directory::GetFileSystemEntries(const std::string& path, const std::string& pathWithPattern, int32_t attributes, int32_t mask, int* error)
-    {
-        const std::string directoryPath(il2cpp::utils::PathUtils::DirectoryName(pathWithPattern));
-        const std::string pattern(il2cpp::utils::PathUtils::Basename(pathWithPattern));
+        if (pattern.empty())
+        {
+            closedir(dir);
+            return result;
+        }
 
-        std::set<std::string> globResult;
+        const std::string matchPattern = il2cpp::utils::CollapseAdjacentStars(pattern);
 
-        if (DirectoryGlob(directoryPath, pattern, globResult, error) == false)
-            return std::set<std::string>();
+        // Every entry path is built in place after the directory prefix, so the buffer is only
+        // reallocated when a longer file name than any seen before comes along.
+        std::string entryPath(directoryPath);
+        entryPath.push_back(IL2CPP_DIR_SEPARATOR);
+        const size_t directoryPathLength = entryPath.length();
 
-        std::set<std::string> result;
+        struct dirent *entry;
 
-        for (std::set<std::string>::const_iterator it = globResult.begin(), end = globResult.end(); it != end; ++it)
+        while ((entry = readdir(dir)) != NULL)
         {
-            const std::string& filename = *it;
+            if (IsDotOrDotDot(entry->d_name))
+                continue;
 
-            if (filename == "." || filename == "..")
+            if (!il2cpp::utils::Match(entry->d_name, matchPattern))
                 continue;
 
-            const std::string path(directoryPath + IL2CPP_DIR_SEPARATOR + filename);
+            entryPath.resize(directoryPathLength);
+            entryPath.append(entry->d_name);
 
-            int attributeError;
-            const int32_t pathAttributes = static_cast<int32_t>(File::GetFileAttributes(path, &attributeError));
+            int32_t entryAttributes;
+            if (!TryGetAttributesFromDirectoryEntry(entry, mask, &entryAttributes) && !GetDirectoryEntryAttributes(dir, entry, entryPath, &entryAttributes))
+                continue;
 
-            if (attributeError != kErrorCodeSuccess)
+            if ((entryAttributes & mask) != attributes)
                 continue;
 
-            if ((pathAttributes & mask) == attributes)
-                result.insert(path);
+            result.insert(entryPath);
         }
 
+        closedir(dir);
 
-        *error = kErrorCodeSuccess;
         return result;
     }
 
@@ -209,18 +238,23 @@ namespace os
         dirent* entry;
         while ((entry = readdir(static_cast<DIR*>(findHandle->osHandle))) != NULL)
         {
-            const Il2CppNativeString filename(entry->d_name);
-
-            if (il2cpp::utils::Match(filename, findHandle->pattern))
+            if (il2cpp::utils::Match(entry->d_name, findHandle->pattern))
             {
-                const Il2CppNativeString path = utils::PathUtils::Combine(findHandle->directoryPath, filename);
-
                 int attributeError;
-                const int32_t pathAttributes = static_cast<int32_t>(File::GetFileAttributes(path, &attributeError));
+                int32_t pathAttributes;
+
+#if IL2CPP_HAS_DIRENT_TYPE
+                UnityPalFileAttributes entryAttributes;
+                attributeError = posix::GetFileAttributesAt(dirfd(static_cast<DIR*>(findHandle->osHandle)), entry->d_name, &entryAttributes);
+                pathAttributes = static_cast<int32_t>(entryAttributes);
+#else
+                const Il2CppNativeString path = utils::PathUtils::Combine(findHandle->directoryPath, Il2CppNativeString(entry->d_name));
+                pathAttributes = static_cast<int32_t>(File::GetFileAttributes(path, &attributeError));
+#endif
 
                 if (attributeError == kErrorCodeSuccess)
                 {
-                    *resultFileName = filename;
+                    resultFileName->assign(entry->d_name);
                     *resultAttributes = pathAttributes;
                     return os::kErrorCodeSuccess;
                 }
@@ -8,13 +8,27 @@
 #include "FilePlatformConfig.h"
 #endif
 
+#if !defined(HAVE_POSIX_FADVISE) && (IL2CPP_TARGET_LINUX || IL2CPP_TARGET_ANDROID)
+#define HAVE_POSIX_FADVISE 1
+#endif
+
+#if IL2CPP_TARGET_LINUX || (IL2CPP_TARGET_ANDROID && __ANDROID_API__ >= 24)
+#define IL2CPP_HAVE_PREADV 1
+#else
+#define IL2CPP_HAVE_PREADV 0
+#endif
+
 #include "os/ConsoleExtension.h"
 #include "os/ErrorCodes.h"
 #include "os/File.h"
 #include "os/Mutex.h"
 #include "os/Posix/Error.h"
+#include "os/Posix/PosixHelpers.h"
 #include "utils/Expected.h"
+#include "utils/HashUtils.h"
 #include "utils/Il2CppError.h"
+#include "utils/Il2CppHashMap.h"
+#include "utils/Il2CppHashSet.h"
 #include "utils/PathUtils.h"
 
 #if IL2CPP_SUPPORT_THREADS
@@ -33,6 +47,10 @@
 #endif
 #include <sys/stat.h>
 #include <sys/types.h>
+#if IL2CPP_HAVE_PREADV
+#include <limits.h>
+#include <sys/uio.h>
+#endif
 #include <string>
 
 #define INVALID_FILE_HANDLE     (FileHandle*)-1
@@ -43,87 +61,229 @@ namespace il2cpp
 {
 namespace os
 {
-// Head and tail of linked list.
-    static FileHandle* s_fileHandleHead = NULL;
-    static FileHandle* s_fileHandleTail = NULL;
+    // Open file handles are indexed by the file they refer to, so that checking for sharing violations does not
+    // depend on how many files are open. The index is split in shards with a lock each, picked by the same hash.
+    struct FileKey
+    {
+        dev_t device;
+        ino_t inode;
+
+        bool operator==(const FileKey& other) const
+        {
+            return device == other.device && inode == other.inode;
+        }
+    };
+
+    struct FileKeyHash
+    {
+        size_t operator()(const FileKey& key) const
+        {
+            return utils::HashUtils::Combine(static_cast<size_t>(key.device), static_cast<size_t>(key.inode));
+        }
+    };
+
+    // All the handles that are open on one file, oldest first, linked through FileHandle::prev and next.
+    struct FileHandleList
+    {
+        FileHandle* head;
+        FileHandle* tail;
+    };
+
+    typedef Il2CppHashMap<FileKey, FileHandleList, FileKeyHash> FileHandleMap;
+
+    struct FileHandlePointerHash
+    {
+        size_t operator()(const FileHandle* handle) const
+        {
+            return utils::HashUtils::AlignedPointerHash(handle);
+        }
+    };
+
+    typedef Il2CppHashSet<const FileHandle*, FileHandlePointerHash> FileHandleSet;
+
+    // Besides the handles by file, every shard keeps the handles whose address hashes to it, so that
+    // IsHandleOpenFileHandle is one lookup rather than a walk over every open file.
+    struct FileHandleShard
+    {
 #if IL2CPP_SUPPORT_THREADS
-    static baselib::ReentrantLock s_fileHandleMutex;
+        baselib::ReentrantLock mutex;
 #endif
+        FileHandleMap handles;
+        FileHandleSet openHandles;
+    };
+
+    const int kFileHandleShardBits = 4;
+    const size_t kFileHandleShardCount = 1 << kFileHandleShardBits;
+    static FileHandleShard s_fileHandleShards[kFileHandleShardCount];
 
-    static void AddFileHandle(FileHandle *fileHandle)
+    static inline FileKey GetFileKey(const struct stat& statBuf)
     {
+        FileKey key = { statBuf.st_dev, statBuf.st_ino };
+        return key;
+    }
+
+    static inline FileHandleShard& GetShard(const FileKey& key)
+    {
+        // The low bits of the hash also pick the bucket within the shard, so mix them into the top bits
+        // (Fibonacci hashing) rather than using them directly.
+        const uint32_t hash = static_cast<uint32_t>(FileKeyHash()(key));
+        return s_fileHandleShards[(hash * 2654435769u) >> (32 - kFileHandleShardBits)];
+    }
+
+    static inline FileHandleShard& GetShard(const FileHandle* handle)
+    {
+        const uint32_t hash = static_cast<uint32_t>(FileHandlePointerHash()(handle));
+        return s_fileHandleShards[(hash * 2654435769u) >> (32 - kFileHandleShardBits)];
+    }
+
+    // The pointer shard is only ever locked on its own, never while another shard lock is held.
+    static void AddOpenHandle(const FileHandle* fileHandle)
+    {
+        FileHandleShard& shard = GetShard(fileHandle);
+
 #if IL2CPP_SUPPORT_THREADS
-        FastAutoLock autoLock(&s_fileHandleMutex);
+        FastAutoLock autoLock(&shard.mutex);
 #endif
 
-        if (s_fileHandleHead == NULL)
-        {
-            IL2CPP_ASSERT(s_fileHandleTail == NULL);
+        shard.openHandles.insert(fileHandle);
+    }
 
-            s_fileHandleHead = fileHandle;
-            s_fileHandleTail = fileHandle;
-        }
-        else
-        {
-            IL2CPP_ASSERT(s_fileHandleTail != NULL);
-            IL2CPP_ASSERT(s_fileHandleTail->next == NULL);
+    static void RemoveOpenHandle(const FileHandle* fileHandle)
+    {
+        FileHandleShard& shard = GetShard(fileHandle);
+
+#if IL2CPP_SUPPORT_THREADS
+        FastAutoLock autoLock(&shard.mutex);
+#endif
+
+        shard.openHandles.erase(fileHandle);
+    }
+
+    static bool ShareModesAllowOpen(const FileHandle* fileHandle, int shareMode, int accessMode)
+    {
+        if (fileHandle == NULL) // File is not open
+            return true;
 
-            s_fileHandleTail->next = fileHandle;
-            fileHandle->prev = s_fileHandleTail;
-            s_fileHandleTail = fileHandle;
+        if (fileHandle->shareMode == kFileShareNone || shareMode == kFileShareNone)
+            return false;
+
+        if (((fileHandle->shareMode == kFileShareRead)  && (accessMode != kFileAccessRead)) ||
+            ((fileHandle->shareMode == kFileShareWrite) && (accessMode != kFileAccessWrite)))
+        {
+            return false;
         }
+
+        return true;
     }
 
-    static void RemoveFileHandle(il2cpp::os::FileHandle *fileHandle)
+    // Checks for a sharing violation and registers the handle under the same lock, so that two threads
+    // opening the same file at once cannot both get past the check.
+    static bool AddFileHandleToFileIfShareAllowed(FileHandle *fileHandle)
     {
+        FileKey key = { fileHandle->device, fileHandle->inode };
+        FileHandleShard& shard = GetShard(key);
+
 #if IL2CPP_SUPPORT_THREADS
-        FastAutoLock autoLock(&s_fileHandleMutex);
+        FastAutoLock autoLock(&shard.mutex);
 #endif
 
-        if (s_fileHandleHead == fileHandle)
-            s_fileHandleHead = fileHandle->next;
+        FileHandleMap::iterator it = shard.handles.find(key);
+        if (it == shard.handles.end())
+        {
+            FileHandleList list = { fileHandle, fileHandle };
+            shard.handles.add(key, list);
+            return true;
+        }
 
-        if (s_fileHandleTail == fileHandle)
-            s_fileHandleTail = fileHandle->prev;
+        // As before, only the oldest handle open on the file decides.
+        if (!ShareModesAllowOpen(it->second.head, fileHandle->shareMode, fileHandle->accessMode))
+            return false;
 
-        if (fileHandle->prev)
-            fileHandle->prev->next = fileHandle->next;
+        IL2CPP_ASSERT(it->second.tail->next == NULL);
+        it->second.tail->next = fileHandle;
+        fileHandle->prev = it->second.tail;
+        it->second.tail = fileHandle;
+        return true;
+    }
 
-        if (fileHandle->next)
-            fileHandle->next->prev = fileHandle->prev;
+    static bool AddFileHandleIfShareAllowed(FileHandle *fileHandle)
+    {
+        if (!AddFileHandleToFileIfShareAllowed(fileHandle))
+            return false;
+
+        AddOpenHandle(fileHandle);
+        return true;
     }
 
-    static const FileHandle* FindFileHandle(const struct stat& statBuf)
+    static void RemoveFileHandleFromFile(il2cpp::os::FileHandle *fileHandle)
     {
+        FileKey key = { fileHandle->device, fileHandle->inode };
+        FileHandleShard& shard = GetShard(key);
+
 #if IL2CPP_SUPPORT_THREADS
-        FastAutoLock autoLock(&s_fileHandleMutex);
+        FastAutoLock autoLock(&shard.mutex);
 #endif
 
-        const dev_t device = statBuf.st_dev;
-        const ino_t inode = statBuf.st_ino;
+        FileHandleMap::iterator it = shard.handles.find(key);
+        if (it == shard.handles.end())
+            return;
 
-        for (FileHandle *handle = s_fileHandleHead; handle != NULL; handle = handle->next)
-        {
-            if (handle->device == device && handle->inode == inode)
-                return handle;
-        }
+        if (it->second.head == fileHandle)
+            it->second.head = fileHandle->next;
+
+        if (it->second.tail == fileHandle)
+            it->second.tail = fileHandle->prev;
+
+        if (fileHandle->prev)
+            fileHandle->prev->next = fileHandle->next;
+
+        if (fileHandle->next)
+            fileHandle->next->prev = fileHandle->prev;
+
+        if (it->second.head == NULL)
+            shard.handles.erase(it);
+    }
 
-        return NULL;
+    static void RemoveFileHandle(il2cpp::os::FileHandle *fileHandle)
+    {
+        RemoveOpenHandle(fileHandle);
+        RemoveFileHandleFromFile(fileHandle);
     }
 
     bool File::IsHandleOpenFileHandle(intptr_t lookup)
     {
+        // lookup is only compared against the handles we know, never dereferenced.
+        const FileHandle* handle = reinterpret_cast<const FileHandle*>(lookup);
+        FileHandleShard& shard = GetShard(handle);
+
 #if IL2CPP_SUPPORT_THREADS
-        FastAutoLock autoLock(&s_fileHandleMutex);
+        FastAutoLock autoLock(&shard.mutex);
 #endif
 
-        for (FileHandle *handle = s_fileHandleHead; handle != NULL; handle = handle->next)
+        return shard.openHandles.find(handle) != shard.openHandles.end();
+    }
+
+    FileHandle* File::CreateHandleForDescriptor(int fd, FileType type, int accessMode)
+    {
+        FileHandle* fileHandle = new FileHandle();
+        fileHandle->fd = fd;
+        fileHandle->type = type;
+        fileHandle->accessMode = accessMode;
+        fileHandle->shareMode = kFileShareReadWrite | kFileShareDelete;
+
+        struct stat statbuf;
+        if (fstat(fd, &statbuf) == 0)
         {
-            if (reinterpret_cast<intptr_t>(handle) == lookup)
-                return true;
+            fileHandle->device = statbuf.st_dev;
+            fileHandle->inode = statbuf.st_ino;
         }
 
-        return false;
+        // Only used for descriptors of files File does not open itself, so no handle can deny sharing them.
+        bool added = AddFileHandleIfShareAllowed(fileHandle);
+        IL2CPP_ASSERT(added);
+        NO_UNUSED_WARNING(added);
+
+        return fileHandle;
     }
 
 // NOTE:
@@ -134,24 +294,18 @@ namespace os
 
     static bool ShareAllowOpen(const struct stat& statBuf, int shareMode, int accessMode)
     {
-        const FileHandle *fileHandle = FindFileHandle(statBuf);
-
-        if (fileHandle == NULL) // File is not open
-            return true;
-
-        if (fileHandle->shareMode == kFileShareNone || shareMode == kFileShareNone)
-            return false;
+        const FileKey key = GetFileKey(statBuf);
+        FileHandleShard& shard = GetShard(key);
 
-        if (((fileHandle->shareMode == kFileShareRead)  && (accessMode != kFileAccessRead)) ||
-            ((fileHandle->shareMode == kFileShareWrite) && (accessMode != kFileAccessWrite)))
-        {
-            return false;
-        }
+#if IL2CPP_SUPPORT_THREADS
+        FastAutoLock autoLock(&shard.mutex);
+#endif
 
-        return true;
+        FileHandleMap::const_iterator it = shard.handles.find(key);
+        return ShareModesAllowOpen(it != shard.handles.end() ? it->second.head : NULL, shareMode, accessMode);
     }
 
-    static UnityPalFileAttributes StatToFileAttribute(const std::string& path, struct stat& pathStat, struct stat* linkStat)
+    static UnityPalFileAttributes StatToFileAttribute(const char* filename, struct stat& pathStat, struct stat* linkStat)
     {
         uint32_t fileAttributes = 0;
 
@@ -163,8 +317,6 @@ namespace os
             fileAttributes |= kFileAttributeReadOnly;
 #endif
 
-        const std::string filename(il2cpp::utils::PathUtils::Basename(path));
-
         if (S_ISDIR(pathStat.st_mode))
         {
             fileAttributes = kFileAttributeDirectory;
@@ -209,6 +361,25 @@ namespace os
         return kErrorCodeSuccess;
     }
 
+namespace posix
+{
+    int GetFileAttributesAt(int directoryFd, const char* name, UnityPalFileAttributes* attributes)
+    {
+        struct stat pathStat, linkStat;
+
+        // lstat first: for anything that is not a symlink it already is the stat result, so the
+        // common case costs a single syscall instead of the stat + lstat pair done by GetStatAndLinkStat.
+        if (fstatat(directoryFd, name, &linkStat, AT_SYMLINK_NOFOLLOW) != 0)
+            return FileErrnoToErrorCode(errno);
+
+        if (!S_ISLNK(linkStat.st_mode) || fstatat(directoryFd, name, &pathStat, 0) != 0) // Might be a dangling symlink...
+            pathStat = linkStat;
+
+        *attributes = StatToFileAttribute(name, pathStat, &linkStat);
+        return kErrorCodeSuccess;
+    }
+}
+
     static uint64_t TimeToTicks(time_t timeval)
     {
         return ((uint64_t)timeval * 10000000) + TIME_ZERO;
@@ -369,7 +540,7 @@ namespace os
         if (*error != kErrorCodeSuccess)
             return INVALID_FILE_ATTRIBUTES;
 
-        return StatToFileAttribute(path, pathStat, &linkStat);
+        return StatToFileAttribute(il2cpp::utils::PathUtils::Basename(path).c_str(), pathStat, &linkStat);
     }
 
     bool File::SetFileAttributes(const std::string& path, UnityPalFileAttributes attributes, int* error)
@@ -436,7 +607,7 @@ namespace os
 
         stat->name = filename;
 
-        stat->attributes = StatToFileAttribute(path, pathStat, &linkStat);
+        stat->attributes = StatToFileAttribute(filename.c_str(), pathStat, &linkStat);
 
         stat->length = (stat->attributes & kFileAttributeDirectory) > 0 ? 0 : pathStat.st_size;
 
@@ -754,13 +925,6 @@ namespace os
             return INVALID_FILE_HANDLE;
         }
 
-        if (!ShareAllowOpen(statbuf, shareMode, accessMode))
-        {
-            *error = kErrorCodeSharingViolation;
-            close(fd);
-            return INVALID_FILE_HANDLE;
-        }
-
         FileHandle* fileHandle = new FileHandle();
         fileHandle->fd = fd;
         fileHandle->path = path;
@@ -771,8 +935,13 @@ namespace os
         fileHandle->device = statbuf.st_dev;
         fileHandle->inode = statbuf.st_ino;
 
-        // Add to linked list
-        AddFileHandle(fileHandle);
+        if (!AddFileHandleIfShareAllowed(fileHandle))
+        {
+            *error = kErrorCodeSharingViolation;
+            close(fd);
+            delete fileHandle;
+            return INVALID_FILE_HANDLE;
+        }
 
 #ifdef HAVE_POSIX_FADVISE
         if (options & kFileOptionsSequentialScan)
@@ -800,7 +969,6 @@ namespace os
 
         close(handle->fd);
 
-        // Remove from linked list
         RemoveFileHandle(handle);
 
         delete handle;
@@ -1080,6 +1248,247 @@ namespace os
         return ret;
     }
 
+    int File::ReadAt(FileHandle* handle, char *dest, int count, int64_t position, int *error)
+    {
+        if (handle == NULL || handle == INVALID_FILE_HANDLE)
+        {
+            *error = kErrorCodeInvalidHandle;
+            return 0;
+        }
+
+        if ((handle->accessMode & kFileAccessRead) == 0)
+        {
+            *error = kErrorCodeAccessDenied;
+            return 0;
+        }
+
+        int ret;
+
+        do
+        {
+            ret = (int)pread(handle->fd, dest, count, (off_t)position);
+        }
+        while (ret == -1 && errno == EINTR);
+
+        if (ret == -1)
+        {
+            *error = FileErrnoToErrorCode(errno);
+            return 0;
+        }
+
+        return ret;
+    }
+
+    int32_t File::WriteAt(FileHandle* handle, const char* buffer, int count, int64_t position, int *error)
+    {
+        if (handle == NULL || handle == INVALID_FILE_HANDLE)
+        {
+            *error = kErrorCodeInvalidHandle;
+            return -1;
+        }
+
+        if ((handle->accessMode & kFileAccessWrite) == 0)
+        {
+            *error = kErrorCodeAccessDenied;
+            return -1;
+        }
+
+        int ret;
+
+        do
+        {
+            ret = (int32_t)pwrite(handle->fd, buffer, count, (off_t)position);
+        }
+        while (ret == -1 && errno == EINTR);
+
+        if (ret == -1)
+        {
+            *error = FileErrnoToErrorCode(errno);
+            return -1;
+        }
+
+        return ret;
+    }
+
+#if IL2CPP_HAVE_PREADV
+
+    // Transfers the buffers IOV_MAX at a time, stopping at the first short transfer (end of file, or a full disk).
+    template<typename VectorFunction>
+    static int64_t TransferVectored(FileHandle* handle, const FileIOBuffer* buffers, int32_t bufferCount, int64_t position, VectorFunction function, int *error)
+    {
+        struct iovec vectors[IOV_MAX < 64 ? IOV_MAX : 64];
+        const int32_t maxVectors = (int32_t)(sizeof(vectors) / sizeof(vectors[0]));
+
+        int64_t total = 0;
+
+        for (int32_t first = 0; first < bufferCount;)
+        {
+            const int32_t vectorCount = bufferCount - first < maxVectors ? bufferCount - first : maxVectors;
+            int64_t expected = 0;
+
+            for (int32_t i = 0; i < vectorCount; ++i)
+            {
+                vectors[i].iov_base = buffers[first + i].buffer;
+                vectors[i].iov_len = buffers[first + i].count;
+                expected += buffers[first + i].count;
+            }
+
+            ssize_t ret;
+
+            do
+            {
+                ret = function(handle->fd, vectors, vectorCount, (off_t)(position + total));
+            }
+            while (ret == -1 && errno == EINTR);
+
+            if (ret == -1)
+            {
+                *error = FileErrnoToErrorCode(errno);
+                return -1;
+            }
+
+            total += ret;
+            if (ret < expected)
+                break;
+
+            first += vectorCount;
+        }
+
+        return total;
+    }
+
+#endif
+
+    int64_t File::ReadScatter(FileHandle* handle, const FileIOBuffer* buffers, int32_t bufferCount, int64_t position, int *error)
+    {
+        if (handle == NULL || handle == INVALID_FILE_HANDLE)
+        {
+            *error = kErrorCodeInvalidHandle;
+            return -1;
+        }
+
+        if ((handle->accessMode & kFileAccessRead) == 0)
+        {
+            *error = kErrorCodeAccessDenied;
+            return -1;
+        }
+
+        *error = kErrorCodeSuccess;
+
+#if IL2CPP_HAVE_PREADV
+        return TransferVectored(handle, buffers, bufferCount, position, preadv, error);
+#else
+        int64_t total = 0;
+
+        for (int32_t i = 0; i < bufferCount; ++i)
+        {
+            const int ret = ReadAt(handle, buffers[i].buffer, buffers[i].count, position + total, error);
+            if (ret == 0 && *error != kErrorCodeSuccess)
+                return -1;
+
+            total += ret;
+            if (ret < buffers[i].count)
+                break;
+        }
+
+        return total;
+#endif
+    }
+
+    int64_t File::WriteGather(FileHandle* handle, const FileIOBuffer* buffers, int32_t bufferCount, int64_t position, int *error)
+    {
+        if (handle == NULL || handle == INVALID_FILE_HANDLE)
+        {
+            *error = kErrorCodeInvalidHandle;
+            return -1;
+        }
+
+        if ((handle->accessMode & kFileAccessWrite) == 0)
+        {
+            *error = kErrorCodeAccessDenied;
+            return -1;
+        }
+
+        *error = kErrorCodeSuccess;
+
+#if IL2CPP_HAVE_PREADV
+        return TransferVectored(handle, buffers, bufferCount, position, pwritev, error);
+#else
+        int64_t total = 0;
+
+        for (int32_t i = 0; i < bufferCount; ++i)
+        {
+            const int32_t ret = WriteAt(handle, buffers[i].buffer, buffers[i].count, position + total, error);
+            if (ret == -1)
+                return -1;
+
+            total += ret;
+            if (ret < buffers[i].count)
+                break;
+        }
+
+        return total;
+#endif
+    }
+
+    bool File::Advise(FileHandle* handle, int64_t position, int64_t length, FileAdvice advice, int *error)
+    {
+        if (handle == NULL || handle == INVALID_FILE_HANDLE)
+        {
+            *error = kErrorCodeInvalidHandle;
+            return false;
+        }
+
+        *error = kErrorCodeSuccess;
+
+#ifdef HAVE_POSIX_FADVISE
+        // Only regular files take hints, anything else just ignores them.
+        if (handle->type != kFileTypeDisk)
+            return true;
+
+        int posixAdvice;
+
+        switch (advice)
+        {
+            case kFileAdviceNormal:
+                posixAdvice = POSIX_FADV_NORMAL;
+                break;
+            case kFileAdviceSequential:
+                posixAdvice = POSIX_FADV_SEQUENTIAL;
+                break;
+            case kFileAdviceRandom:
+                posixAdvice = POSIX_FADV_RANDOM;
+                break;
+            case kFileAdviceWillNeed:
+                posixAdvice = POSIX_FADV_WILLNEED;
+                break;
+            case kFileAdviceDontNeed:
+                posixAdvice = POSIX_FADV_DONTNEED;
+                break;
+            default:
+            {
+                *error = kErrorCodeInvalidParameter;
+                return false;
+            }
+        }
+
+        // posix_fadvise returns the error instead of setting errno.
+        const int ret = posix_fadvise(handle->fd, (off_t)position, (off_t)length, posixAdvice);
+
+        if (ret != 0)
+        {
+            *error = FileErrnoToErrorCode(ret);
+            return false;
+        }
+#else
+        NO_UNUSED_WARNING(position);
+        NO_UNUSED_WARNING(length);
+        NO_UNUSED_WARNING(advice);
+#endif
+
+        return true;
+    }
+
     bool File::Flush(FileHandle* handle, int* error)
     {
         if (handle->type != kFileTypeDisk)
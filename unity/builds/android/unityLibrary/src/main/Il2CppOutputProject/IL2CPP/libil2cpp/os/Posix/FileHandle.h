@@ -29,17 +29,20 @@ namespace os
         // we want to support, so make sure the default is 0.
         bool doesNotOwnFd;
 
+        // Set for the inotify instances of the class libraries' file system watcher, see SystemNative_Read.
+        bool isNotifyInstance;
+
         // device and inode are used as key for finding file handles
         dev_t device;
         ino_t inode;
 
-        // Linked list of file handles
+        // Linked list of the file handles open on the same file
         FileHandle *prev;
         FileHandle *next;
 
         FileHandle()
             : fd(-1), type(kFileTypeUnknown), options(0), shareMode(0), accessMode(0),
-            doesNotOwnFd(false), device(0), inode(0), prev(NULL), next(NULL)
+            doesNotOwnFd(false), isNotifyInstance(false), device(0), inode(0), prev(NULL), next(NULL)
         {
         }
     };
@@ -4,6 +4,16 @@
 
 #include <cassert>
 #include "os/FileSystemWatcher.h"
+#include "os/ClassLibraryPAL/pal_platform.h"
+
+#if IL2CPP_HAVE_INOTIFY
+#include "utils/HashUtils.h"
+#include "utils/StringUtils.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
 
 namespace il2cpp
 {
@@ -11,10 +21,120 @@ namespace os
 {
 namespace FileSystemWatcher
 {
+    // Values of the watcher modes understood by System.IO.FileSystemWatcher
+    static const int kDefaultWatcher = 0;
+    static const int kCoreFXWatcher = 6;
+
+#if IL2CPP_HAVE_INOTIFY
+
+    int IsSupported()
+    {
+        const int fd = inotify_init();
+        if (fd == -1)
+            return kDefaultWatcher;
+
+        close(fd);
+        return kCoreFXWatcher;
+    }
+
+    static const uint32_t kChangeMask = IN_MODIFY | IN_ATTRIB;
+
+    // Records of one read are indexed by entry in a table on the stack. Reads of the class libraries are 16 KB, which
+    // holds at most 1024 records; past kMaxIndexedEvents the rest of a buffer is passed through as is.
+    static const int32_t kEventIndexSize = 4096;
+    static const int32_t kMaxIndexedEvents = kEventIndexSize / 2;
+
+    static inline const inotify_event* EventAt(const uint8_t* events, int32_t offset)
+    {
+        return reinterpret_cast<const inotify_event*>(events + offset);
+    }
+
+    static inline size_t HashEntry(const inotify_event* event)
+    {
+        const size_t nameHash = event->len == 0 ? 0 : utils::StringUtils::Hash(event->name);
+        return utils::HashUtils::Combine(static_cast<size_t>(event->wd), nameHash);
+    }
+
+    static inline bool IsSameEntry(const inotify_event* a, const inotify_event* b)
+    {
+        if (a->wd != b->wd)
+            return false;
+
+        if (a->len == 0 || b->len == 0)
+            return a->len == b->len;
+
+        return strcmp(a->name, b->name) == 0;
+    }
+
+    int32_t CoalesceEvents(uint8_t* events, int32_t length)
+    {
+        // Output offset + 1 of the last record kept for an entry, 0 for a free slot.
+        int32_t index[kEventIndexSize];
+        memset(index, 0, sizeof(index));
+
+        int32_t indexed = 0;
+        int32_t kept = 0;
+        int32_t offset = 0;
+
+        while (length - offset >= (int32_t)sizeof(inotify_event))
+        {
+            const inotify_event* event = EventAt(events, offset);
+            const int32_t eventSize = (int32_t)sizeof(inotify_event) + (int32_t)event->len;
+            if (eventSize > length - offset)
+                break;
+
+            bool drop = false;
+            int32_t* slot = NULL;
+
+            // Overflow notifications have no watch, and are always kept.
+            if (event->wd >= 0 && indexed < kMaxIndexedEvents)
+            {
+                size_t position = HashEntry(event) & (kEventIndexSize - 1);
+                while (index[position] != 0 && !IsSameEntry(EventAt(events, index[position] - 1), event))
+                    position = (position + 1) & (kEventIndexSize - 1);
+
+                slot = &index[position];
+                if (*slot != 0)
+                {
+                    const inotify_event* last = EventAt(events, *slot - 1);
+                    drop = (event->mask & ~IN_ISDIR & ~kChangeMask) == 0 && (last->mask & ~IN_ISDIR & ~kChangeMask) == 0;
+                }
+                else
+                {
+                    ++indexed;
+                }
+            }
+
+            if (!drop)
+            {
+                if (kept != offset)
+                    memmove(events + kept, events + offset, eventSize);
+
+                if (slot != NULL)
+                    *slot = kept + 1;
+
+                kept += eventSize;
+            }
+
+            offset += eventSize;
+        }
+
+        return kept;
+    }
+
+#else
+
     int IsSupported()
     {
-        return 0;
+        return kDefaultWatcher;
     }
+
+    int32_t CoalesceEvents(uint8_t* events, int32_t length)
+    {
+        return length;
+    }
+
+#endif
 }
 }
 }
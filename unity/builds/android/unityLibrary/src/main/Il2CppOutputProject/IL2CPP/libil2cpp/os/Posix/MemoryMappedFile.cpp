@@ -250,6 +250,11 @@ namespace os
     }
 
     MemoryMappedFile::MemoryMappedFileHandle MemoryMappedFile::View(FileHandle* mappedFileHandle, int64_t* length, int64_t offset, MemoryMappedFileAccess access, int64_t* actualOffset, MemoryMappedFileError* error)
+    {
+        return View(mappedFileHandle, length, offset, access, kMemoryMappedViewNone, actualOffset, error);
+    }
+
+    MemoryMappedFile::MemoryMappedFileHandle MemoryMappedFile::View(FileHandle* mappedFileHandle, int64_t* length, int64_t offset, MemoryMappedFileAccess access, int32_t viewOptions, int64_t* actualOffset, MemoryMappedFileError* error)
     {
         IL2CPP_ASSERT(actualOffset != NULL);
 
@@ -290,6 +295,10 @@ namespace os
             mflags |= MAP_FIXED;
         if (flags & MONO_MMAP_32BIT)
             mflags |= MAP_32BIT;
+#ifdef MAP_POPULATE
+        if (viewOptions & kMemoryMappedViewPopulate)
+            mflags |= MAP_POPULATE;
+#endif
 
         void* address = mmap(NULL, eff_size, prot, mflags, mappedFileHandle->fd, mmap_offset);
         if (address == MAP_FAILED)
@@ -299,9 +308,54 @@ namespace os
             return NULL;
         }
 
+#ifndef MAP_POPULATE
+        if (viewOptions & kMemoryMappedViewPopulate)
+            Advise(address, eff_size, kMemoryMappedAdviceWillNeed);
+#endif
+
         return address;
     }
 
+    bool MemoryMappedFile::Advise(void* address, int64_t length, MemoryMappedAdvice advice)
+    {
+        int posixAdvice;
+
+        switch (advice)
+        {
+            case kMemoryMappedAdviceNormal:
+                posixAdvice = MADV_NORMAL;
+                break;
+            case kMemoryMappedAdviceSequential:
+                posixAdvice = MADV_SEQUENTIAL;
+                break;
+            case kMemoryMappedAdviceRandom:
+                posixAdvice = MADV_RANDOM;
+                break;
+            case kMemoryMappedAdviceWillNeed:
+                posixAdvice = MADV_WILLNEED;
+                break;
+            case kMemoryMappedAdviceDontNeed:
+                posixAdvice = MADV_DONTNEED;
+                break;
+            case kMemoryMappedAdviceHugePage:
+#ifdef MADV_HUGEPAGE
+                posixAdvice = MADV_HUGEPAGE;
+                break;
+#else
+                return true;
+#endif
+            default:
+                IL2CPP_ASSERT(0 && "unknown MemoryMappedAdvice");
+                return false;
+        }
+
+        // madvise wants a page aligned start, callers pass whatever part of the view they care about.
+        const int64_t start = AlignDownToPageSize((int64_t)(intptr_t)address);
+        const int64_t end = (int64_t)(intptr_t)address + length;
+
+        return madvise((void*)(intptr_t)start, (size_t)(end - start), posixAdvice) == 0;
+    }
+
     void MemoryMappedFile::Flush(MemoryMappedFileHandle memoryMappedFileData, int64_t length)
     {
         if (memoryMappedFileData != NULL)
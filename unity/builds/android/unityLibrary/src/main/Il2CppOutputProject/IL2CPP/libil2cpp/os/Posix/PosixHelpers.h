@@ -7,6 +7,7 @@
 #include <sys/poll.h>
 #include "os/Thread.h"
 #include "os/Socket.h"
+#include "os/c-api/OSGlobalEnums.h"
 
 namespace il2cpp
 {
@@ -58,6 +59,10 @@ namespace posix
     }
 
     int Poll(pollfd* handles, int numHandles, int timeout);
+
+    // Same attributes as File::GetFileAttributes, but for an entry of an already opened directory,
+    // so the kernel does not have to resolve the full path again. Returns an os::ErrorCode.
+    int GetFileAttributesAt(int directoryFd, const char* name, UnityPalFileAttributes* attributes);
 }
 }
 }
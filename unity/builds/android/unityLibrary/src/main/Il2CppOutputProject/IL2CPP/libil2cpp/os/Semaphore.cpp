@@ -1,4 +1,4 @@
-#include "os/c-api/il2cpp-config-platforms.h"
+#include "il2cpp-config.h"
 #include "os/Semaphore.h"
 
 #if IL2CPP_SUPPORT_THREADS
@@ -43,6 +43,15 @@ namespace os
     {
         return m_Semaphore->GetOSHandle();
     }
+
+    WaitObject* Semaphore::GetWaitObject()
+    {
+#if IL2CPP_HAS_WAIT_OBJECTS
+        return m_Semaphore;
+#else
+        return NULL;
+#endif
+    }
 }
 }
 
@@ -79,6 +88,11 @@ namespace os
     {
         return NULL;
     }
+
+    WaitObject* Semaphore::GetWaitObject()
+    {
+        return NULL;
+    }
 }
 }
 
@@ -21,6 +21,7 @@ namespace os
         WaitStatus Wait(bool interruptible = false);
         WaitStatus Wait(uint32_t ms, bool interruptible = false);
         void* GetOSHandle();
+        WaitObject* GetWaitObject();
 
     private:
         SemaphoreImpl* m_Semaphore;
@@ -37,6 +38,7 @@ namespace os
         virtual WaitStatus Wait(uint32_t ms, bool interruptible) { return m_Semaphore->Wait(ms, interruptible); }
         virtual void Signal() { m_Semaphore->Post(1, NULL); }
         virtual void* GetOSHandle() { return m_Semaphore->GetOSHandle(); }
+        virtual WaitObject* GetWaitObject() { return m_Semaphore->GetWaitObject(); }
         Semaphore& Get() { return *m_Semaphore; }
 
     private:
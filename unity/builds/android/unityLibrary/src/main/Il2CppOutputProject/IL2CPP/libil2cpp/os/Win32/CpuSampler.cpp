@@ -0,0 +1,53 @@
+#include "il2cpp-config.h"
+
+#if IL2CPP_TARGET_WINDOWS
+
+#include "os/CpuSampler.h"
+#include "os/ErrorCodes.h"
+
+namespace il2cpp
+{
+namespace os
+{
+    // There is no timer signal to sample from on Windows; a sampler would have to suspend threads instead.
+    bool CpuSampler::IsSupported()
+    {
+        return false;
+    }
+
+    bool CpuSampler::Start(uint32_t intervalMicroseconds, int* error)
+    {
+        *error = kErrorNotSupported;
+        return false;
+    }
+
+    void CpuSampler::Stop()
+    {
+    }
+
+    bool CpuSampler::ReadSample(CpuSample* sample)
+    {
+        return false;
+    }
+
+    uint32_t CpuSampler::GetDroppedSampleCount()
+    {
+        return 0;
+    }
+
+    uint32_t CpuSampler::GetUnsampledThreadCount()
+    {
+        return 0;
+    }
+
+    void CpuSampler::RegisterCurrentThread()
+    {
+    }
+
+    void CpuSampler::UnregisterCurrentThread()
+    {
+    }
+}
+}
+
+#endif
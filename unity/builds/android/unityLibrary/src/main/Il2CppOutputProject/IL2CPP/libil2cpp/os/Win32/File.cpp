@@ -539,6 +539,129 @@ namespace os
         return written;
     }
 
+    static inline OVERLAPPED MakeOverlapped(int64_t position)
+    {
+        OVERLAPPED overlapped = {0};
+        overlapped.Offset = (DWORD)(position & 0xFFFFFFFF);
+        overlapped.OffsetHigh = (DWORD)(position >> 32);
+        return overlapped;
+    }
+
+    // Waits for the transfer if the handle was opened for asynchronous I/O. Synchronous handles complete in place,
+    // and also have their position moved past the transfer, which Windows gives us no way to avoid.
+    static bool CompleteOverlapped(FileHandle* handle, BOOL success, OVERLAPPED* overlapped, DWORD* transferred, int *error)
+    {
+        if (!success)
+        {
+            DWORD lastError = ::GetLastError();
+            if (lastError == ERROR_HANDLE_EOF)
+            {
+                *transferred = 0;
+                return true;
+            }
+
+            if (lastError != ERROR_IO_PENDING)
+            {
+                *error = FileWin32ErrorToErrorCode(lastError);
+                return false;
+            }
+
+#if IL2CPP_TARGET_WINDOWS_DESKTOP
+            if (::GetOverlappedResult((HANDLE)handle, overlapped, transferred, TRUE) == 0)
+#else
+            if (::GetOverlappedResultEx((HANDLE)handle, overlapped, transferred, INFINITE, FALSE) == 0)
+#endif
+            {
+                lastError = ::GetLastError();
+                if (lastError == ERROR_HANDLE_EOF)
+                {
+                    *transferred = 0;
+                    return true;
+                }
+
+                *error = FileWin32ErrorToErrorCode(lastError);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    int File::ReadAt(FileHandle* handle, char *dest, int count, int64_t position, int *error)
+    {
+        *error = kErrorCodeSuccess;
+        OVERLAPPED overlapped = MakeOverlapped(position);
+        DWORD bytesRead = 0;
+        BOOL success = ::ReadFile((HANDLE)handle, dest, count, &bytesRead, &overlapped);
+
+        if (!CompleteOverlapped(handle, success, &overlapped, &bytesRead, error))
+            return 0;
+
+        return bytesRead;
+    }
+
+    int32_t File::WriteAt(FileHandle* handle, const char* buffer, int count, int64_t position, int *error)
+    {
+        *error = kErrorCodeSuccess;
+        OVERLAPPED overlapped = MakeOverlapped(position);
+        DWORD written = 0;
+        BOOL success = ::WriteFile((HANDLE)handle, buffer, count, &written, &overlapped);
+
+        if (!CompleteOverlapped(handle, success, &overlapped, &written, error))
+            return -1;
+
+        return written;
+    }
+
+    // ReadFileScatter and WriteFileGather want unbuffered handles and page sized buffers, so transfer one buffer at a time.
+    int64_t File::ReadScatter(FileHandle* handle, const FileIOBuffer* buffers, int32_t bufferCount, int64_t position, int *error)
+    {
+        int64_t total = 0;
+
+        for (int32_t i = 0; i < bufferCount; ++i)
+        {
+            const int ret = ReadAt(handle, buffers[i].buffer, buffers[i].count, position + total, error);
+            if (*error != kErrorCodeSuccess)
+                return -1;
+
+            total += ret;
+            if (ret < buffers[i].count)
+                break;
+        }
+
+        return total;
+    }
+
+    int64_t File::WriteGather(FileHandle* handle, const FileIOBuffer* buffers, int32_t bufferCount, int64_t position, int *error)
+    {
+        int64_t total = 0;
+
+        for (int32_t i = 0; i < bufferCount; ++i)
+        {
+            const int32_t ret = WriteAt(handle, buffers[i].buffer, buffers[i].count, position + total, error);
+            if (ret == -1)
+                return -1;
+
+            total += ret;
+            if (ret < buffers[i].count)
+                break;
+        }
+
+        return total;
+    }
+
+    bool File::Advise(FileHandle* handle, int64_t position, int64_t length, FileAdvice advice, int *error)
+    {
+        // Windows only takes access pattern hints when the file is opened, see the FileOptions handling in Open.
+        NO_UNUSED_WARNING(handle);
+        NO_UNUSED_WARNING(position);
+        NO_UNUSED_WARNING(length);
+        NO_UNUSED_WARNING(advice);
+
+        *error = kErrorCodeSuccess;
+        return true;
+    }
+
     bool File::Flush(FileHandle* handle, int* error)
     {
         *error = kErrorCodeSuccess;
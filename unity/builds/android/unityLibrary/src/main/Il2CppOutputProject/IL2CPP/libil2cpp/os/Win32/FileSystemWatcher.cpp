@@ -15,6 +15,11 @@ namespace FileSystemWatcher
     {
         return 1;
     }
+
+    int32_t CoalesceEvents(uint8_t* events, int32_t length)
+    {
+        return length;
+    }
 }
 }
 }
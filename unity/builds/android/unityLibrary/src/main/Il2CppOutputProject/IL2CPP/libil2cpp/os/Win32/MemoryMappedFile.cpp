@@ -270,6 +270,17 @@ namespace os
         return address;
     }
 
+    MemoryMappedFile::MemoryMappedFileHandle MemoryMappedFile::View(FileHandle* mappedFileHandle, int64_t* length, int64_t offset, MemoryMappedFileAccess access, int32_t viewOptions, int64_t* actualOffset, MemoryMappedFileError* error)
+    {
+        // There is no MAP_POPULATE on Windows, the pages of the view fault in as they are touched.
+        return View(mappedFileHandle, length, offset, access, actualOffset, error);
+    }
+
+    bool MemoryMappedFile::Advise(void* address, int64_t length, MemoryMappedAdvice advice)
+    {
+        return true;
+    }
+
     void MemoryMappedFile::Flush(MemoryMappedFileHandle memoryMappedFileData, int64_t length)
     {
         BOOL success = FlushViewOfFile(memoryMappedFileData, (SIZE_T)length);
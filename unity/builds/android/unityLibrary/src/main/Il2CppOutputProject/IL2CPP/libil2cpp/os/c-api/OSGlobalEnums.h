@@ -75,3 +75,13 @@ typedef enum
     kFileSeekOriginCurrent = 1,
     kFileSeekOriginEnd = 2
 } SeekOrigin;
+
+// Access pattern hints for a range of an open file, see File::Advise.
+typedef enum
+{
+    kFileAdviceNormal = 0,
+    kFileAdviceSequential = 1,
+    kFileAdviceRandom = 2,
+    kFileAdviceWillNeed = 3,
+    kFileAdviceDontNeed = 4
+} FileAdvice;
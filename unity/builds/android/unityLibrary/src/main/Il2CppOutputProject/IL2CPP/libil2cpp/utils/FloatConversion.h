@@ -0,0 +1,37 @@
+#pragma once
+
+#include "il2cpp-config.h"
+#include <stdint.h>
+
+namespace il2cpp
+{
+namespace utils
+{
+// Conversions between binary floating point values and their decimal text, without going through the C library
+// and its locale. Formatting finds the shortest digits that parse back to the same value (Schubfach), parsing
+// rounds correctly to the nearest value (Eisel-Lemire, with strtod for the rare inputs it cannot decide).
+namespace FloatConversion
+{
+    // Longest text FormatRoundTrip writes, e.g. "-2.2250738585072014E-308". There is no terminator.
+    const int32_t kMaxRoundTripLength = 24;
+
+    // value == significand * 10^exponent, with as few digits in significand as possible and no trailing zeros.
+    // value must be finite and greater than zero.
+    void ShortestDecimal(double value, uint64_t* significand, int32_t* exponent);
+    void ShortestDecimal(float value, uint64_t* significand, int32_t* exponent);
+
+    // Writes value the way the "R" format of .NET does in the invariant culture: the shortest digits, in scientific
+    // notation when the exponent is below -4 or above 14 (6 for floats). Returns the number of characters written.
+    int32_t FormatRoundTrip(double value, char* buffer);
+    int32_t FormatRoundTrip(float value, char* buffer);
+
+    // Parses [+|-]digits[.digits][(e|E)[+|-]digits] from the start of chars, where either the integer or the
+    // fraction digits may be left out. Returns the number of characters that make up the number, 0 when chars does not start
+    // with one. Values out of range become zero or infinity.
+    int32_t Parse(const char* chars, int32_t length, double* value);
+    int32_t Parse(const char* chars, int32_t length, float* value);
+    int32_t Parse(const Il2CppChar* chars, int32_t length, double* value);
+    int32_t Parse(const Il2CppChar* chars, int32_t length, float* value);
+} /* namespace FloatConversion */
+} /* namespace utils */
+} /* namespace il2cpp */
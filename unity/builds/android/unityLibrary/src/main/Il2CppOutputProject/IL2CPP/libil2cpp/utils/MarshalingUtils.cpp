@@ -1,5 +1,9 @@
 #include "MarshalingUtils.h"
 #include "il2cpp-pinvoke-support.h"
+#include "il2cpp-class-internals.h"
+#include "os/Atomic.h"
+#include "utils/Memory.h"
+#include "vm/Class.h"
 
 namespace il2cpp
 {
@@ -43,6 +47,46 @@ namespace utils
 
         cleanup(marshaledStructure);
         return true;
+#endif
+    }
+
+    const Il2CppMarshalDescriptor* MarshalingUtils::CreateMarshalDescriptor(Il2CppClass* klass)
+    {
+#if RUNTIME_TINY
+        IL2CPP_ASSERT(0 && "Not supported with the Tiny runtime");
+        return NULL;
+#else
+        Il2CppMarshalDescriptor* newDescriptor = (Il2CppMarshalDescriptor*)IL2CPP_CALLOC(1, sizeof(Il2CppMarshalDescriptor));
+
+        if (klass->interopData != NULL)
+        {
+            newDescriptor->marshalToNativeFunction = klass->interopData->pinvokeMarshalToNativeFunction;
+            newDescriptor->marshalFromNativeFunction = klass->interopData->pinvokeMarshalFromNativeFunction;
+            newDescriptor->marshalCleanupFunction = klass->interopData->pinvokeMarshalCleanupFunction;
+        }
+
+        // Types without marshal functions but with a native size are copied as they are. Enums and strings
+        // have a native size too, but can't be marshaled as structures. PtrToStructure turns void away itself.
+        const Il2CppTypeEnum type = klass->byval_arg.type;
+        newDescriptor->nativeSize = klass->native_size;
+        newDescriptor->isBlittable = newDescriptor->marshalToNativeFunction == NULL && newDescriptor->marshalFromNativeFunction == NULL
+            && klass->native_size != -1 && !klass->enumtype && type != IL2CPP_TYPE_STRING;
+
+        if (type == IL2CPP_TYPE_CLASS && vm::Class::HasDefaultConstructor(klass))
+        {
+            newDescriptor->hasDefaultConstructor = true;
+            newDescriptor->defaultConstructor = vm::Class::GetMethodFromName(klass, ".ctor", 0)->virtualMethodPointer;
+        }
+
+        // Another thread may have built one in the meantime, they are identical so keep whichever got there first.
+        const Il2CppMarshalDescriptor* descriptor = os::Atomic::CompareExchangePointer(&klass->marshalDescriptor, (const Il2CppMarshalDescriptor*)newDescriptor, (const Il2CppMarshalDescriptor*)NULL);
+        if (descriptor != NULL)
+        {
+            IL2CPP_FREE(newDescriptor);
+            return descriptor;
+        }
+
+        return newDescriptor;
 #endif
     }
 } // namespace utils
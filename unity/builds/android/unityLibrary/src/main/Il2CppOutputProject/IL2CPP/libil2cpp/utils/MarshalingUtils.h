@@ -1,8 +1,11 @@
 #pragma once
 
 #include "il2cpp-config.h"
+#include "il2cpp-class-internals.h"
+#include "os/Atomic.h"
 
 struct Il2CppInteropData;
+struct Il2CppMarshalDescriptor;
 
 namespace il2cpp
 {
@@ -14,6 +17,19 @@ namespace utils
         static void MarshalStructToNative(void* managedStructure, void* marshaledStructure, const Il2CppInteropData* interopData);
         static void MarshalStructFromNative(void* marshaledStructure, void* managedStructure, const Il2CppInteropData* interopData);
         static bool MarshalFreeStruct(void* marshaledStructure, const Il2CppInteropData* interopData);
+
+        // Built the first time a type is marshaled and kept on the class afterwards.
+        static inline const Il2CppMarshalDescriptor* GetMarshalDescriptor(Il2CppClass* klass)
+        {
+            const Il2CppMarshalDescriptor* descriptor = os::Atomic::LoadPointerAcquire(&klass->marshalDescriptor);
+            if (descriptor != NULL)
+                return descriptor;
+
+            return CreateMarshalDescriptor(klass);
+        }
+
+    private:
+        static const Il2CppMarshalDescriptor* CreateMarshalDescriptor(Il2CppClass* klass);
     };
 } // namespace utils
 } // namespace il2cpp
@@ -15,6 +15,15 @@ namespace utils
     static std::map<void*, os::FileHandle*> s_MappedAddressToMappedFileObject;
     static std::map<void*, int64_t> s_MappedAddressToMappedLength;
 
+    struct SharedView
+    {
+        void* address;
+        int32_t refCount;
+    };
+
+    static std::map<std::string, SharedView> s_SharedViews;
+    static std::map<void*, std::string> s_SharedViewAddressToPath;
+
     void* MemoryMappedFile::Map(os::FileHandle* file)
     {
         return Map(file, 0, 0);
@@ -31,6 +40,11 @@ namespace utils
     }
 
     void* MemoryMappedFile::Map(os::FileHandle* file, int64_t length, int64_t offset, int32_t access)
+    {
+        return Map(file, length, offset, access, os::kMemoryMappedViewNone);
+    }
+
+    void* MemoryMappedFile::Map(os::FileHandle* file, int64_t length, int64_t offset, int32_t access, int32_t viewOptions)
     {
         os::FastAutoLock lock(&s_Mutex);
 
@@ -41,7 +55,7 @@ namespace utils
             return NULL;
 
         int64_t actualOffset = offset;
-        void* address = os::MemoryMappedFile::View(mappedFileHandle, &length, offset, (os::MemoryMappedFileAccess)access, &actualOffset, &error);
+        void* address = os::MemoryMappedFile::View(mappedFileHandle, &length, offset, (os::MemoryMappedFileAccess)access, viewOptions, &actualOffset, &error);
 
         if (address != NULL)
         {
@@ -54,10 +68,58 @@ namespace utils
         return address;
     }
 
+    void* MemoryMappedFile::MapShared(const std::string& path, int32_t viewOptions)
+    {
+        os::FastAutoLock lock(&s_Mutex);
+
+        std::map<std::string, SharedView>::iterator entry = s_SharedViews.find(path);
+        if (entry != s_SharedViews.end())
+        {
+            entry->second.refCount++;
+            return entry->second.address;
+        }
+
+        int error = 0;
+        os::FileHandle* handle = os::File::Open(path, kFileModeOpen, kFileAccessRead, kFileShareRead, kFileOptionsNone, &error);
+        if (error != 0)
+            return NULL;
+
+        void* address = Map(handle, 0, 0, os::MMAP_FILE_ACCESS_READ, viewOptions);
+
+        os::File::Close(handle, &error);
+        if (address == NULL)
+            return NULL;
+
+        if (error != 0)
+        {
+            Unmap(address);
+            return NULL;
+        }
+
+        SharedView view = { address, 1 };
+        s_SharedViews[path] = view;
+        s_SharedViewAddressToPath[address] = path;
+
+        return address;
+    }
+
     bool MemoryMappedFile::Unmap(void* address, int64_t length)
     {
         os::FastAutoLock lock(&s_Mutex);
 
+        std::map<void*, std::string>::iterator sharedEntry = s_SharedViewAddressToPath.find(address);
+        if (sharedEntry != s_SharedViewAddressToPath.end())
+        {
+            std::map<std::string, SharedView>::iterator view = s_SharedViews.find(sharedEntry->second);
+            IL2CPP_ASSERT(view != s_SharedViews.end());
+
+            if (--view->second.refCount > 0)
+                return true;
+
+            s_SharedViews.erase(view);
+            s_SharedViewAddressToPath.erase(sharedEntry);
+        }
+
         if (length == 0)
         {
             std::map<void*, int64_t>::iterator entry = s_MappedAddressToMappedLength.find(address);
@@ -82,6 +144,87 @@ namespace utils
 
         return true;
     }
+
+    bool MemoryMappedFile::Advise(void* address, int64_t length, os::MemoryMappedAdvice advice)
+    {
+        if (length == 0)
+        {
+            os::FastAutoLock lock(&s_Mutex);
+
+            std::map<void*, int64_t>::iterator entry = s_MappedAddressToMappedLength.find(address);
+            if (entry == s_MappedAddressToMappedLength.end())
+                return false;
+
+            length = entry->second;
+        }
+
+        return os::MemoryMappedFile::Advise(address, length, advice);
+    }
+
+    MemoryMappedFileWindow::MemoryMappedFileWindow(os::FileHandle* file, int64_t windowSize)
+        : m_MappedFileHandle(NULL), m_FileSize(0), m_WindowSize(windowSize), m_View(NULL), m_ViewOffset(0), m_ViewEnd(0)
+    {
+        int error = 0;
+        m_FileSize = os::File::GetLength(file, &error);
+        if (error != 0)
+            return;
+
+        int64_t unused = 0;
+        os::MemoryMappedFileError mapError = os::NO_MEMORY_MAPPED_FILE_ERROR;
+        os::FileHandle* mappedFileHandle = os::MemoryMappedFile::Create(file, NULL, 0, &unused, os::MMAP_FILE_ACCESS_READ, 0, &mapError);
+        if (mapError == os::NO_MEMORY_MAPPED_FILE_ERROR)
+            m_MappedFileHandle = mappedFileHandle;
+    }
+
+    MemoryMappedFileWindow::~MemoryMappedFileWindow()
+    {
+        UnmapWindow();
+
+        if (m_MappedFileHandle != NULL && os::MemoryMappedFile::OwnsDuplicatedFileHandle(m_MappedFileHandle))
+            os::MemoryMappedFile::Close(m_MappedFileHandle);
+    }
+
+    const void* MemoryMappedFileWindow::Map(int64_t offset, int64_t length)
+    {
+        if (m_MappedFileHandle == NULL || offset < 0 || length < 0 || offset + length > m_FileSize)
+            return NULL;
+
+        if (m_View == NULL || offset < m_ViewOffset || offset + length > m_ViewEnd)
+        {
+            UnmapWindow();
+
+            // Map the window forward from the requested range, as readers mostly move through files front to back.
+            int64_t viewLength = length > m_WindowSize ? length : m_WindowSize;
+            if (viewLength > m_FileSize - offset)
+                viewLength = m_FileSize - offset;
+
+            if (viewLength == 0)
+                return NULL;
+
+            const int64_t viewEnd = offset + viewLength;
+            int64_t actualOffset = offset;
+            os::MemoryMappedFileError error = os::NO_MEMORY_MAPPED_FILE_ERROR;
+            void* view = os::MemoryMappedFile::View(m_MappedFileHandle, &viewLength, offset, os::MMAP_FILE_ACCESS_READ, &actualOffset, &error);
+            if (view == NULL)
+                return NULL;
+
+            // The view starts at the mapping granularity boundary below offset.
+            m_View = view;
+            m_ViewOffset = actualOffset;
+            m_ViewEnd = viewEnd;
+        }
+
+        return (const uint8_t*)m_View + (offset - m_ViewOffset);
+    }
+
+    void MemoryMappedFileWindow::UnmapWindow()
+    {
+        if (m_View == NULL)
+            return;
+
+        os::MemoryMappedFile::UnmapView(m_View, m_ViewEnd - m_ViewOffset);
+        m_View = NULL;
+    }
 }
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <string>
 #include "os/File.h"
 #include "os/Mutex.h"
 #include "os/MemoryMappedFile.h"
@@ -15,8 +16,37 @@ namespace utils
         static void* Map(os::FileHandle* file);
         static void* Map(os::FileHandle* file, int64_t length, int64_t offset);
         static void* Map(os::FileHandle* file, int64_t length, int64_t offset, int32_t access);
+        static void* Map(os::FileHandle* file, int64_t length, int64_t offset, int32_t access, int32_t viewOptions);
+        // Maps all of the file at path for reading. Everyone mapping the same path gets the same view back,
+        // which Unmap only unmaps once the last of them is done with it.
+        static void* MapShared(const std::string& path, int32_t viewOptions);
         static bool Unmap(void* address);
         static bool Unmap(void* address, int64_t length);
+        // A length of 0 means the rest of the view that address is the start of.
+        static bool Advise(void* address, int64_t length, os::MemoryMappedAdvice advice);
+    };
+
+    // Keeps at most one window of a file mapped for reading, and moves it whenever a range outside of it is asked for.
+    // This is for files that are too big to map in full, e.g. in a 32 bit address space.
+    class MemoryMappedFileWindow
+    {
+    public:
+        MemoryMappedFileWindow(os::FileHandle* file, int64_t windowSize);
+        ~MemoryMappedFileWindow();
+
+        // Returns [offset, offset + length) of the file, or NULL when that is not all in the file. The pointer is
+        // valid until the next call.
+        const void* Map(int64_t offset, int64_t length);
+
+    private:
+        void UnmapWindow();
+
+        os::FileHandle* m_MappedFileHandle;
+        int64_t m_FileSize;
+        int64_t m_WindowSize;
+        void* m_View;
+        int64_t m_ViewOffset;
+        int64_t m_ViewEnd;
     };
 }
 }
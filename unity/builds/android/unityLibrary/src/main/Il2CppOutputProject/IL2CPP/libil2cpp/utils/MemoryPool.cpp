@@ -1,4 +1,5 @@
 #include "il2cpp-config.h"
+#include "il2cpp-runtime-stats.h"
 #include "utils/MemoryPool.h"
 #include "utils/Memory.h"
 #include <algorithm>
@@ -13,54 +14,95 @@ namespace utils
 // by making all allocations a multiple of this value, we ensure the next
 // allocation will always be aligned to this value
     const size_t kMemoryAlignment = 8;
+// small enough that threads which only inflate a few generics before they
+// exit do not hold on to much memory
+    const size_t kThreadChunkSize = 4 * 1024;
+// anything bigger than this would waste too much of a thread chunk, and is
+// claimed from the shared region directly
+    const size_t kMaxChunkAllocationSize = kThreadChunkSize / 4;
+// anything bigger than this gets a region of its own
+    const size_t kMaxSharedAllocationSize = kDefaultRegionSize / 4;
 
     static inline size_t MakeMultipleOf(size_t size, size_t alignment)
     {
         return (size + alignment - 1) & ~(alignment - 1);
     }
 
+    // Header at the start of every block we get from the system allocator, the memory handed out follows it.
     struct MemoryPool::Region
+    {
+        Region* next;
+        size_t size;
+        // May run past the end of the region, when threads race for its last bytes.
+        baselib::atomic<size_t> used;
+
+        char* Start() { return reinterpret_cast<char*>(this) + MakeMultipleOf(sizeof(Region), kMemoryAlignment); }
+        size_t Capacity() const { return size - MakeMultipleOf(sizeof(Region), kMemoryAlignment); }
+    };
+
+    // Only ever touched by the thread it belongs to.
+    struct MemoryPool::ThreadChunk
     {
         char* start;
         char* current;
-        size_t size;
-        size_t free;
+        char* end;
     };
 
-    MemoryPool::MemoryPool()
+    MemoryPool::MemoryPool(Il2CppMemoryPoolStats* stats)
+        : m_Stats(stats)
     {
-        AddRegion(kDefaultRegionSize);
+        m_Regions = NULL;
+        m_CurrentRegion = AddRegion(CreateRegion(kDefaultRegionSize));
     }
 
-    MemoryPool::MemoryPool(size_t initialSize)
+    MemoryPool::MemoryPool(size_t initialSize, Il2CppMemoryPoolStats* stats)
+        : m_Stats(stats)
     {
-        AddRegion(initialSize);
+        m_Regions = NULL;
+        m_CurrentRegion = AddRegion(CreateRegion(std::max(kDefaultRegionSize, MakeMultipleOf(initialSize, kPageSize))));
     }
 
     MemoryPool::~MemoryPool()
     {
-        for (RegionList::iterator iter = m_Regions.begin(); iter != m_Regions.end(); ++iter)
+        // The thread chunks live in the regions, so they go away with them.
+        for (Region* region = m_Regions.exchange(NULL); region != NULL;)
         {
-            IL2CPP_FREE((*iter)->start);
-            IL2CPP_FREE(*iter);
+            Region* next = region->next;
+            IL2CPP_FREE(region);
+            region = next;
         }
 
-        m_Regions.clear();
+        m_CurrentRegion = NULL;
+        m_ThreadChunk.SetValue(NULL);
     }
 
     void* MemoryPool::Malloc(size_t size)
     {
         size = MakeMultipleOf(size, kMemoryAlignment);
 
-        Region* region = m_Regions.back();
-        if (region->free < size)
-            region = AddRegion(size);
+        if (size > kMaxChunkAllocationSize)
+        {
+            if (m_Stats != NULL)
+                m_Stats->used_size += size;
 
-        IL2CPP_ASSERT(region->free >= size);
+            if (size > kMaxSharedAllocationSize)
+                return AddRegion(CreateRegion(MakeMultipleOf(sizeof(Region), kMemoryAlignment) + size))->Start();
 
-        void* value = region->current;
-        region->current += size;
-        region->free -= size;
+            return AllocateShared(size);
+        }
+
+        ThreadChunk* chunk = GetThreadChunk();
+        if (static_cast<size_t>(chunk->end - chunk->current) < size)
+        {
+            if (m_Stats != NULL)
+                m_Stats->used_size += chunk->current - chunk->start;
+
+            chunk->start = chunk->current = static_cast<char*>(AllocateShared(kThreadChunkSize));
+            chunk->end = chunk->start + kThreadChunkSize;
+        }
+
+        void* value = chunk->current;
+        chunk->current += size;
 
         return value;
     }
@@ -71,30 +113,69 @@ namespace utils
         return memset(ret, 0, count * size);
     }
 
-    MemoryPool::Region* MemoryPool::AddRegion(size_t size)
+    MemoryPool::Region* MemoryPool::CreateRegion(size_t allocationSize)
     {
-        Region* newRegion = (Region*)IL2CPP_MALLOC(sizeof(Region));
-        Region* lastFreeRegion = m_Regions.size() > 0 ? m_Regions.back() : NULL;
-        size_t allocationSize;
+        Region* newRegion = (Region*)IL2CPP_MALLOC(allocationSize);
+        newRegion->size = allocationSize;
+        newRegion->used = 0;
+        return newRegion;
+    }
 
-        if (lastFreeRegion != NULL && lastFreeRegion->free >= kPageSize)
+    MemoryPool::Region* MemoryPool::AddRegion(Region* newRegion)
+    {
+        Region* head = m_Regions.load(baselib::memory_order_relaxed);
+        do
         {
-            allocationSize = MakeMultipleOf(size, kPageSize);
-
-            m_Regions.pop_back();
-            m_Regions.push_back(newRegion);
-            m_Regions.push_back(lastFreeRegion);
+            newRegion->next = head;
         }
-        else
+        while (!m_Regions.compare_exchange_weak(head, newRegion, baselib::memory_order_release, baselib::memory_order_relaxed));
+
+        if (m_Stats != NULL)
+            m_Stats->reserved_size += newRegion->size;
+
+        return newRegion;
+    }
+
+    void* MemoryPool::AllocateShared(size_t size)
+    {
+        IL2CPP_ASSERT(size <= kMaxSharedAllocationSize);
+
+        Region* region = m_CurrentRegion.load(baselib::memory_order_acquire);
+
+        for (;;)
         {
-            allocationSize = std::max(kDefaultRegionSize, MakeMultipleOf(size, kPageSize));
-            m_Regions.push_back(newRegion);
+            const size_t offset = region->used.fetch_add(size, baselib::memory_order_relaxed);
+            if (offset + size <= region->Capacity())
+                return region->Start() + offset;
+
+            // The region is full. Whichever thread gets here first replaces it, the others use the new one.
+            Region* newRegion = CreateRegion(kDefaultRegionSize);
+            if (m_CurrentRegion.compare_exchange_strong(region, newRegion, baselib::memory_order_acq_rel, baselib::memory_order_acquire))
+            {
+                AddRegion(newRegion);
+                region = newRegion;
+            }
+            else
+            {
+                IL2CPP_FREE(newRegion);
+            }
         }
+    }
 
-        newRegion->start = newRegion->current = (char*)IL2CPP_MALLOC(allocationSize);
-        newRegion->size = newRegion->free = allocationSize;
+    MemoryPool::ThreadChunk* MemoryPool::GetThreadChunk()
+    {
+        ThreadChunk* chunk;
+        m_ThreadChunk.GetValue(reinterpret_cast<void**>(&chunk));
 
-        return newRegion;
+        if (chunk != NULL)
+            return chunk;
+
+        // An empty chunk, the first allocation of the thread fills it.
+        chunk = static_cast<ThreadChunk*>(AllocateShared(MakeMultipleOf(sizeof(ThreadChunk), kMemoryAlignment)));
+        chunk->start = chunk->current = chunk->end = NULL;
+
+        m_ThreadChunk.SetValue(chunk);
+        return chunk;
     }
 }
 }
@@ -1,26 +1,40 @@
 #pragma once
 
-#include <list>
+#include "os/ThreadLocalValue.h"
+
+#include "Baselib.h"
+#include "Cpp/Atomic.h"
+
+struct Il2CppMemoryPoolStats;
 
 namespace il2cpp
 {
 namespace utils
 {
+    // Bump allocator whose memory is only released when the pool is destroyed. It can be used from
+    // any number of threads without a lock: each thread carves its allocations out of a small chunk
+    // of its own, and chunks are claimed from a shared region with a single atomic add.
     class MemoryPool
     {
     public:
-        MemoryPool();
-        MemoryPool(size_t initialSize);
+        MemoryPool(Il2CppMemoryPoolStats* stats = NULL);
+        MemoryPool(size_t initialSize, Il2CppMemoryPoolStats* stats = NULL);
         ~MemoryPool();
         void* Malloc(size_t size);
         void* Calloc(size_t count, size_t size);
     private:
         struct Region;
-        typedef std::list<Region*> RegionList;
+        struct ThreadChunk;
 
-        Region* AddRegion(size_t size);
+        Region* CreateRegion(size_t allocationSize);
+        Region* AddRegion(Region* region);
+        void* AllocateShared(size_t size);
+        ThreadChunk* GetThreadChunk();
 
-        RegionList m_Regions;
+        os::ThreadLocalValue m_ThreadChunk;
+        baselib::atomic<Region*> m_Regions;
+        baselib::atomic<Region*> m_CurrentRegion;
+        Il2CppMemoryPoolStats* m_Stats;
     };
 } /* namespace utils */
 } /* namespace il2cpp */
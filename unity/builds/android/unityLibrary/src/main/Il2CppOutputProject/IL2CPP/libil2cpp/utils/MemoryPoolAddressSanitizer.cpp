@@ -2,17 +2,21 @@
 
 #if IL2CPP_SANITIZE_ADDRESS
 
+#include "il2cpp-runtime-stats.h"
+#include "os/Mutex.h"
 #include "utils/MemoryPoolAddressSanitizer.h"
 
 namespace il2cpp
 {
 namespace utils
 {
-    MemoryPoolAddressSanitizer::MemoryPoolAddressSanitizer()
+    MemoryPoolAddressSanitizer::MemoryPoolAddressSanitizer(Il2CppMemoryPoolStats* stats)
+        : m_Stats(stats)
     {
     }
 
-    MemoryPoolAddressSanitizer::MemoryPoolAddressSanitizer(size_t initialSize)
+    MemoryPoolAddressSanitizer::MemoryPoolAddressSanitizer(size_t initialSize, Il2CppMemoryPoolStats* stats)
+        : m_Stats(stats)
     {
     }
 
@@ -27,16 +31,28 @@ namespace utils
     void* MemoryPoolAddressSanitizer::Malloc(size_t size)
     {
         void* allocation = malloc(size);
-        m_Allocations.push_back(allocation);
+        AddAllocation(allocation, size);
         return allocation;
     }
 
     void* MemoryPoolAddressSanitizer::Calloc(size_t count, size_t size)
     {
         void* allocation = calloc(count, size);
-        m_Allocations.push_back(allocation);
+        AddAllocation(allocation, count * size);
         return allocation;
     }
+
+    void MemoryPoolAddressSanitizer::AddAllocation(void* allocation, size_t size)
+    {
+        os::FastAutoLock lock(&m_Lock);
+        m_Allocations.push_back(allocation);
+
+        if (m_Stats != NULL)
+        {
+            m_Stats->reserved_size += size;
+            m_Stats->used_size += size;
+        }
+    }
 }
 }
 
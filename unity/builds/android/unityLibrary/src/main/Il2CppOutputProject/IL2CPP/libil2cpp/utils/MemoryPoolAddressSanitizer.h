@@ -5,8 +5,13 @@
 #error MemoryPoolAddressSanitizer should only be used when the address sanitizer is enabled
 #endif
 
+#include "Baselib.h"
+#include "Cpp/ReentrantLock.h"
+
 #include <vector>
 
+struct Il2CppMemoryPoolStats;
+
 namespace il2cpp
 {
 namespace utils
@@ -17,13 +22,17 @@ namespace utils
     class MemoryPoolAddressSanitizer
     {
     public:
-        MemoryPoolAddressSanitizer();
-        MemoryPoolAddressSanitizer(size_t initialSize);
+        MemoryPoolAddressSanitizer(Il2CppMemoryPoolStats* stats = NULL);
+        MemoryPoolAddressSanitizer(size_t initialSize, Il2CppMemoryPoolStats* stats = NULL);
         ~MemoryPoolAddressSanitizer();
         void* Malloc(size_t size);
         void* Calloc(size_t count, size_t size);
     private:
+        void AddAllocation(void* allocation, size_t size);
+
+        baselib::ReentrantLock m_Lock;
         std::vector<void*> m_Allocations;
+        Il2CppMemoryPoolStats* m_Stats;
     };
 } /* namespace utils */
 } /* namespace il2cpp */
@@ -4,9 +4,15 @@
 #include "utils/Functional.h"
 #include "utils/Memory.h"
 #include "utils/StringUtils.h"
+#include "utils/Utf16Simd.h"
+#include "utils/utf8-cpp/source/utf8/core.h"
 #include "utils/utf8-cpp/source/utf8/unchecked.h"
+#include <string.h>
 #include <stdarg.h>
 
+#include "Baselib.h"
+#include "Cpp/Algorithm.h"
+
 namespace il2cpp
 {
 namespace utils
@@ -147,6 +153,217 @@ namespace utils
         return Utf8ToUtf16(utf8String.c_str(), utf8String.length());
     }
 
+    static inline bool IsLeadSurrogate(Il2CppChar c) { return (c & 0xFC00) == 0xD800; }
+    static inline bool IsTrailSurrogate(Il2CppChar c) { return (c & 0xFC00) == 0xDC00; }
+
+    // Bytes needed for the code point starting at utf16String[pos], and how many code units it takes.
+    static inline size_t Utf8SequenceLength(const Il2CppChar* utf16String, size_t pos, size_t length, size_t* units)
+    {
+        const Il2CppChar c = utf16String[pos];
+        *units = 1;
+
+        if (c < 0x80)
+            return 1;
+        if (c < 0x800)
+            return 2;
+        if (IsLeadSurrogate(c) && pos + 1 < length && IsTrailSurrogate(utf16String[pos + 1]))
+        {
+            *units = 2;
+            return 4;
+        }
+
+        return 3;
+    }
+
+    static inline size_t WriteUtf8Sequence(const Il2CppChar* utf16String, size_t pos, size_t length, char* destination, size_t* units)
+    {
+        uint32_t cp = utf16String[pos];
+        *units = 1;
+
+        if (cp < 0x80)
+        {
+            destination[0] = (char)cp;
+            return 1;
+        }
+
+        if (cp < 0x800)
+        {
+            destination[0] = (char)(0xC0 | (cp >> 6));
+            destination[1] = (char)(0x80 | (cp & 0x3F));
+            return 2;
+        }
+
+        if (IsLeadSurrogate((Il2CppChar)cp) && pos + 1 < length && IsTrailSurrogate(utf16String[pos + 1]))
+        {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (utf16String[pos + 1] - 0xDC00);
+            destination[0] = (char)(0xF0 | (cp >> 18));
+            destination[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+            destination[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+            destination[3] = (char)(0x80 | (cp & 0x3F));
+            *units = 2;
+            return 4;
+        }
+
+        destination[0] = (char)(0xE0 | (cp >> 12));
+        destination[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        destination[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+
+    size_t StringUtils::Utf16ToUtf8Length(const Il2CppChar* utf16String, size_t length)
+    {
+        size_t bytes = 0;
+        size_t pos = 0;
+        size_t units;
+
+#if IL2CPP_UTF16_SIMD
+        using namespace Utf16Simd;
+
+        // Without surrogates every code unit takes one byte, plus one from 0x80 and another from 0x800 up.
+        while (pos + kCharsPerVector <= length)
+        {
+            const CharVector c = LoadChars(utf16String + pos);
+
+            if (LanesMatching(c, 0xF800, 0xD800) == 0)
+            {
+                bytes += kCharsPerVector;
+                bytes += baselib::Algorithm::BitsInMask(~LanesMatching(c, 0xFF80, 0) & kAllLanes);
+                bytes += baselib::Algorithm::BitsInMask(~LanesMatching(c, 0xF800, 0) & kAllLanes);
+                pos += kCharsPerVector;
+                continue;
+            }
+
+            // A pair can straddle the end of the block, so this may finish one code unit past it.
+            for (const size_t blockEnd = pos + kCharsPerVector; pos < blockEnd; pos += units)
+                bytes += Utf8SequenceLength(utf16String, pos, length, &units);
+        }
+#endif
+
+        for (; pos < length; pos += units)
+            bytes += Utf8SequenceLength(utf16String, pos, length, &units);
+
+        return bytes;
+    }
+
+    size_t StringUtils::Utf16ToUtf8(const Il2CppChar* utf16String, size_t length, char* destination)
+    {
+        char* current = destination;
+        size_t pos = 0;
+        size_t units;
+
+#if IL2CPP_UTF16_SIMD
+        using namespace Utf16Simd;
+
+        while (pos + kCharsPerVector <= length)
+        {
+            const CharVector c = LoadChars(utf16String + pos);
+
+            if (IsAscii(c))
+            {
+                StoreAscii(current, c);
+                current += kCharsPerVector;
+                pos += kCharsPerVector;
+                continue;
+            }
+
+            for (const size_t blockEnd = pos + kCharsPerVector; pos < blockEnd; pos += units)
+                current += WriteUtf8Sequence(utf16String, pos, length, current, &units);
+        }
+#endif
+
+        for (; pos < length; pos += units)
+            current += WriteUtf8Sequence(utf16String, pos, length, current, &units);
+
+        return current - destination;
+    }
+
+    static inline bool IsAsciiWord(const char* utf8String)
+    {
+        uint64_t word;
+        memcpy(&word, utf8String, sizeof(word));
+        return (word & 0x8080808080808080ULL) == 0;
+    }
+
+    size_t StringUtils::Utf8ToUtf16Length(const char* utf8String, size_t length)
+    {
+        // Every byte that is not a continuation byte starts a code point, and those from four byte sequences
+        // need a surrogate pair.
+        size_t units = 0;
+        size_t i = 0;
+
+        while (i + sizeof(uint64_t) <= length && IsAsciiWord(utf8String + i))
+        {
+            units += sizeof(uint64_t);
+            i += sizeof(uint64_t);
+        }
+
+        for (; i < length; i++)
+        {
+            const uint8_t byte = (uint8_t)utf8String[i];
+            units += (byte & 0xC0) != 0x80;
+            units += byte >= 0xF0;
+        }
+
+        return units;
+    }
+
+    size_t StringUtils::Utf8ToUtf16(const char* utf8String, size_t length, Il2CppChar* destination)
+    {
+        const char* current = utf8String;
+        const char* const end = utf8String + length;
+        Il2CppChar* written = destination;
+
+        // Runs of ASCII are widened eight bytes at a time, anything else a code point at a time.
+        while (current != end)
+        {
+            if (end - current >= (ptrdiff_t)sizeof(uint64_t) && IsAsciiWord(current))
+            {
+                for (size_t i = 0; i < sizeof(uint64_t); i++)
+                    written[i] = (uint8_t)current[i];
+                written += sizeof(uint64_t);
+                current += sizeof(uint64_t);
+                continue;
+            }
+
+            if ((uint8_t)*current < 0x80)
+            {
+                *written++ = (uint8_t)*current++;
+                continue;
+            }
+
+            const uint32_t codePoint = utf8::unchecked::next(current);
+            if (codePoint > 0xFFFF)
+            {
+                *written++ = (Il2CppChar)((codePoint >> 10) + 0xD7C0);
+                *written++ = (Il2CppChar)((codePoint & 0x3FF) + 0xDC00);
+            }
+            else
+            {
+                *written++ = (Il2CppChar)codePoint;
+            }
+        }
+
+        return written - destination;
+    }
+
+    bool StringUtils::IsValidUtf8(const char* utf8String, size_t length)
+    {
+        const char* current = utf8String;
+        const char* const end = utf8String + length;
+
+        while (current != end)
+        {
+            if (end - current >= (ptrdiff_t)sizeof(uint64_t) && IsAsciiWord(current))
+                current += sizeof(uint64_t);
+            else if ((uint8_t)*current < 0x80)
+                current++;
+            else if (utf8::internal::validate_next(current, end) != utf8::internal::UTF8_OK)
+                return false;
+        }
+
+        return true;
+    }
+
     char* StringUtils::StringDuplicate(const char *strSource)
     {
         char* result = NULL;
@@ -46,6 +46,14 @@ namespace utils
         static UTF16String Utf8ToUtf16(const char* utf8String);
         static UTF16String Utf8ToUtf16(const char* utf8String, size_t length);
         static UTF16String Utf8ToUtf16(const std::string& utf8String);
+        // Conversions into caller provided buffers, sized with the matching *Length function first. Neither
+        // null terminates. A lone surrogate is written as the three byte sequence for its code unit.
+        static size_t Utf16ToUtf8Length(const Il2CppChar* utf16String, size_t length);
+        static size_t Utf16ToUtf8(const Il2CppChar* utf16String, size_t length, char* destination);
+        // Only for valid UTF-8, see IsValidUtf8.
+        static size_t Utf8ToUtf16Length(const char* utf8String, size_t length);
+        static size_t Utf8ToUtf16(const char* utf8String, size_t length, Il2CppChar* destination);
+        static bool IsValidUtf8(const char* utf8String, size_t length);
         static char* StringDuplicate(const char *strSource);
         static Il2CppChar* StringDuplicate(const Il2CppChar* strSource, size_t length);
         static bool EndsWith(const std::string& string, const std::string& suffix);
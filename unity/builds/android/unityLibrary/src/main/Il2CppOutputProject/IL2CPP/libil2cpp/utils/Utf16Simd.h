@@ -0,0 +1,108 @@
+#pragma once
+
+#include "il2cpp-config.h"
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IL2CPP_UTF16_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define IL2CPP_UTF16_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if IL2CPP_UTF16_SIMD_SSE2 || IL2CPP_UTF16_SIMD_NEON
+#define IL2CPP_UTF16_SIMD 1
+#endif
+
+#if IL2CPP_UTF16_SIMD
+
+namespace il2cpp
+{
+namespace utils
+{
+// Operations on eight UTF-16 code units at a time. Comparisons produce a vector of all ones or all zeros lanes,
+// LaneMask turns that into a mask with bit i set when lane i is all ones.
+namespace Utf16Simd
+{
+    const int32_t kCharsPerVector = 8;
+    const uint32_t kAllLanes = (1 << kCharsPerVector) - 1;
+
+#if IL2CPP_UTF16_SIMD_SSE2
+    typedef __m128i CharVector;
+
+    inline CharVector LoadChars(const Il2CppChar* chars) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars)); }
+    inline CharVector SplatChar(Il2CppChar c) { return _mm_set1_epi16((short)c); }
+    inline CharVector EqualChars(CharVector a, CharVector b) { return _mm_cmpeq_epi16(a, b); }
+    inline CharVector AndChars(CharVector a, CharVector b) { return _mm_and_si128(a, b); }
+    inline CharVector OrChars(CharVector a, CharVector b) { return _mm_or_si128(a, b); }
+
+    inline uint32_t LaneMask(CharVector lanes)
+    {
+        return (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(lanes, _mm_setzero_si128()));
+    }
+
+    // Only valid on ASCII lanes, which keeps the signed compares safe.
+    inline CharVector ToLowerAscii(CharVector c)
+    {
+        const __m128i upper = _mm_and_si128(_mm_cmpgt_epi16(c, _mm_set1_epi16('A' - 1)), _mm_cmplt_epi16(c, _mm_set1_epi16('Z' + 1)));
+        return _mm_add_epi16(c, _mm_and_si128(upper, _mm_set1_epi16(0x20)));
+    }
+
+    // Only valid on ASCII lanes.
+    inline void StoreAscii(char* destination, CharVector c)
+    {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(destination), _mm_packus_epi16(c, c));
+    }
+
+#else
+    typedef uint16x8_t CharVector;
+
+    inline CharVector LoadChars(const Il2CppChar* chars) { return vld1q_u16(reinterpret_cast<const uint16_t*>(chars)); }
+    inline CharVector SplatChar(Il2CppChar c) { return vdupq_n_u16((uint16_t)c); }
+    inline CharVector EqualChars(CharVector a, CharVector b) { return vceqq_u16(a, b); }
+    inline CharVector AndChars(CharVector a, CharVector b) { return vandq_u16(a, b); }
+    inline CharVector OrChars(CharVector a, CharVector b) { return vorrq_u16(a, b); }
+
+    inline uint32_t LaneMask(CharVector lanes)
+    {
+        static const uint8_t kLaneBits[8] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+        uint8x8_t bits = vand_u8(vmovn_u16(lanes), vld1_u8(kLaneBits));
+#if defined(__aarch64__) || defined(_M_ARM64)
+        return vaddv_u8(bits);
+#else
+        bits = vpadd_u8(bits, bits);
+        bits = vpadd_u8(bits, bits);
+        bits = vpadd_u8(bits, bits);
+        return vget_lane_u8(bits, 0);
+#endif
+    }
+
+    inline CharVector ToLowerAscii(CharVector c)
+    {
+        const uint16x8_t upper = vcltq_u16(vsubq_u16(c, vdupq_n_u16('A')), vdupq_n_u16(26));
+        return vaddq_u16(c, vandq_u16(upper, vdupq_n_u16(0x20)));
+    }
+
+    inline void StoreAscii(char* destination, CharVector c)
+    {
+        vst1_u8(reinterpret_cast<uint8_t*>(destination), vmovn_u16(c));
+    }
+
+#endif
+
+    // Lanes where (c & bits) == value.
+    inline uint32_t LanesMatching(CharVector c, Il2CppChar bits, Il2CppChar value)
+    {
+        return LaneMask(EqualChars(AndChars(c, SplatChar(bits)), SplatChar(value)));
+    }
+
+    inline bool IsAscii(CharVector c)
+    {
+        return LanesMatching(c, 0xFF80, 0) == kAllLanes;
+    }
+} /* namespace Utf16Simd */
+} /* namespace utils */
+} /* namespace il2cpp */
+
+#endif
@@ -3,6 +3,7 @@
 #include "os/File.h"
 #include "os/Image.h"
 #include "os/Path.h"
+#include "utils/CallOnce.h"
 #include "utils/Logging.h"
 #include "utils/Memory.h"
 #include "utils/MemoryMappedFile.h"
@@ -66,7 +67,7 @@ namespace utils
 
     // Do a binary search to find the line with the given address
     // This is looking for the line with the closest address without going over (price is right style)
-    usymliteLine FindLine(uint64_t address)
+    static uint32_t FindLineIndexBinarySearch(uint64_t address)
     {
         uint32_t head = 0;
         uint32_t tail = s_usym.header.lineCount - 1;
@@ -94,7 +95,126 @@ namespace utils
             head += 1;
         }
 
-        return s_usym.lines[head];
+        return head;
+    }
+
+#if defined(__GNUC__) || defined(__clang__)
+#define IL2CPP_PREFETCH_LINE_INDEX(address) __builtin_prefetch(address)
+#else
+#define IL2CPP_PREFETCH_LINE_INDEX(address)
+#endif
+
+    // The line records are 24 bytes each and spread over the whole mapped file, so a binary search
+    // misses the cache on nearly every step. Instead we search a copy of just the distinct addresses,
+    // stored as 32 bit offsets from the first one, in Eytzinger order (the implicit binary tree of a
+    // heap: the children of node k are 2k and 2k + 1). The first levels of the tree share cache
+    // lines, and the 16 possible nodes four levels down are contiguous and can be prefetched.
+    struct LineIndex
+    {
+        uint32_t count;              // distinct addresses
+        uint32_t* addressOffsets;    // 1-based, Eytzinger order
+        uint32_t* previousLines;     // for each node, the last line of the next lower distinct address
+        uint32_t lastLine;
+        bool built;
+    };
+
+    static LineIndex s_LineIndex;
+    static OnceFlag s_LineIndexOnceFlag;
+
+    static uint32_t FillLineIndex(const uint32_t* sortedOffsets, const uint32_t* sortedPreviousLines, uint32_t sortedPosition, uint32_t node)
+    {
+        if (node <= s_LineIndex.count)
+        {
+            sortedPosition = FillLineIndex(sortedOffsets, sortedPreviousLines, sortedPosition, 2 * node);
+            s_LineIndex.addressOffsets[node] = sortedOffsets[sortedPosition];
+            s_LineIndex.previousLines[node] = sortedPreviousLines[sortedPosition];
+            sortedPosition++;
+            sortedPosition = FillLineIndex(sortedOffsets, sortedPreviousLines, sortedPosition, 2 * node + 1);
+        }
+
+        return sortedPosition;
+    }
+
+    static void BuildLineIndex(void* arg)
+    {
+        const uint32_t lineCount = s_usym.header.lineCount;
+
+        // Offsets have to fit in 32 bits, otherwise we keep searching the records directly.
+        if (s_usym.lastLineAddress - s_usym.firstLineAddress > UINT32_MAX)
+            return;
+
+        uint32_t count = 1;
+        for (uint32_t i = 1; i < lineCount; ++i)
+        {
+            if (s_usym.lines[i].address != s_usym.lines[i - 1].address)
+                count++;
+        }
+
+        uint32_t* sortedOffsets = (uint32_t*)IL2CPP_MALLOC(count * sizeof(uint32_t));
+        uint32_t* sortedPreviousLines = (uint32_t*)IL2CPP_MALLOC(count * sizeof(uint32_t));
+        s_LineIndex.addressOffsets = (uint32_t*)IL2CPP_MALLOC((count + 1) * sizeof(uint32_t));
+        s_LineIndex.previousLines = (uint32_t*)IL2CPP_MALLOC((count + 1) * sizeof(uint32_t));
+
+        uint32_t position = 0;
+        sortedOffsets[0] = 0;
+        sortedPreviousLines[0] = noLine;
+        for (uint32_t i = 1; i < lineCount; ++i)
+        {
+            if (s_usym.lines[i].address != s_usym.lines[i - 1].address)
+            {
+                position++;
+                sortedOffsets[position] = (uint32_t)(s_usym.lines[i].address - s_usym.firstLineAddress);
+                sortedPreviousLines[position] = i - 1;
+            }
+        }
+
+        s_LineIndex.count = count;
+        s_LineIndex.addressOffsets[0] = 0;
+        s_LineIndex.previousLines[0] = noLine;
+        s_LineIndex.lastLine = lineCount - 1;
+        FillLineIndex(sortedOffsets, sortedPreviousLines, 0, 1);
+
+        IL2CPP_FREE(sortedOffsets);
+        IL2CPP_FREE(sortedPreviousLines);
+
+        s_LineIndex.built = true;
+    }
+
+    static uint32_t FindLineIndex(uint64_t address)
+    {
+        // Find the first distinct address above the one we look for: the line we want is the last one
+        // before it. The caller made sure the address is within [firstLineAddress, lastLineAddress].
+        const uint32_t offset = (uint32_t)(address - s_usym.firstLineAddress);
+        const uint32_t* offsets = s_LineIndex.addressOffsets;
+        const uint32_t count = s_LineIndex.count;
+
+        uint32_t node = 1;
+        while (node <= count)
+        {
+            IL2CPP_PREFETCH_LINE_INDEX(offsets + 16 * node);
+            node = 2 * node + (offsets[node] <= offset ? 1 : 0);
+        }
+
+        // Going down, we turned right at every node up to the answer, and then left once at the answer
+        // itself. Undo those right turns and that left turn.
+        while (node & 1)
+            node >>= 1;
+        node >>= 1;
+
+        if (node == 0)
+            return s_LineIndex.lastLine;
+
+        return s_LineIndex.previousLines[node];
+    }
+
+    usymliteLine FindLine(uint64_t address)
+    {
+        CallOnce(s_LineIndexOnceFlag, BuildLineIndex, NULL);
+
+        if (!s_LineIndex.built)
+            return s_usym.lines[FindLineIndexBinarySearch(address)];
+
+        return s_usym.lines[FindLineIndex(address)];
     }
 
     const char* GetString(uint32_t index)
@@ -43,6 +43,25 @@
 #include <algorithm>
 #include <limits>
 #include <stdarg.h>
+#include <vector>
+
+#if IL2CPP_ENABLE_METHOD_NAME_INDEX
+// Open addressing table from a method name to the run of entries with that name. A run lists the methods in the
+// order a search of the class visits them: those of the class itself first, then those of each parent in turn.
+struct Il2CppMethodNameIndex
+{
+    struct Bucket
+    {
+        uint32_t hash;
+        uint32_t start;
+        uint32_t count; // 0 for an empty bucket
+    };
+
+    uint32_t bucketMask;
+    Bucket* buckets;
+    const MethodInfo** entries;
+};
+#endif
 
 namespace il2cpp
 {
@@ -161,38 +180,42 @@ namespace vm
 
     static void SetupInterfacesLocked(Il2CppClass* klass, const il2cpp::os::FastAutoLock& lock)
     {
+        if (klass->implementedInterfaces != NULL)
+            return;
+
         if (klass->generic_class)
         {
             Il2CppClass* genericTypeDefinition = GenericClass::GetTypeDefinition(klass->generic_class);
             Il2CppGenericContext* context = &klass->generic_class->context;
 
-            if (genericTypeDefinition->interfaces_count > 0 && klass->implementedInterfaces == NULL)
+            if (genericTypeDefinition->interfaces_count > 0)
             {
                 IL2CPP_ASSERT(genericTypeDefinition->interfaces_count == klass->interfaces_count);
-                klass->implementedInterfaces = (Il2CppClass**)MetadataCalloc(genericTypeDefinition->interfaces_count, sizeof(Il2CppClass*));
+                Il2CppClass** interfaces = (Il2CppClass**)MetadataCalloc(genericTypeDefinition->interfaces_count, sizeof(Il2CppClass*));
                 for (uint16_t i = 0; i < genericTypeDefinition->interfaces_count; i++)
-                    klass->implementedInterfaces[i] = Class::FromIl2CppType(il2cpp::metadata::GenericMetadata::InflateIfNeeded(MetadataCache::GetInterfaceFromOffset(genericTypeDefinition, i), context, false));
+                    interfaces[i] = Class::FromIl2CppType(il2cpp::metadata::GenericMetadata::InflateIfNeeded(MetadataCache::GetInterfaceFromOffset(genericTypeDefinition, i), context, false));
+                PublishMetadata(klass->implementedInterfaces, interfaces);
             }
         }
         else if (klass->rank > 0)
         {
-            if (klass->implementedInterfaces == NULL)
-                il2cpp::metadata::ArrayMetadata::SetupArrayInterfaces(klass, lock);
+            il2cpp::metadata::ArrayMetadata::SetupArrayInterfaces(klass, lock);
         }
         else
         {
-            if (klass->interfaces_count > 0 && klass->implementedInterfaces == NULL)
+            if (klass->interfaces_count > 0)
             {
-                klass->implementedInterfaces = (Il2CppClass**)MetadataCalloc(klass->interfaces_count, sizeof(Il2CppClass*));
+                Il2CppClass** interfaces = (Il2CppClass**)MetadataCalloc(klass->interfaces_count, sizeof(Il2CppClass*));
                 for (uint16_t i = 0; i < klass->interfaces_count; i++)
-                    klass->implementedInterfaces[i] = Class::FromIl2CppType(MetadataCache::GetInterfaceFromOffset(klass, i));
+                    interfaces[i] = Class::FromIl2CppType(MetadataCache::GetInterfaceFromOffset(klass, i));
+                PublishMetadata(klass->implementedInterfaces, interfaces);
             }
         }
 
         if (klass->implementedInterfaces == NULL)
         {
             IL2CPP_ASSERT(klass->interfaces_count == 0);
-            klass->implementedInterfaces = s_EmptyClassList;
+            PublishMetadata(klass->implementedInterfaces, (Il2CppClass**)s_EmptyClassList);
         }
     }
 
@@ -389,7 +412,7 @@ namespace vm
                 return NULL;
 
             *iter = &klass->methods[0];
-            return klass->methods[0];
+            return GetMethodAt(klass, 0);
         }
 
         const MethodInfo** methodAddress = (const MethodInfo**)*iter;
@@ -397,7 +420,7 @@ namespace vm
         if (methodAddress < &klass->methods[klass->method_count])
         {
             *iter = methodAddress;
-            return *methodAddress;
+            return GetMethodAt(klass, static_cast<uint16_t>(methodAddress - klass->methods));
         }
 
         return NULL;
@@ -413,32 +436,33 @@ namespace vm
         return GetMethodFromNameFlagsAndSig(klass, name, argsCount, flags, NULL);
     }
 
-    const MethodInfo* Class::GetMethodFromNameFlagsAndSig(Il2CppClass *klass, const char* name, int argsCount, int32_t flags, const Il2CppType** argTypes)
+    // Everything but the name, which the callers have already matched.
+    static bool MethodMatchesSignature(const MethodInfo* method, int argsCount, int32_t flags, const Il2CppType** argTypes)
     {
-        Class::Init(klass);
+        if ((argsCount != Class::IgnoreNumberOfArguments && method->parameters_count != argsCount) || (method->flags & flags) != flags)
+            return false;
+
+        if (argTypes != NULL && argsCount != Class::IgnoreNumberOfArguments)
+        {
+            for (int i = 0; i < argsCount; i++)
+            {
+                if (!metadata::Il2CppTypeEqualityComparer::AreEqual(method->parameters[i], argTypes[i]))
+                    return false;
+            }
+        }
+
+        return true;
+    }
 
+    static const MethodInfo* FindMethodFromNameFlagsAndSig(Il2CppClass *klass, const char* name, int argsCount, int32_t flags, const Il2CppType** argTypes)
+    {
         while (klass != NULL)
         {
             void* iter = NULL;
             while (const MethodInfo* method = Class::GetMethods(klass, &iter))
             {
-                if (method->name[0] == name[0] &&
-                    (argsCount == IgnoreNumberOfArguments || method->parameters_count == argsCount) &&
-                    ((method->flags & flags) == flags) &&
-                    !strcmp(name, method->name))
-                {
-                    bool allArgTypeMatch = true;
-                    if (argTypes != NULL && argsCount != IgnoreNumberOfArguments)
-                    {
-                        for (int i = 0; allArgTypeMatch && i < argsCount; i++)
-                        {
-                            allArgTypeMatch = metadata::Il2CppTypeEqualityComparer::AreEqual(method->parameters[i], argTypes[i]);
-                        }
-                    }
-
-                    if (allArgTypeMatch)
-                        return method;
-                }
+                if (method->name[0] == name[0] && !strcmp(name, method->name) && MethodMatchesSignature(method, argsCount, flags, argTypes))
+                    return method;
             }
 
             klass = klass->parent;
@@ -447,12 +471,174 @@ namespace vm
         return NULL;
     }
 
+#if IL2CPP_ENABLE_METHOD_NAME_INDEX
+    // Below this many methods in a class and its parents the scan is faster than hashing the name, and an
+    // index would only cost memory.
+    static const uint32_t kMethodNameIndexMinMethods = 64;
+
+    static bool ShouldIndexMethodNames(const Il2CppClass* klass)
+    {
+        uint32_t methodCount = 0;
+        for (const Il2CppClass* current = klass; current != NULL; current = current->parent)
+            methodCount += current->method_count;
+
+        return methodCount >= kMethodNameIndexMinMethods;
+    }
+
+    static const Il2CppMethodNameIndex* BuildMethodNameIndex(Il2CppClass* klass)
+    {
+        std::vector<const MethodInfo*> methods;
+        for (Il2CppClass* current = klass; current != NULL; current = current->parent)
+        {
+            void* iter = NULL;
+            while (const MethodInfo* method = Class::GetMethods(current, &iter))
+                methods.push_back(method);
+        }
+
+        // Group the methods by name in a scratch table with room for every method, remembering which group each
+        // one belongs to. Until the runs are laid out, the start of a group is the position of its first method.
+        uint32_t scratchBucketCount = 4;
+        while (scratchBucketCount < methods.size() * 2)
+            scratchBucketCount *= 2;
+
+        std::vector<Il2CppMethodNameIndex::Bucket> scratchBuckets(scratchBucketCount);
+        std::vector<uint32_t> methodBuckets(methods.size());
+        uint32_t nameCount = 0;
+        for (uint32_t i = 0; i < methods.size(); i++)
+        {
+            const uint32_t hash = (uint32_t)utils::StringUtils::Hash(methods[i]->name);
+            uint32_t bucketIndex = hash & (scratchBucketCount - 1);
+            for (;;)
+            {
+                Il2CppMethodNameIndex::Bucket& bucket = scratchBuckets[bucketIndex];
+                if (bucket.count == 0)
+                {
+                    bucket.hash = hash;
+                    bucket.start = i;
+                    nameCount++;
+                    break;
+                }
+
+                if (bucket.hash == hash && strcmp(methods[bucket.start]->name, methods[i]->name) == 0)
+                    break;
+
+                bucketIndex = (bucketIndex + 1) & (scratchBucketCount - 1);
+            }
+
+            scratchBuckets[bucketIndex].count++;
+            methodBuckets[i] = bucketIndex;
+        }
+
+        // Inherited methods repeat many names, so the index is sized by the names rather than the methods.
+        uint32_t bucketCount = 4;
+        while (bucketCount < nameCount + nameCount / 2)
+            bucketCount *= 2;
+
+        const size_t bucketsOffset = sizeof(Il2CppMethodNameIndex);
+        const size_t entriesOffset = bucketsOffset + bucketCount * sizeof(Il2CppMethodNameIndex::Bucket);
+        char* memory = (char*)MetadataCalloc(1, entriesOffset + methods.size() * sizeof(MethodInfo*));
+
+        Il2CppMethodNameIndex* index = (Il2CppMethodNameIndex*)memory;
+        index->bucketMask = bucketCount - 1;
+        index->buckets = (Il2CppMethodNameIndex::Bucket*)(memory + bucketsOffset);
+        index->entries = (const MethodInfo**)(memory + entriesOffset);
+
+        std::vector<uint32_t> scratchToBucket(scratchBucketCount);
+        for (uint32_t i = 0; i < scratchBucketCount; i++)
+        {
+            if (scratchBuckets[i].count == 0)
+                continue;
+
+            uint32_t bucketIndex = scratchBuckets[i].hash & index->bucketMask;
+            while (index->buckets[bucketIndex].count != 0)
+                bucketIndex = (bucketIndex + 1) & index->bucketMask;
+
+            index->buckets[bucketIndex] = scratchBuckets[i];
+            scratchToBucket[i] = bucketIndex;
+        }
+
+        uint32_t start = 0;
+        for (uint32_t i = 0; i < bucketCount; i++)
+        {
+            index->buckets[i].start = start;
+            start += index->buckets[i].count;
+        }
+
+        // Filling the runs in search order keeps the first match the same as walking the class and its parents.
+        std::vector<uint32_t> filled(bucketCount);
+        for (uint32_t i = 0; i < methods.size(); i++)
+        {
+            const uint32_t bucketIndex = scratchToBucket[methodBuckets[i]];
+            index->entries[index->buckets[bucketIndex].start + filled[bucketIndex]++] = methods[i];
+        }
+
+        return index;
+    }
+
+    static const Il2CppMethodNameIndex* GetMethodNameIndex(Il2CppClass* klass)
+    {
+        const Il2CppMethodNameIndex* index = LoadPublishedMetadata(klass->methodNameIndex);
+        if (index != NULL)
+            return index;
+
+        il2cpp::os::FastAutoLock lock(&g_MetadataLock);
+        if (klass->methodNameIndex == NULL)
+            PublishMetadata(klass->methodNameIndex, BuildMethodNameIndex(klass));
+
+        return klass->methodNameIndex;
+    }
+
+    static const MethodInfo* FindIndexedMethodFromNameFlagsAndSig(Il2CppClass *klass, const char* name, int argsCount, int32_t flags, const Il2CppType** argTypes)
+    {
+        const Il2CppMethodNameIndex* index = GetMethodNameIndex(klass);
+        const uint32_t hash = (uint32_t)utils::StringUtils::Hash(name);
+        for (uint32_t bucketIndex = hash & index->bucketMask;; bucketIndex = (bucketIndex + 1) & index->bucketMask)
+        {
+            const Il2CppMethodNameIndex::Bucket& bucket = index->buckets[bucketIndex];
+            if (bucket.count == 0)
+                return NULL;
+
+            if (bucket.hash == hash && !strcmp(name, index->entries[bucket.start]->name))
+            {
+                for (uint32_t i = bucket.start; i < bucket.start + bucket.count; i++)
+                {
+                    if (MethodMatchesSignature(index->entries[i], argsCount, flags, argTypes))
+                        return index->entries[i];
+                }
+
+                return NULL;
+            }
+        }
+    }
+
+#endif
+
+    const MethodInfo* Class::GetMethodFromNameFlagsAndSig(Il2CppClass *klass, const char* name, int argsCount, int32_t flags, const Il2CppType** argTypes)
+    {
+        Class::Init(klass);
+
+#if IL2CPP_ENABLE_METHOD_NAME_INDEX
+        if (ShouldIndexMethodNames(klass))
+            return FindIndexedMethodFromNameFlagsAndSig(klass, name, argsCount, flags, argTypes);
+#endif
+
+        return FindMethodFromNameFlagsAndSig(klass, name, argsCount, flags, argTypes);
+    }
+
     const MethodInfo* Class::GetGenericInstanceMethodFromDefintion(Il2CppClass* genericInstanceClass, const MethodInfo* methodDefinition)
     {
         IL2CPP_ASSERT(Class::IsInflated(genericInstanceClass));
         IL2CPP_ASSERT(metadata::Il2CppTypeEqualityComparer::AreEqual(genericInstanceClass->generic_class->type, &methodDefinition->klass->byval_arg));
 
+#if IL2CPP_ENABLE_LAZY_METHOD_INFOS
+        // Method definitions are created one at a time, so their position has to be looked up
+        Il2CppClass* definitionClass = methodDefinition->klass;
+        ptrdiff_t index = 0;
+        while (index < definitionClass->method_count && definitionClass->methods[index] != methodDefinition)
+            index++;
+#else
         ptrdiff_t index = methodDefinition - methodDefinition->klass->methods[0];
+#endif
 
         IL2CPP_ASSERT(index >= 0 && index < methodDefinition->klass->method_count);
         IL2CPP_ASSERT(index < genericInstanceClass->method_count);
@@ -884,6 +1070,51 @@ namespace vm
         return instanceSize;
     }
 
+    // Each thread gets a single block for the thread static fields of a class. Describe where the
+    // references are in it, so that only those words are scanned.
+    static void* MakeThreadStaticGCDescriptorLocked(Il2CppClass* klass, const il2cpp::os::FastAutoLock& lock)
+    {
+        const size_t kBitsPerWord = 8 * sizeof(size_t);
+        std::vector<size_t> bitmap(1 + klass->thread_static_fields_size / sizeof(void*) / kBitsPerWord);
+        size_t maxSetBit = 0;
+        bool hasReferences = false;
+
+        for (uint16_t i = 0; i < klass->field_count; i++)
+        {
+            FieldInfo* field = klass->fields + i;
+            if (!Field::IsThreadStatic(field))
+                continue;
+
+            // Without a known offset for the field, fall back to scanning the whole block.
+            if (field->offset != THREAD_STATIC_FIELD_OFFSET)
+            {
+                std::fill(bitmap.begin(), bitmap.end(), ~(size_t)0);
+                return il2cpp::gc::GarbageCollector::MakeDescriptorForTypedMemory(&bitmap[0], (int)(klass->thread_static_fields_size / sizeof(void*)));
+            }
+
+            const Il2CppType* ftype = Type::GetUnderlyingType(field->type);
+            size_t offset = MetadataCache::GetThreadLocalStaticOffsetForField(field);
+
+            if (Type::IsReference(ftype))
+            {
+                IL2CPP_ASSERT(0 == (offset % sizeof(void*)));
+                bitmap[offset / sizeof(void*) / kBitsPerWord] |= (size_t)1 << (offset / sizeof(void*) % kBitsPerWord);
+                maxSetBit = std::max(maxSetBit, offset / sizeof(void*));
+                hasReferences = true;
+            }
+            else if (Type::IsStruct(ftype) && Class::HasReferences(Class::FromIl2CppType(ftype)))
+            {
+                GetBitmapNoInit(Class::FromIl2CppType(ftype), &bitmap[0], maxSetBit, offset - sizeof(Il2CppObject) /* nested field offset includes padding for boxed structure. Remove for struct fields */, &lock);
+                hasReferences = true;
+            }
+        }
+
+        if (!hasReferences)
+            return NULL;
+
+        return il2cpp::gc::GarbageCollector::MakeDescriptorForTypedMemory(&bitmap[0], (int)maxSetBit + 1);
+    }
+
     static void LayoutFieldsLocked(Il2CppClass *klass, const il2cpp::os::FastAutoLock& lock)
     {
         if (Class::IsGeneric(klass))
@@ -999,7 +1230,7 @@ namespace vm
             il2cpp_runtime_stats.class_static_data_size += klass->static_fields_size;
         }
         if (klass->thread_static_fields_size)
-            klass->thread_static_fields_offset = il2cpp::vm::Thread::AllocThreadStaticData(klass->thread_static_fields_size);
+            klass->thread_static_fields_offset = il2cpp::vm::Thread::AllocThreadStaticData(klass->thread_static_fields_size, MakeThreadStaticGCDescriptorLocked(klass, lock));
 
         if (Class::IsValuetype(klass))
             klass->stack_slot_size = klass->instance_size - sizeof(Il2CppObject);
@@ -1075,6 +1306,61 @@ namespace vm
         }
     }
 
+    static void InitializeMethodInfo(Il2CppClass* klass, MethodIndex index, MethodInfo* newMethod)
+    {
+        Il2CppMetadataMethodInfo methodInfo = MetadataCache::GetMethodInfo(klass, index);
+
+        newMethod->name = methodInfo.name;
+
+        newMethod->methodPointer = MetadataCache::GetMethodPointer(klass->image, methodInfo.token);
+
+        if (klass->byval_arg.valuetype)
+        {
+            Il2CppMethodPointer adjustorThunk = MetadataCache::GetAdjustorThunk(klass->image, methodInfo.token);
+            if (adjustorThunk != NULL)
+                newMethod->virtualMethodPointer = adjustorThunk;
+        }
+        // We did not find an adjustor thunk, or maybe did not need to look for one. Let's get the real method pointer.
+        if (newMethod->virtualMethodPointer == NULL)
+            newMethod->virtualMethodPointer = newMethod->methodPointer;
+
+        newMethod->klass = klass;
+        newMethod->return_type = methodInfo.return_type;
+
+        newMethod->parameters_count = (uint8_t)methodInfo.parameterCount;
+
+        const Il2CppType** parameters = (const Il2CppType**)MetadataCalloc(methodInfo.parameterCount, sizeof(Il2CppType*));
+        for (uint16_t paramIndex = 0; paramIndex < methodInfo.parameterCount; ++paramIndex)
+        {
+            Il2CppMetadataParameterInfo paramInfo = MetadataCache::GetParameterInfo(klass, methodInfo.handle, paramIndex);
+            parameters[paramIndex] = paramInfo.type;
+        }
+        newMethod->parameters = parameters;
+
+        newMethod->flags = methodInfo.flags;
+        newMethod->iflags = methodInfo.iflags;
+        newMethod->slot = methodInfo.slot;
+        newMethod->is_inflated = false;
+        newMethod->token = methodInfo.token;
+        newMethod->methodMetadataHandle = methodInfo.handle;
+        newMethod->genericContainerHandle = MetadataCache::GetGenericContainerFromMethod(methodInfo.handle);
+        if (newMethod->genericContainerHandle)
+            newMethod->is_generic = true;
+        newMethod->has_full_generic_sharing_signature = false;
+
+        if (newMethod->virtualMethodPointer)
+        {
+            newMethod->invoker_method = MetadataCache::GetMethodInvoker(klass->image, methodInfo.token);
+        }
+        else
+        {
+            newMethod->invoker_method = Runtime::GetMissingMethodInvoker();
+            il2cpp::vm::Il2CppUnresolvedCallStubs stubs = MetadataCache::GetUnresovledCallStubs(newMethod);
+            newMethod->methodPointer = stubs.methodPointer;
+            newMethod->virtualMethodPointer = stubs.virtualMethodPointer;
+        }
+    }
+
 // passing lock to ensure we have acquired it. We can add asserts later
     void SetupMethodsLocked(Il2CppClass *klass, const il2cpp::os::FastAutoLock& lock)
     {
@@ -1099,76 +1385,27 @@ namespace vm
                 return;
             }
 
-            klass->methods = (const MethodInfo**)MetadataCalloc(klass->method_count, sizeof(MethodInfo*));
-            MethodInfo* methods = (MethodInfo*)MetadataCalloc(klass->method_count, sizeof(MethodInfo));
-            MethodInfo* newMethod = methods;
-
-            MethodIndex end = klass->method_count;
+            const MethodInfo** methodList = (const MethodInfo**)MetadataCalloc(klass->method_count, sizeof(MethodInfo*));
 
-            for (MethodIndex index = 0; index < end; ++index)
+#if !IL2CPP_ENABLE_LAZY_METHOD_INFOS
+            MethodInfo* methods = (MethodInfo*)MetadataCalloc(klass->method_count, sizeof(MethodInfo));
+            for (MethodIndex index = 0; index < klass->method_count; ++index)
             {
-                Il2CppMetadataMethodInfo methodInfo = MetadataCache::GetMethodInfo(klass, index);
-
-                newMethod->name = methodInfo.name;
-
-                newMethod->methodPointer = MetadataCache::GetMethodPointer(klass->image, methodInfo.token);
-
-                if (klass->byval_arg.valuetype)
-                {
-                    Il2CppMethodPointer adjustorThunk = MetadataCache::GetAdjustorThunk(klass->image, methodInfo.token);
-                    if (adjustorThunk != NULL)
-                        newMethod->virtualMethodPointer = adjustorThunk;
-                }
-                // We did not find an adjustor thunk, or maybe did not need to look for one. Let's get the real method pointer.
-                if (newMethod->virtualMethodPointer == NULL)
-                    newMethod->virtualMethodPointer = newMethod->methodPointer;
-
-                newMethod->klass = klass;
-                newMethod->return_type = methodInfo.return_type;
-
-                newMethod->parameters_count = (uint8_t)methodInfo.parameterCount;
-
-                const Il2CppType** parameters = (const Il2CppType**)MetadataCalloc(methodInfo.parameterCount, sizeof(Il2CppType*));
-                for (uint16_t paramIndex = 0; paramIndex < methodInfo.parameterCount; ++paramIndex)
-                {
-                    Il2CppMetadataParameterInfo paramInfo = MetadataCache::GetParameterInfo(klass, methodInfo.handle, paramIndex);
-                    parameters[paramIndex] = paramInfo.type;
-                }
-                newMethod->parameters = parameters;
-
-                newMethod->flags = methodInfo.flags;
-                newMethod->iflags = methodInfo.iflags;
-                newMethod->slot = methodInfo.slot;
-                newMethod->is_inflated = false;
-                newMethod->token = methodInfo.token;
-                newMethod->methodMetadataHandle = methodInfo.handle;
-                newMethod->genericContainerHandle = MetadataCache::GetGenericContainerFromMethod(methodInfo.handle);
-                if (newMethod->genericContainerHandle)
-                    newMethod->is_generic = true;
-                newMethod->has_full_generic_sharing_signature = false;
-
-                if (newMethod->virtualMethodPointer)
-                {
-                    newMethod->invoker_method = MetadataCache::GetMethodInvoker(klass->image, methodInfo.token);
-                }
-                else
-                {
-                    newMethod->invoker_method = Runtime::GetMissingMethodInvoker();
-                    il2cpp::vm::Il2CppUnresolvedCallStubs stubs = MetadataCache::GetUnresovledCallStubs(newMethod);
-                    newMethod->methodPointer = stubs.methodPointer;
-                    newMethod->virtualMethodPointer = stubs.virtualMethodPointer;
-                }
-
-
-                klass->methods[index] = newMethod;
-
-                newMethod++;
+                InitializeMethodInfo(klass, index, &methods[index]);
+                methodList[index] = &methods[index];
             }
+#endif
+
+            PublishMetadata(klass->methods, methodList);
         }
     }
 
     void Class::SetupMethods(Il2CppClass *klass)
     {
+        // Once the methods are published they never change, so only the thread that builds them needs the lock.
+        if (LoadPublishedMetadata(klass->methods) != NULL)
+            return;
+
         if (klass->method_count || klass->rank)
         {
             il2cpp::os::FastAutoLock lock(&g_MetadataLock);
@@ -1176,6 +1413,28 @@ namespace vm
         }
     }
 
+    const MethodInfo* Class::GetMethodAt(Il2CppClass *klass, uint16_t index)
+    {
+        Class::SetupMethods(klass);
+        IL2CPP_ASSERT(index < klass->method_count);
+
+#if IL2CPP_ENABLE_LAZY_METHOD_INFOS
+        const MethodInfo* method = LoadPublishedMetadata(klass->methods[index]);
+        if (method != NULL)
+            return method;
+
+        il2cpp::os::FastAutoLock lock(&g_MetadataLock);
+        if (klass->methods[index] == NULL)
+        {
+            MethodInfo* newMethod = (MethodInfo*)MetadataCalloc(1, sizeof(MethodInfo));
+            InitializeMethodInfo(klass, index, newMethod);
+            PublishMetadata(klass->methods[index], (const MethodInfo*)newMethod);
+        }
+#endif
+
+        return klass->methods[index];
+    }
+
     void SetupNestedTypesLocked(Il2CppClass *klass, const il2cpp::os::FastAutoLock& lock)
     {
         if (klass->generic_class || klass->nestedTypes)
@@ -1183,15 +1442,16 @@ namespace vm
 
         if (klass->nested_type_count > 0)
         {
-            klass->nestedTypes = (Il2CppClass**)MetadataCalloc(klass->nested_type_count, sizeof(Il2CppClass*));
+            Il2CppClass** nestedTypes = (Il2CppClass**)MetadataCalloc(klass->nested_type_count, sizeof(Il2CppClass*));
             for (uint16_t i = 0; i < klass->nested_type_count; i++)
-                klass->nestedTypes[i] = MetadataCache::GetNestedTypeFromOffset(klass, i);
+                nestedTypes[i] = MetadataCache::GetNestedTypeFromOffset(klass, i);
+            PublishMetadata(klass->nestedTypes, nestedTypes);
         }
     }
 
     void Class::SetupNestedTypes(Il2CppClass *klass)
     {
-        if (klass->generic_class || klass->nestedTypes)
+        if (klass->generic_class || LoadPublishedMetadata(klass->nestedTypes))
             return;
 
         if (klass->nested_type_count)
@@ -1345,13 +1605,13 @@ namespace vm
                 newEvent++;
             }
 
-            klass->events = events;
+            PublishMetadata(klass->events, (const EventInfo*)events);
         }
     }
 
     void Class::SetupEvents(Il2CppClass *klass)
     {
-        if (!klass->events && klass->event_count)
+        if (!LoadPublishedMetadata(klass->events) && klass->event_count)
         {
             il2cpp::os::FastAutoLock lock(&g_MetadataLock);
             SetupEventsLocked(klass, lock);
@@ -1389,13 +1649,13 @@ namespace vm
                 newProperty++;
             }
 
-            klass->properties = properties;
+            PublishMetadata(klass->properties, (const PropertyInfo*)properties);
         }
     }
 
     void Class::SetupProperties(Il2CppClass *klass)
     {
-        if (!klass->properties && klass->property_count)
+        if (!LoadPublishedMetadata(klass->properties) && klass->property_count)
         {
             il2cpp::os::FastAutoLock lock(&g_MetadataLock);
             SetupPropertiesLocked(klass, lock);
@@ -1414,22 +1674,24 @@ namespace vm
         else
             klass->typeHierarchyDepth = 1;
 
-        klass->typeHierarchy = (Il2CppClass**)MetadataCalloc(klass->typeHierarchyDepth, sizeof(Il2CppClass*));
+        Il2CppClass** typeHierarchy = (Il2CppClass**)MetadataCalloc(klass->typeHierarchyDepth, sizeof(Il2CppClass*));
 
         if (klass->parent)
         {
-            klass->typeHierarchy[klass->typeHierarchyDepth - 1] = klass;
-            memcpy(klass->typeHierarchy, klass->parent->typeHierarchy, klass->parent->typeHierarchyDepth * sizeof(void*));
+            typeHierarchy[klass->typeHierarchyDepth - 1] = klass;
+            memcpy(typeHierarchy, klass->parent->typeHierarchy, klass->parent->typeHierarchyDepth * sizeof(void*));
         }
         else
         {
-            klass->typeHierarchy[0] = klass;
+            typeHierarchy[0] = klass;
         }
+
+        PublishMetadata(klass->typeHierarchy, typeHierarchy);
     }
 
     void Class::SetupTypeHierarchy(Il2CppClass *klass)
     {
-        if (klass->typeHierarchy == NULL)
+        if (LoadPublishedMetadata(klass->typeHierarchy) == NULL)
         {
             il2cpp::os::FastAutoLock lock(&g_MetadataLock);
             SetupTypeHierarchyLocked(klass, lock);
@@ -1438,7 +1700,7 @@ namespace vm
 
     void Class::SetupInterfaces(Il2CppClass *klass)
     {
-        if (klass->implementedInterfaces == NULL)
+        if (LoadPublishedMetadata(klass->implementedInterfaces) == NULL)
         {
             il2cpp::os::FastAutoLock lock(&g_MetadataLock);
             SetupInterfacesLocked(klass, lock);
@@ -1551,6 +1813,9 @@ namespace vm
             }
         }
 
+        // Everything written above has to be visible before another thread sees the class as initialized and
+        // skips the lock in Class::Init.
+        baselib::atomic_thread_fence(baselib::memory_order_release);
         klass->initialized = true;
         Class::UpdateInitializedAndNoError(klass);
         klass->init_pending = false;
@@ -1579,12 +1844,20 @@ namespace vm
     {
         IL2CPP_ASSERT(klass);
 
-        if (!klass->initialized)
+        if (klass->initialized)
         {
-            il2cpp::os::FastAutoLock lock(&g_MetadataLock);
-            IL2CPP_ASSERT(!klass->init_pending);
-            InitLocked(klass, lock);
+            // Pairs with the release fence in InitLocked.
+            baselib::atomic_thread_fence(baselib::memory_order_acquire);
+            return;
         }
+
+        // Initializations run one at a time, even of unrelated classes. InitLocked recurses into parents, interfaces,
+        // element types and generic definitions, and fills caches shared between classes (inflated methods, RGCTXs),
+        // all of which rely on g_MetadataLock. Per-class init states with waits only on the class being initialized
+        // would need those to be safe without it first.
+        il2cpp::os::FastAutoLock lock(&g_MetadataLock);
+        IL2CPP_ASSERT(!klass->init_pending);
+        InitLocked(klass, lock);
     }
 
     void Class::SetClassInitializationError(Il2CppClass *klass, Il2CppException* error)
@@ -1779,7 +2052,18 @@ namespace vm
         if (!klass->has_cctor)
             return NULL;
 
-        return GetMethodFromNameFlags(klass, ".cctor", IgnoreNumberOfArguments, METHOD_ATTRIBUTE_SPECIAL_NAME);
+        // The type initializer is declared on the class itself and is looked up once, so a scan of its own methods
+        // beats building a name index for every class that has one.
+        Class::Init(klass);
+
+        void* iter = NULL;
+        while (const MethodInfo* method = Class::GetMethods(klass, &iter))
+        {
+            if ((method->flags & METHOD_ATTRIBUTE_SPECIAL_NAME) && !strcmp(method->name, ".cctor"))
+                return method;
+        }
+
+        return NULL;
     }
 
     const char* Class::GetFieldDefaultValue(const FieldInfo *field, const Il2CppType** type)
@@ -62,6 +62,7 @@ namespace vm
         static int32_t GetInstanceSize(const Il2CppClass *klass);
         static Il2CppClass* GetInterfaces(Il2CppClass *klass, void* *iter);
         static const MethodInfo* GetMethods(Il2CppClass *klass, void* *iter);
+        static const MethodInfo* GetMethodAt(Il2CppClass *klass, uint16_t index);
         static const MethodInfo* GetMethodFromName(Il2CppClass *klass, const char* name, int argsCount);
         static const MethodInfo* GetMethodFromNameFlags(Il2CppClass *klass, const char* name, int argsCount, int32_t flags);
         static const MethodInfo* GetMethodFromNameFlagsAndSig(Il2CppClass *klass, const char* name, int argsCount, int32_t flags, const Il2CppType** argTypes);
@@ -33,11 +33,11 @@ namespace vm
 
         for (uint16_t methodIndex = 0; methodIndex < methodCount; ++methodIndex)
         {
-            const MethodInfo* methodDefinition = genericTypeDefinition->methods[methodIndex];
+            const MethodInfo* methodDefinition = Class::GetMethodAt(genericTypeDefinition, methodIndex);
             methods[methodIndex] = metadata::GenericMetadata::Inflate(methodDefinition, GenericClass::GetContext(genericInstanceType->generic_class));
         }
 
-        genericInstanceType->methods = methods;
+        PublishMetadata(genericInstanceType->methods, methods);
 
         il2cpp_runtime_stats.method_count += methodCount;
     }
@@ -76,7 +76,7 @@ namespace vm
             property++;
         }
 
-        genericInstanceType->properties = properties;
+        PublishMetadata(genericInstanceType->properties, (const PropertyInfo*)properties);
     }
 
     static void InflateEventDefinition(const EventInfo* eventDefinition, EventInfo* newEvent, Il2CppClass* declaringClass, Il2CppGenericContext* context)
@@ -115,7 +115,7 @@ namespace vm
             event++;
         }
 
-        genericInstanceType->events = events;
+        PublishMetadata(genericInstanceType->events, (const EventInfo*)events);
     }
 
     static FieldInfo* InflateFieldDefinition(const FieldInfo* fieldDefinition, FieldInfo* newField, Il2CppClass* declaringClass, Il2CppGenericContext* context)
@@ -52,6 +52,7 @@
 
 #include "Baselib.h"
 #include "Cpp/ReentrantLock.h"
+#include "xxhash.h"
 
 #include "GlobalMetadataFileInternals.h"
 
@@ -80,6 +81,11 @@ static const Il2CppGenericMethod** s_GenericMethodTable = NULL;
 static const MethodInfo** s_MethodInfoDefinitionTable = NULL;
 
 static Il2CppString** s_StringLiteralTable = NULL;
+#if IL2CPP_ENABLE_FROZEN_STRING_LITERALS
+static void* s_FrozenStringLiterals = NULL;
+static const Il2CppFrozenStringLiteralsHeader* s_FrozenStringLiteralsHeader = NULL;
+static int64_t s_FrozenStringLiteralsSize = 0;
+#endif
 
 static il2cpp::utils::OnceFlag s_CustomAttributesOnceFlag;
 static int s_CustomAttributesCount;
@@ -136,7 +142,7 @@ const MethodInfo* il2cpp::vm::GlobalMetadata::GetMethodInfoFromMethodDefinitionI
         Il2CppClass* typeInfo = GetTypeInfoFromTypeDefinitionIndex(methodDefinition->declaringType);
         il2cpp::vm::Class::SetupMethods(typeInfo);
         const Il2CppTypeDefinition* typeDefinition = reinterpret_cast<const Il2CppTypeDefinition*>(typeInfo->typeMetadataHandle);
-        s_MethodInfoDefinitionTable[index] = typeInfo->methods[index - typeDefinition->methodStart];
+        s_MethodInfoDefinitionTable[index] = il2cpp::vm::Class::GetMethodAt(typeInfo, static_cast<uint16_t>(index - typeDefinition->methodStart));
     }
 
     return s_MethodInfoDefinitionTable[index];
@@ -221,6 +227,74 @@ static const MethodInfo* GetMethodInfoFromEncodedIndex(EncodedMethodIndex method
     return NULL;
 }
 
+#if IL2CPP_ENABLE_FROZEN_STRING_LITERALS
+
+static uint64_t HashStringLiterals()
+{
+    const uint64_t stringLiteralHash = XXH64((const char*)s_GlobalMetadata + s_GlobalMetadataHeader->stringLiteralOffset, s_GlobalMetadataHeader->stringLiteralSize, 0);
+    return XXH64((const char*)s_GlobalMetadata + s_GlobalMetadataHeader->stringLiteralDataOffset, s_GlobalMetadataHeader->stringLiteralDataSize, stringLiteralHash);
+}
+
+static bool IsFrozenStringLiteralsFileUsable(const Il2CppFrozenStringLiteralsHeader* header, int64_t fileSize, int32_t stringLiteralCount)
+{
+    if (fileSize < (int64_t)sizeof(Il2CppFrozenStringLiteralsHeader) || header->fileSize != fileSize)
+        return false;
+
+    if (header->sanity != s_GlobalMetadataHeader->sanity || header->version != s_GlobalMetadataHeader->version
+        || header->pointerSize != sizeof(void*) || header->stringLiteralCount != stringLiteralCount)
+        return false;
+
+    if (header->stringOffsetsOffset < (int32_t)sizeof(Il2CppFrozenStringLiteralsHeader) || header->stringOffsetsOffset % sizeof(int32_t) != 0
+        || header->stringOffsetsOffset + (int64_t)stringLiteralCount * (int64_t)sizeof(int32_t) > fileSize)
+        return false;
+
+    // Same count, another build: without this the literals would silently have the text of the old ones.
+    return header->stringLiteralsHash == HashStringLiterals();
+}
+
+// Literals never die, so they live outside of the GC heap. Nothing on them is ever written after this, other than
+// the monitor, which is fine in the private pages of the literals file too.
+static Il2CppString* NewFrozenStringLiteral(StringLiteralIndex index, const Il2CppStringLiteral* stringLiteral)
+{
+    if (stringLiteral->length == 0)
+        return il2cpp::vm::String::Empty();
+
+    if (s_FrozenStringLiterals != NULL)
+    {
+        // The header matched, so only a damaged file fails these checks. Such a literal is transcoded instead, rather
+        // than read from past the end of the mapping.
+        const int32_t stringOffset = MetadataOffset<const int32_t*>(s_FrozenStringLiterals, s_FrozenStringLiteralsHeader->stringOffsetsOffset, index)[0];
+        const int64_t charsOffset = (int64_t)stringOffset + offsetof(Il2CppString, chars);
+        if (stringOffset >= (int32_t)sizeof(Il2CppFrozenStringLiteralsHeader) && stringOffset % sizeof(void*) == 0 && charsOffset <= s_FrozenStringLiteralsSize)
+        {
+            Il2CppString* frozenString = MetadataOffset<Il2CppString*>(s_FrozenStringLiterals, stringOffset, 0);
+
+            // UTF-16 never takes more code units than UTF-8 takes bytes.
+            if (frozenString->length >= 0 && (uint32_t)frozenString->length <= stringLiteral->length
+                && charsOffset + ((int64_t)frozenString->length + 1) * (int64_t)sizeof(Il2CppChar) <= s_FrozenStringLiteralsSize)
+            {
+                // Writing the same value when threads race for it does no harm, and the table publishes the string.
+                frozenString->object.klass = il2cpp_defaults.string_class;
+                return frozenString;
+            }
+        }
+
+        IL2CPP_ASSERT(0 && "global-metadata-literals.dat is damaged");
+    }
+
+    UTF16String chars = il2cpp::utils::StringUtils::Utf8ToUtf16((const char*)s_GlobalMetadata + s_GlobalMetadataHeader->stringLiteralDataOffset + stringLiteral->dataIndex, stringLiteral->length);
+
+    Il2CppString* frozenString = (Il2CppString*)il2cpp::vm::MetadataMalloc(sizeof(Il2CppString) + (chars.length() + 1) * sizeof(Il2CppChar));
+    frozenString->object.klass = il2cpp_defaults.string_class;
+    frozenString->object.monitor = NULL;
+    frozenString->length = static_cast<int32_t>(chars.length());
+    memcpy(frozenString->chars, chars.c_str(), (chars.length() + 1) * sizeof(Il2CppChar));
+
+    return frozenString;
+}
+
+#endif
+
 static Il2CppString* GetStringLiteralFromIndex(StringLiteralIndex index)
 {
     if (index == kStringLiteralIndexInvalid)
@@ -232,6 +306,11 @@ static Il2CppString* GetStringLiteralFromIndex(StringLiteralIndex index)
         return s_StringLiteralTable[index];
 
     const Il2CppStringLiteral* stringLiteral = (const Il2CppStringLiteral*)((const char*)s_GlobalMetadata + s_GlobalMetadataHeader->stringLiteralOffset) + index;
+#if IL2CPP_ENABLE_FROZEN_STRING_LITERALS
+    Il2CppString* newString = NewFrozenStringLiteral(index, stringLiteral);
+    Il2CppString* prevString = il2cpp::os::Atomic::CompareExchangePointer<Il2CppString>(s_StringLiteralTable + index, newString, NULL);
+    return prevString == NULL ? newString : prevString;
+#else
     Il2CppString* newString = il2cpp::vm::String::NewLen((const char*)s_GlobalMetadata + s_GlobalMetadataHeader->stringLiteralDataOffset + stringLiteral->dataIndex, stringLiteral->length);
     Il2CppString* prevString = il2cpp::os::Atomic::CompareExchangePointer<Il2CppString>(s_StringLiteralTable + index, newString, NULL);
     if (prevString == NULL)
@@ -240,6 +319,7 @@ static Il2CppString* GetStringLiteralFromIndex(StringLiteralIndex index)
         return newString;
     }
     return prevString;
+#endif
 }
 
 static FieldInfo* GetFieldInfoFromIndex(EncodedMethodIndex index)
@@ -332,6 +412,13 @@ bool il2cpp::vm::GlobalMetadata::Initialize(int32_t* imagesCount, int32_t* assem
     IL2CPP_ASSERT(s_GlobalMetadataHeader->version == 29);
     IL2CPP_ASSERT(s_GlobalMetadataHeader->stringLiteralOffset == sizeof(Il2CppGlobalMetadataHeader));
 
+    // Every startup walks all the image and assembly definitions, then looks up the core classes by name. Ask for
+    // those tables to be read in at once rather than taking a page fault for every page of them.
+    vm::MetadataLoader::PrefetchMetadataFileRange(s_GlobalMetadata, s_GlobalMetadataHeader->imagesOffset, s_GlobalMetadataHeader->imagesSize);
+    vm::MetadataLoader::PrefetchMetadataFileRange(s_GlobalMetadata, s_GlobalMetadataHeader->assembliesOffset, s_GlobalMetadataHeader->assembliesSize);
+    vm::MetadataLoader::PrefetchMetadataFileRange(s_GlobalMetadata, s_GlobalMetadataHeader->typeDefinitionsOffset, s_GlobalMetadataHeader->typeDefinitionsSize);
+    vm::MetadataLoader::PrefetchMetadataFileRange(s_GlobalMetadata, s_GlobalMetadataHeader->stringOffset, s_GlobalMetadataHeader->stringSize);
+
     s_MetadataImagesCount = *imagesCount = s_GlobalMetadataHeader->imagesSize / sizeof(Il2CppImageDefinition);
     *assembliesCount = s_GlobalMetadataHeader->assembliesSize / sizeof(Il2CppAssemblyDefinition);
 
@@ -431,7 +518,27 @@ void* il2cpp::vm::GlobalMetadata::InitializeRuntimeMetadata(uintptr_t* metadataP
 
 void il2cpp::vm::GlobalMetadata::InitializeStringLiteralTable()
 {
+#if IL2CPP_ENABLE_FROZEN_STRING_LITERALS
+    // No GC root, the strings the table points to are not in the GC heap.
+    const int32_t stringLiteralCount = s_GlobalMetadataHeader->stringLiteralSize / sizeof(Il2CppStringLiteral);
+    s_StringLiteralTable = (Il2CppString**)IL2CPP_CALLOC(stringLiteralCount, sizeof(Il2CppString*));
+
+    s_FrozenStringLiterals = vm::MetadataLoader::LoadOptionalMetadataFileForPatching("global-metadata-literals.dat", &s_FrozenStringLiteralsSize);
+    if (s_FrozenStringLiterals != NULL)
+    {
+        s_FrozenStringLiteralsHeader = (const Il2CppFrozenStringLiteralsHeader*)s_FrozenStringLiterals;
+        if (!IsFrozenStringLiteralsFileUsable(s_FrozenStringLiteralsHeader, s_FrozenStringLiteralsSize, stringLiteralCount))
+        {
+            // Left over from another build, truncated or meant for another architecture, transcode the literals instead.
+            vm::MetadataLoader::UnloadMetadataFile(s_FrozenStringLiterals);
+            s_FrozenStringLiterals = NULL;
+            s_FrozenStringLiteralsHeader = NULL;
+            s_FrozenStringLiteralsSize = 0;
+        }
+    }
+#else
     s_StringLiteralTable = (Il2CppString**)il2cpp::gc::GarbageCollector::AllocateFixed(s_GlobalMetadataHeader->stringLiteralSize / sizeof(Il2CppStringLiteral) * sizeof(Il2CppString*), NULL);
+#endif
 }
 
 void il2cpp::vm::GlobalMetadata::InitializeWindowsRuntimeTypeNamesTables(WindowsRuntimeTypeNameToClassMap& windowsRuntimeTypeNameToClassMap, ClassToWindowsRuntimeTypeNameMap& classToWindowsRuntimeTypeNameMap)
@@ -496,7 +603,17 @@ void il2cpp::vm::GlobalMetadata::InitializeGenericMethodTable(Il2CppMethodTableM
 
 static void ClearStringLiteralTable()
 {
+#if IL2CPP_ENABLE_FROZEN_STRING_LITERALS
+    IL2CPP_FREE(s_StringLiteralTable);
+
+    if (s_FrozenStringLiterals != NULL)
+        il2cpp::vm::MetadataLoader::UnloadMetadataFile(s_FrozenStringLiterals);
+    s_FrozenStringLiterals = NULL;
+    s_FrozenStringLiteralsHeader = NULL;
+    s_FrozenStringLiteralsSize = 0;
+#else
     il2cpp::gc::GarbageCollector::FreeFixed(s_StringLiteralTable);
+#endif
     s_StringLiteralTable = NULL;
 }
 
@@ -1101,8 +1218,8 @@ Il2CppMetadataPropertyInfo il2cpp::vm::GlobalMetadata::GetPropertyInfo(const Il2
 
     return {
             GetStringFromIndex(propertyDefintion->nameIndex),
-            propertyDefintion->get != kMethodIndexInvalid ? klass->methods[propertyDefintion->get] : NULL,
-            propertyDefintion->set != kMethodIndexInvalid ? klass->methods[propertyDefintion->set] : NULL,
+            propertyDefintion->get != kMethodIndexInvalid ? il2cpp::vm::Class::GetMethodAt(const_cast<Il2CppClass*>(klass), static_cast<uint16_t>(propertyDefintion->get)) : NULL,
+            propertyDefintion->set != kMethodIndexInvalid ? il2cpp::vm::Class::GetMethodAt(const_cast<Il2CppClass*>(klass), static_cast<uint16_t>(propertyDefintion->set)) : NULL,
             propertyDefintion->attrs,
             propertyDefintion->token,
     };
@@ -1120,9 +1237,9 @@ Il2CppMetadataEventInfo il2cpp::vm::GlobalMetadata::GetEventInfo(const Il2CppCla
     return {
             GetStringFromIndex(eventDefintion->nameIndex),
             GetIl2CppTypeFromIndex(eventDefintion->typeIndex),
-            eventDefintion->add != kMethodIndexInvalid ? klass->methods[eventDefintion->add] : NULL,
-            eventDefintion->remove != kMethodIndexInvalid ? klass->methods[eventDefintion->remove] : NULL,
-            eventDefintion->raise != kMethodIndexInvalid ? klass->methods[eventDefintion->raise] : NULL,
+            eventDefintion->add != kMethodIndexInvalid ? il2cpp::vm::Class::GetMethodAt(const_cast<Il2CppClass*>(klass), static_cast<uint16_t>(eventDefintion->add)) : NULL,
+            eventDefintion->remove != kMethodIndexInvalid ? il2cpp::vm::Class::GetMethodAt(const_cast<Il2CppClass*>(klass), static_cast<uint16_t>(eventDefintion->remove)) : NULL,
+            eventDefintion->raise != kMethodIndexInvalid ? il2cpp::vm::Class::GetMethodAt(const_cast<Il2CppClass*>(klass), static_cast<uint16_t>(eventDefintion->raise)) : NULL,
             eventDefintion->token,
     };
 }
@@ -272,6 +272,26 @@ typedef struct Il2CppWindowsRuntimeTypeNamePair
     TypeIndex typeIndex;
 } Il2CppWindowsRuntimeTypeNamePair;
 
+#pragma pack(push, p1,4)
+// global-metadata-literals.dat holds every string literal of global-metadata.dat laid out as an Il2CppString, to be
+// used in place from a copy-on-write mapping. The object header of each is zeroed, the runtime sets klass the first
+// time the literal is used. The characters are NUL terminated and every string starts pointer aligned. Its layout
+// depends on the pointer size, so each architecture has a file of its own. IL2CPP/tools/FreezeStringLiterals.cpp
+// writes it.
+typedef struct Il2CppFrozenStringLiteralsHeader
+{
+    int32_t sanity;
+    int32_t version;
+    int32_t pointerSize;
+    int32_t stringLiteralCount; // same as the Il2CppStringLiteral count of global-metadata.dat
+    int32_t stringOffsetsOffset; // int32_t per literal, the file offset of its Il2CppString
+    int32_t fileSize;
+    // XXH64 of the stringLiteralData section of global-metadata.dat, seeded with the XXH64 (seed 0) of its
+    // stringLiteral section. Ties the file to the literals it was written from.
+    uint64_t stringLiteralsHash;
+} Il2CppFrozenStringLiteralsHeader;
+#pragma pack(pop, p1)
+
 #pragma pack(push, p1,4)
 typedef struct Il2CppGlobalMetadataHeader
 {
@@ -32,7 +32,7 @@ namespace vm
     void LastError::InitializeLastErrorThreadStatic()
     {
         if (s_LastErrorThreadLocalStorageOffset == -1)
-            s_LastErrorThreadLocalStorageOffset = Thread::AllocThreadStaticData(sizeof(uint32_t));
+            s_LastErrorThreadLocalStorageOffset = Thread::AllocThreadStaticData(sizeof(uint32_t), NULL);
     }
 } /* namespace vm */
 } /* namespace il2cpp */
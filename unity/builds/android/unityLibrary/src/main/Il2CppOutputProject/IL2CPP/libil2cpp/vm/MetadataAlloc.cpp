@@ -1,6 +1,7 @@
 #include "il2cpp-config.h"
 #include "MetadataAlloc.h"
 #include "il2cpp-class-internals.h"
+#include "il2cpp-runtime-stats.h"
 #include "utils/MemoryPool.h"
 #if IL2CPP_SANITIZE_ADDRESS
 #include "utils/MemoryPoolAddressSanitizer.h"
@@ -29,14 +30,14 @@ namespace vm
     void MetadataAllocInitialize()
     {
 #if IL2CPP_SANITIZE_ADDRESS
-        s_MetadataMemoryPool = new utils::MemoryPoolAddressSanitizer(kInitialRegionSize);
-        s_GenericClassMemoryPool = new utils::MemoryPoolAddressSanitizer();
-        s_GenericMethodMemoryPool = new utils::MemoryPoolAddressSanitizer();
+        s_MetadataMemoryPool = new utils::MemoryPoolAddressSanitizer(kInitialRegionSize, &il2cpp_runtime_stats.metadata_memory);
+        s_GenericClassMemoryPool = new utils::MemoryPoolAddressSanitizer(&il2cpp_runtime_stats.generic_class_memory);
+        s_GenericMethodMemoryPool = new utils::MemoryPoolAddressSanitizer(&il2cpp_runtime_stats.generic_method_memory);
 #else
-        s_MetadataMemoryPool = new utils::MemoryPool(kInitialRegionSize);
+        s_MetadataMemoryPool = new utils::MemoryPool(kInitialRegionSize, &il2cpp_runtime_stats.metadata_memory);
         // these can use the default smaller initial pool size
-        s_GenericClassMemoryPool = new utils::MemoryPool();
-        s_GenericMethodMemoryPool = new utils::MemoryPool();
+        s_GenericClassMemoryPool = new utils::MemoryPool(&il2cpp_runtime_stats.generic_class_memory);
+        s_GenericMethodMemoryPool = new utils::MemoryPool(&il2cpp_runtime_stats.generic_method_memory);
 #endif
     }
 
@@ -10,10 +10,11 @@ namespace vm
 {
     void MetadataAllocInitialize();
     void MetadataAllocCleanup();
-// These allocators assume the g_MetadataLock lock is held
+// These allocators can be called from any thread, with or without the g_MetadataLock lock held.
+// The memory lives until MetadataAllocCleanup.
     void* MetadataMalloc(size_t size);
     void* MetadataCalloc(size_t count, size_t size);
-// These metadata structures have their own locks, since they do lightweight initialization
+// These metadata structures have pools of their own, since they are created under their own locks
     Il2CppGenericClass* MetadataAllocGenericClass();
     Il2CppGenericMethod* MetadataAllocGenericMethod();
 } // namespace vm
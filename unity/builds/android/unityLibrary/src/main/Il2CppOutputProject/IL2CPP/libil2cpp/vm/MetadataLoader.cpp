@@ -34,28 +34,58 @@ void* il2cpp::vm::MetadataLoader::LoadMetadataFile(const char* fileName)
 
     std::string resourceFilePath = utils::PathUtils::Combine(resourcesDirectory, utils::StringView<char>(fileName, strlen(fileName)));
 
-    int error = 0;
-    os::FileHandle* handle = os::File::Open(resourceFilePath, kFileModeOpen, kFileAccessRead, kFileShareRead, kFileOptionsNone, &error);
-    if (error != 0)
+    // Not populated up front: only a few sections are read during startup, the caller prefetches those.
+    void* fileBuffer = utils::MemoryMappedFile::MapShared(resourceFilePath, os::kMemoryMappedViewNone);
+    if (fileBuffer == NULL)
     {
         utils::Logging::Write("ERROR: Could not open %s", resourceFilePath.c_str());
         return NULL;
     }
 
-    void* fileBuffer = utils::MemoryMappedFile::Map(handle);
+    return fileBuffer;
+#endif
+}
 
-    os::File::Close(handle, &error);
+void* il2cpp::vm::MetadataLoader::LoadOptionalMetadataFileForPatching(const char* fileName, int64_t* fileSize)
+{
+    *fileSize = 0;
+
+#if (IL2CPP_TARGET_ANDROID || IL2CPP_TARGET_JAVASCRIPT) && IL2CPP_TINY_DEBUGGER && !IL2CPP_TINY_FROM_IL2CPP_BUILDER
+    NO_UNUSED_WARNING(fileName);
+    return NULL;
+#else
+    std::string resourcesDirectory = utils::PathUtils::Combine(utils::Runtime::GetDataDir(), utils::StringView<char>("Metadata"));
+
+    std::string resourceFilePath = utils::PathUtils::Combine(resourcesDirectory, utils::StringView<char>(fileName, strlen(fileName)));
+
+    int error = 0;
+    os::FileHandle* handle = os::File::Open(resourceFilePath, kFileModeOpen, kFileAccessRead, kFileShareRead, kFileOptionsNone, &error);
     if (error != 0)
-    {
-        utils::MemoryMappedFile::Unmap(fileBuffer);
-        fileBuffer = NULL;
         return NULL;
-    }
+
+    const int64_t length = os::File::GetLength(handle, &error);
+    void* fileBuffer = error == 0 && length > 0 ? utils::MemoryMappedFile::Map(handle, 0, 0, os::MMAP_FILE_ACCESS_COPY_ON_WRITE) : NULL;
+    if (fileBuffer != NULL)
+        *fileSize = length;
+
+    os::File::Close(handle, &error);
 
     return fileBuffer;
 #endif
 }
 
+void il2cpp::vm::MetadataLoader::PrefetchMetadataFileRange(void* fileBuffer, int32_t offset, int32_t size)
+{
+#if (IL2CPP_TARGET_ANDROID || IL2CPP_TARGET_JAVASCRIPT) && IL2CPP_TINY_DEBUGGER && !IL2CPP_TINY_FROM_IL2CPP_BUILDER
+    NO_UNUSED_WARNING(fileBuffer);
+    NO_UNUSED_WARNING(offset);
+    NO_UNUSED_WARNING(size);
+#else
+    if (size > 0)
+        utils::MemoryMappedFile::Advise((uint8_t*)fileBuffer + offset, size, os::kMemoryMappedAdviceWillNeed);
+#endif
+}
+
 void il2cpp::vm::MetadataLoader::UnloadMetadataFile(void* fileBuffer)
 {
 #if IL2CPP_TARGET_ANDROID && IL2CPP_TINY_DEBUGGER && !IL2CPP_DEBUGGER_TESTS
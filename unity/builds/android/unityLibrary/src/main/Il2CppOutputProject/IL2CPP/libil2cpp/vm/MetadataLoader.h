@@ -10,6 +10,11 @@ namespace vm
     public:
         static void* LoadMetadataFile(const char* fileName);
         static void UnloadMetadataFile(void* fileBuffer);
+        // Starts reading in a part of a loaded file ahead of its first use.
+        static void PrefetchMetadataFileRange(void* fileBuffer, int32_t offset, int32_t size);
+        // Maps a file copy-on-write, so it can be patched in place, and sets fileSize to its size. Returns NULL,
+        // without logging an error, when the file is not there. Unload it with UnloadMetadataFile.
+        static void* LoadOptionalMetadataFileForPatching(const char* fileName, int64_t* fileSize);
     };
 } // namespace vm
 } // namespace il2cpp
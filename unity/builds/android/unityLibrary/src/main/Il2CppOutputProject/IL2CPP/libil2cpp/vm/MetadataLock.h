@@ -2,6 +2,7 @@
 
 #include "il2cpp-config.h"
 #include "Baselib.h"
+#include "Cpp/Atomic.h"
 #include "Cpp/ReentrantLock.h"
 
 namespace il2cpp
@@ -9,5 +10,19 @@ namespace il2cpp
 namespace vm
 {
     extern baselib::ReentrantLock g_MetadataLock;
+
+    // Class data built lazily under g_MetadataLock is published with a release store once it is complete, so
+    // a thread that loads a non-NULL pointer with an acquire load can use it without taking the lock.
+    template<typename T>
+    inline void PublishMetadata(T*& field, T* value)
+    {
+        baselib::atomic_store_explicit(field, value, baselib::memory_order_release);
+    }
+
+    template<typename T>
+    inline T* LoadPublishedMetadata(T* const& field)
+    {
+        return baselib::atomic_load_explicit(field, baselib::memory_order_acquire);
+    }
 } // namespace vm
 } // namespace il2cpp
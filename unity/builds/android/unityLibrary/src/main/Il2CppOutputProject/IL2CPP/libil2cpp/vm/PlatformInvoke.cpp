@@ -194,102 +194,83 @@ namespace vm
         vm::Exception::RaiseIfFailed(hr, true);
     }
 
-    char* PlatformInvoke::MarshalEmptyStringBuilder(Il2CppStringBuilder* stringBuilder, size_t& stringLength, std::vector<std::string>& utf8Chunks, std::vector<Il2CppStringBuilder*>& builders)
+    // A builder is a list of chunks linked from the last one back to the first, each chunk knows where it
+    // starts so the length and capacity of the whole builder can be read off the last chunk.
+    static inline size_t GetStringBuilderLength(Il2CppStringBuilder* stringBuilder)
     {
-        if (stringBuilder == NULL)
-            return NULL;
-
-        stringLength = 0;
-        Il2CppStringBuilder* currentBuilder = stringBuilder;
-
-        while (true)
-        {
-            if (currentBuilder == NULL)
-                break;
-
-            const Il2CppChar *str = (Il2CppChar*)il2cpp::vm::Array::GetFirstElementAddress(currentBuilder->chunkChars);
-            std::string utf8String = utils::StringUtils::Utf16ToUtf8(str, (int)currentBuilder->chunkChars->max_length);
-
-            utf8Chunks.push_back(utf8String);
-            builders.push_back(currentBuilder);
-
-            size_t lenToCount = std::max((size_t)currentBuilder->chunkChars->max_length, utf8String.size());
-
-            stringLength += lenToCount;
-
-            currentBuilder = currentBuilder->chunkPrevious;
-        }
-
-        char* nativeString = MarshalAllocateStringBuffer<char>(stringLength + 1);
-
-        // We need to zero out the memory because the chunkChar array lengh may have been larger than the chunkLength
-        // and when this happens we'll have a utf8String that is smaller than the the nativeString we allocated.  When we go to copy the
-        // chunk utf8String into the nativeString it won't fill everything and we can end up with w/e junk value was in that memory before
-        memset(nativeString, 0, sizeof(char) * (stringLength + 1));
+        return (size_t)stringBuilder->chunkOffset + stringBuilder->chunkLength;
+    }
 
-        return nativeString;
+    static inline size_t GetStringBuilderCapacity(Il2CppStringBuilder* stringBuilder)
+    {
+        return (size_t)stringBuilder->chunkOffset + stringBuilder->chunkChars->max_length;
     }
 
-    char* PlatformInvoke::MarshalEmptyStringBuilder(Il2CppStringBuilder* stringBuilder)
+    static inline const Il2CppChar* GetStringBuilderChunkChars(Il2CppStringBuilder* chunk)
     {
-        size_t sizeLength;
-        std::vector<std::string> utf8Chunks;
-        std::vector<Il2CppStringBuilder*> builders;
-        return MarshalEmptyStringBuilder(stringBuilder, sizeLength, utf8Chunks, builders);
+        return (const Il2CppChar*)il2cpp::vm::Array::GetFirstElementAddress(chunk->chunkChars);
     }
 
-    char* PlatformInvoke::MarshalStringBuilder(Il2CppStringBuilder* stringBuilder)
+    // The native side may fill the buffer up to the capacity of the builder.
+    char* PlatformInvoke::MarshalEmptyStringBuilder(Il2CppStringBuilder* stringBuilder)
     {
         if (stringBuilder == NULL)
             return NULL;
 
-        size_t stringLength;
-        std::vector<std::string> utf8Chunks;
-        std::vector<Il2CppStringBuilder*> builders;
-        char* nativeString = MarshalEmptyStringBuilder(stringBuilder, stringLength, utf8Chunks, builders);
-
-        if (stringLength > 0)
-        {
-            int offsetAdjustment = 0;
-            for (int i = (int)utf8Chunks.size() - 1; i >= 0; i--)
-            {
-                std::string utf8String = utf8Chunks[i];
-
-                const char* utf8CString = utf8String.c_str();
-
-                memcpy(nativeString + builders[i]->chunkOffset + offsetAdjustment, utf8CString, (int)utf8String.size());
-
-                offsetAdjustment += (int)utf8String.size() - builders[i]->chunkLength;
-            }
-        }
+        const size_t bufferLength = GetStringBuilderCapacity(stringBuilder);
+        char* nativeString = MarshalAllocateStringBuffer<char>(bufferLength + 1);
+        memset(nativeString, 0, sizeof(char) * (bufferLength + 1));
 
         return nativeString;
     }
 
-    Il2CppChar* PlatformInvoke::MarshalEmptyWStringBuilder(Il2CppStringBuilder* stringBuilder, size_t& stringLength)
+    char* PlatformInvoke::MarshalStringBuilder(Il2CppStringBuilder* stringBuilder)
     {
         if (stringBuilder == NULL)
             return NULL;
 
-        stringLength = 0;
-        Il2CppStringBuilder* currentBuilder = stringBuilder;
-        while (true)
+        // The UTF-8 size of the most recent chunks is kept around for the second walk, older chunks of
+        // very large builders are measured again.
+        const int kMaxCachedChunkSizes = 32;
+        size_t chunkSizes[kMaxCachedChunkSizes];
+
+        size_t utf8Length = 0;
+        int chunkIndex = 0;
+        for (Il2CppStringBuilder* chunk = stringBuilder; chunk != NULL; chunk = chunk->chunkPrevious, chunkIndex++)
         {
-            if (currentBuilder == NULL)
-                break;
+            const size_t chunkSize = utils::StringUtils::Utf16ToUtf8Length(GetStringBuilderChunkChars(chunk), chunk->chunkLength);
+            if (chunkIndex < kMaxCachedChunkSizes)
+                chunkSizes[chunkIndex] = chunkSize;
+            utf8Length += chunkSize;
+        }
+
+        const size_t bufferLength = std::max(GetStringBuilderCapacity(stringBuilder), utf8Length);
+        char* nativeString = MarshalAllocateStringBuffer<char>(bufferLength + 1);
 
-            stringLength += (size_t)currentBuilder->chunkChars->max_length;
+        // The chunks come last to first, so the string is encoded from its end backwards.
+        size_t chunkEnd = utf8Length;
+        chunkIndex = 0;
+        for (Il2CppStringBuilder* chunk = stringBuilder; chunk != NULL; chunk = chunk->chunkPrevious, chunkIndex++)
+        {
+            const Il2CppChar* chunkChars = GetStringBuilderChunkChars(chunk);
+            const size_t chunkSize = chunkIndex < kMaxCachedChunkSizes ? chunkSizes[chunkIndex] : utils::StringUtils::Utf16ToUtf8Length(chunkChars, chunk->chunkLength);
 
-            currentBuilder = currentBuilder->chunkPrevious;
+            chunkEnd -= chunkSize;
+            utils::StringUtils::Utf16ToUtf8(chunkChars, chunk->chunkLength, nativeString + chunkEnd);
         }
 
-        return MarshalAllocateStringBuffer<Il2CppChar>(stringLength + 1);
+        IL2CPP_ASSERT(chunkEnd == 0);
+        memset(nativeString + utf8Length, 0, sizeof(char) * (bufferLength + 1 - utf8Length));
+
+        return nativeString;
     }
 
     Il2CppChar* PlatformInvoke::MarshalEmptyWStringBuilder(Il2CppStringBuilder* stringBuilder)
     {
-        size_t stringLength;
-        return MarshalEmptyWStringBuilder(stringBuilder, stringLength);
+        if (stringBuilder == NULL)
+            return NULL;
+
+        return MarshalAllocateStringBuffer<Il2CppChar>(GetStringBuilderCapacity(stringBuilder) + 1);
     }
 
     Il2CppChar* PlatformInvoke::MarshalWStringBuilder(Il2CppStringBuilder* stringBuilder)
@@ -297,28 +278,32 @@ namespace vm
         if (stringBuilder == NULL)
             return NULL;
 
-        size_t stringLength;
-        Il2CppChar* nativeString = MarshalEmptyWStringBuilder(stringBuilder, stringLength);
+        const size_t stringLength = GetStringBuilderLength(stringBuilder);
+        const size_t bufferLength = GetStringBuilderCapacity(stringBuilder);
+        Il2CppChar* nativeString = MarshalAllocateStringBuffer<Il2CppChar>(bufferLength + 1);
 
-        if (stringLength > 0)
-        {
-            Il2CppStringBuilder* currentBuilder = stringBuilder;
-            while (true)
-            {
-                if (currentBuilder == NULL)
-                    break;
+        for (Il2CppStringBuilder* chunk = stringBuilder; chunk != NULL; chunk = chunk->chunkPrevious)
+            memcpy(nativeString + chunk->chunkOffset, GetStringBuilderChunkChars(chunk), chunk->chunkLength * sizeof(Il2CppChar));
 
-                const Il2CppChar *str = (Il2CppChar*)il2cpp::vm::Array::GetFirstElementAddress(currentBuilder->chunkChars);
+        memset(nativeString + stringLength, 0, sizeof(Il2CppChar) * (bufferLength + 1 - stringLength));
 
-                memcpy(nativeString + currentBuilder->chunkOffset, str, (int)currentBuilder->chunkChars->max_length * sizeof(Il2CppChar));
+        return nativeString;
+    }
 
-                currentBuilder = currentBuilder->chunkPrevious;
-            }
-        }
+    // Collapses the builder into a single chunk of the given length. The last chunk is the only one nothing else
+    // refers to, so its array is reused when the result fits, otherwise a new one is allocated.
+    static Il2CppChar* ResetStringBuilderChunks(Il2CppStringBuilder* stringBuilder, size_t length)
+    {
+        if ((size_t)stringBuilder->chunkChars->max_length < length + 1)
+            IL2CPP_OBJECT_SETREF(stringBuilder, chunkChars, il2cpp::vm::Array::New(il2cpp_defaults.char_class, (il2cpp_array_size_t)length + 1));
 
-        nativeString[stringLength] = '\0';
+        stringBuilder->chunkLength = (int)length;
+        stringBuilder->chunkOffset = 0;
+        IL2CPP_OBJECT_SETREF_NULL(stringBuilder, chunkPrevious);
 
-        return nativeString;
+        Il2CppChar* chars = (Il2CppChar*)il2cpp::vm::Array::GetFirstElementAddress(stringBuilder->chunkChars);
+        chars[length] = '\0';
+        return chars;
     }
 
     void PlatformInvoke::MarshalStringBuilderResult(Il2CppStringBuilder* stringBuilder, char* buffer)
@@ -326,18 +311,13 @@ namespace vm
         if (stringBuilder == NULL || buffer == NULL)
             return;
 
-        UTF16String utf16String = utils::StringUtils::Utf8ToUtf16(buffer);
-
-        IL2CPP_OBJECT_SETREF(stringBuilder, chunkChars, il2cpp::vm::Array::New(il2cpp_defaults.char_class, (int)utf16String.size() + 1));
+        size_t utf8Length = strlen(buffer);
+        if (!utils::StringUtils::IsValidUtf8(buffer, utf8Length))
+            utf8Length = 0;
 
-        for (int i = 0; i < (int)utf16String.size(); i++)
-            il2cpp_array_set(stringBuilder->chunkChars, Il2CppChar, i, utf16String[i]);
-
-        il2cpp_array_set(stringBuilder->chunkChars, Il2CppChar, (int)utf16String.size(), '\0');
-
-        stringBuilder->chunkLength = (int)utf16String.size();
-        stringBuilder->chunkOffset = 0;
-        IL2CPP_OBJECT_SETREF_NULL(stringBuilder, chunkPrevious);
+        const size_t length = utils::StringUtils::Utf8ToUtf16Length(buffer, utf8Length);
+        Il2CppChar* chars = ResetStringBuilderChunks(stringBuilder, length);
+        utils::StringUtils::Utf8ToUtf16(buffer, utf8Length, chars);
     }
 
     void PlatformInvoke::MarshalWStringBuilderResult(Il2CppStringBuilder* stringBuilder, Il2CppChar* buffer)
@@ -345,18 +325,9 @@ namespace vm
         if (stringBuilder == NULL || buffer == NULL)
             return;
 
-        int len = (int)utils::StringUtils::StrLen(buffer);
-
-        IL2CPP_OBJECT_SETREF(stringBuilder, chunkChars, il2cpp::vm::Array::New(il2cpp_defaults.char_class, len + 1));
-
-        for (int i = 0; i < len; i++)
-            il2cpp_array_set(stringBuilder->chunkChars, Il2CppChar, i, buffer[i]);
-
-        il2cpp_array_set(stringBuilder->chunkChars, Il2CppChar, len, '\0');
-
-        stringBuilder->chunkLength = len;
-        stringBuilder->chunkOffset = 0;
-        IL2CPP_OBJECT_SETREF_NULL(stringBuilder, chunkPrevious);
+        const size_t length = utils::StringUtils::StrLen(buffer);
+        Il2CppChar* chars = ResetStringBuilderChunks(stringBuilder, length);
+        memcpy(chars, buffer, length * sizeof(Il2CppChar));
     }
 
     static bool IsGenericInstance(const Il2CppType* type)
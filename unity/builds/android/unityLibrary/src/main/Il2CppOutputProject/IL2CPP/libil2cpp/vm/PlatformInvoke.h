@@ -68,10 +68,6 @@ namespace vm
         {
             return (T*)MarshalAlloc::Allocate(numberOfCharacters * sizeof(T));
         }
-
-    private:
-        static char* MarshalEmptyStringBuilder(Il2CppStringBuilder* stringBuilder, size_t& stringLength, std::vector<std::string>& utf8Chunks, std::vector<Il2CppStringBuilder*>& builders);
-        static Il2CppChar* MarshalEmptyWStringBuilder(Il2CppStringBuilder* stringBuilder, size_t& stringLength);
     };
 } /* namespace vm */
 } /* namespace il2cpp */
@@ -1,6 +1,8 @@
 #include "il2cpp-config.h"
 #include "utils/dynamic_array.h"
 #include "vm/Profiler.h"
+#include "vm/ProfilerCapture.h"
+#include "vm/ProfilerSampler.h"
 
 #if IL2CPP_ENABLE_PROFILER
 
@@ -42,9 +44,14 @@ namespace vm
 
     void Profiler::SetEvents(Il2CppProfileFlags events)
     {
-        Il2CppProfileFlags value = IL2CPP_PROFILE_NONE;
         if (s_profilers.size())
             s_profilers.back()->events = events;
+        UpdateEvents();
+    }
+
+    void Profiler::UpdateEvents()
+    {
+        Il2CppProfileFlags value = ProfilerCapture::GetEvents();
         for (ProfilersVec::iterator iter = s_profilers.begin(); iter != s_profilers.end(); iter++)
             value = (Il2CppProfileFlags)(value | (*iter)->events);
         s_profilerEvents = value;
@@ -88,8 +95,36 @@ namespace vm
         s_profilers.back()->threadEndCallback = end;
     }
 
+    bool Profiler::StartCapture(const char* path, Il2CppProfileFlags events, uint32_t allocationSampleInterval)
+    {
+        if (!ProfilerCapture::Start(path, events, allocationSampleInterval))
+            return false;
+
+        UpdateEvents();
+        return true;
+    }
+
+    void Profiler::StopCapture()
+    {
+        ProfilerCapture::Stop();
+        UpdateEvents();
+    }
+
+    bool Profiler::StartSampling(uint32_t intervalMicroseconds, bool includeLineNumbers)
+    {
+        return ProfilerSampler::Start(intervalMicroseconds, includeLineNumbers);
+    }
+
+    bool Profiler::StopSampling(const char* path)
+    {
+        return ProfilerSampler::Stop(path);
+    }
+
     void Profiler::Allocation(Il2CppObject *obj, Il2CppClass *klass)
     {
+        if (ProfilerCapture::GetEvents() & IL2CPP_PROFILE_ALLOCATIONS)
+            ProfilerCapture::Allocation(obj, klass);
+
         for (ProfilersVec::const_iterator iter = s_profilers.begin(); iter != s_profilers.end(); iter++)
         {
             if (((*iter)->events & IL2CPP_PROFILE_ALLOCATIONS) && (*iter)->allocationCallback)
@@ -99,6 +134,9 @@ namespace vm
 
     void Profiler::MethodEnter(const MethodInfo *method)
     {
+        if (ProfilerCapture::GetEvents() & IL2CPP_PROFILE_ENTER_LEAVE)
+            ProfilerCapture::MethodEnter(method);
+
         for (ProfilersVec::const_iterator iter = s_profilers.begin(); iter != s_profilers.end(); iter++)
         {
             if (((*iter)->events & IL2CPP_PROFILE_ENTER_LEAVE) && (*iter)->methodEnterCallback)
@@ -108,6 +146,9 @@ namespace vm
 
     void Profiler::MethodExit(const MethodInfo *method)
     {
+        if (ProfilerCapture::GetEvents() & IL2CPP_PROFILE_ENTER_LEAVE)
+            ProfilerCapture::MethodExit(method);
+
         for (ProfilersVec::const_iterator iter = s_profilers.begin(); iter != s_profilers.end(); iter++)
         {
             if (((*iter)->events & IL2CPP_PROFILE_ENTER_LEAVE) && (*iter)->methodLeaveCallback)
@@ -117,6 +158,9 @@ namespace vm
 
     void Profiler::GCEvent(Il2CppGCEvent eventType)
     {
+        if (ProfilerCapture::GetEvents() & IL2CPP_PROFILE_GC)
+            ProfilerCapture::GCEvent(eventType);
+
         for (ProfilersVec::const_iterator iter = s_profilers.begin(); iter != s_profilers.end(); iter++)
         {
             if (((*iter)->events & IL2CPP_PROFILE_GC) && (*iter)->gcEventCallback)
@@ -126,6 +170,9 @@ namespace vm
 
     void Profiler::GCHeapResize(int64_t newSize)
     {
+        if (ProfilerCapture::GetEvents() & IL2CPP_PROFILE_GC)
+            ProfilerCapture::GCHeapResize(newSize);
+
         for (ProfilersVec::const_iterator iter = s_profilers.begin(); iter != s_profilers.end(); iter++)
         {
             if (((*iter)->events & IL2CPP_PROFILE_GC) && (*iter)->gcEventCallback)
@@ -144,6 +191,9 @@ namespace vm
 
     void Profiler::ThreadStart(unsigned long tid)
     {
+        if (ProfilerCapture::GetEvents() & IL2CPP_PROFILE_THREADS)
+            ProfilerCapture::ThreadStart(tid);
+
         for (ProfilersVec::const_iterator iter = s_profilers.begin(); iter != s_profilers.end(); iter++)
         {
             if (((*iter)->events & IL2CPP_PROFILE_THREADS) && (*iter)->threadStartCallback)
@@ -153,6 +203,10 @@ namespace vm
 
     void Profiler::ThreadEnd(unsigned long tid)
     {
+        if (ProfilerCapture::GetEvents() & IL2CPP_PROFILE_THREADS)
+            ProfilerCapture::ThreadEnd(tid);
+        ProfilerCapture::ReleaseCurrentThreadBuffer();
+
         for (ProfilersVec::const_iterator iter = s_profilers.begin(); iter != s_profilers.end(); iter++)
         {
             if (((*iter)->events & IL2CPP_PROFILE_THREADS) && (*iter)->threadEndCallback)
@@ -162,6 +216,9 @@ namespace vm
 
     void Profiler::Shutdown()
     {
+        StopCapture();
+        StopSampling(NULL);
+
         for (ProfilersVec::iterator iter = s_profilers.begin(); iter != s_profilers.end(); iter++)
         {
             if ((*iter)->shutdownCallback)
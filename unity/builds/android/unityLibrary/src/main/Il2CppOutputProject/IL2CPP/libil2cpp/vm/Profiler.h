@@ -22,6 +22,12 @@ namespace vm
         static void InstallFileIO(Il2CppProfileFileIOFunc callback);
         static void InstallThread(Il2CppProfileThreadFunc start, Il2CppProfileThreadFunc end);
 
+        static bool StartCapture(const char* path, Il2CppProfileFlags events, uint32_t allocationSampleInterval);
+        static void StopCapture();
+
+        static bool StartSampling(uint32_t intervalMicroseconds, bool includeLineNumbers);
+        static bool StopSampling(const char* path);
+
 // internal
     public:
         static void Allocation(Il2CppObject *obj, Il2CppClass *klass);
@@ -48,6 +54,7 @@ namespace vm
         static void Shutdown();
 
     private:
+        static void UpdateEvents();
     };
 
 #endif
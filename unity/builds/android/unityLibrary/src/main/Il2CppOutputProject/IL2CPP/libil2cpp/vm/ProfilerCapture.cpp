@@ -0,0 +1,440 @@
+#include "il2cpp-config.h"
+
+#if IL2CPP_ENABLE_PROFILER
+
+#include "il2cpp-class-internals.h"
+#include "il2cpp-object-internals.h"
+#include "os/Event.h"
+#include "os/File.h"
+#include "os/Mutex.h"
+#include "os/Thread.h"
+#include "os/ThreadLocalValue.h"
+#include "os/Time.h"
+#include "os/c-api/OSGlobalEnums.h"
+#include "utils/dynamic_array.h"
+#include "utils/HashUtils.h"
+#include "utils/Il2CppHashSet.h"
+#include "utils/Memory.h"
+#include "vm/Method.h"
+#include "vm/Object.h"
+#include "vm/ProfilerCapture.h"
+#include "vm/StackTrace.h"
+#include "vm/Type.h"
+
+#include "Baselib.h"
+#include "Cpp/Atomic.h"
+#include "Cpp/ReentrantLock.h"
+
+#include <string.h>
+
+namespace il2cpp
+{
+namespace vm
+{
+    static const uint32_t kRecordsPerBuffer = 4096; // Must be a power of two.
+    static const uint32_t kMaxStackFrames = 32;
+    static const uint32_t kDrainIntervalMs = 20;
+    static const Il2CppProfileFlags kSupportedEvents = (Il2CppProfileFlags)(IL2CPP_PROFILE_ALLOCATIONS | IL2CPP_PROFILE_ENTER_LEAVE | IL2CPP_PROFILE_GC | IL2CPP_PROFILE_THREADS);
+
+    enum CaptureBufferState
+    {
+        kBufferInUse,
+        kBufferRetired, // The owning thread is gone, the buffer is free once drained.
+        kBufferFree
+    };
+
+    // Single producer, single consumer ring. The producer is the owning thread (or whoever holds the GC
+    // lock for the GC buffer) and the consumer is the drain thread. Buffers are never freed: once their
+    // thread ends, they get reused by the next thread that needs one.
+    struct CaptureBuffer
+    {
+        CaptureBuffer* next;
+        baselib::atomic<int32_t> state;
+
+        // Only written by the producer.
+        uint64_t threadId;
+        uint32_t allocationsUntilSample;
+        baselib::atomic<uint32_t> head;
+        baselib::atomic<uint32_t> droppedCount;
+
+        // Only written by the consumer.
+        baselib::atomic<uint32_t> tail;
+        uint32_t reportedDroppedCount;
+
+        CaptureRecord records[kRecordsPerBuffer];
+    };
+
+    Il2CppProfileFlags ProfilerCapture::s_Events;
+
+    static baselib::atomic<CaptureBuffer*> s_Buffers;
+    static CaptureBuffer* s_GCBuffer;
+    static os::ThreadLocalValue s_CurrentThreadBuffer;
+    static uint32_t s_AllocationSampleInterval;
+
+    static baselib::ReentrantLock s_CaptureMutex;
+    static os::Thread* s_DrainThread;
+    static os::Event s_StopDrainThread(true, false);
+    static os::FileHandle* s_File;
+    static bool s_FileFailed;
+
+    // Only touched by the drain thread.
+    typedef Il2CppHashSet<const void*, utils::PointerHash<void> > NamedPointerSet;
+    static NamedPointerSet s_NamedPointers;
+    static utils::dynamic_array<uint8_t> s_Output;
+
+    static CaptureBuffer* AllocateBuffer(uint64_t threadId)
+    {
+        CaptureBuffer* buffer = static_cast<CaptureBuffer*>(IL2CPP_MALLOC_ZERO(sizeof(CaptureBuffer)));
+        buffer->state.store(kBufferInUse, baselib::memory_order_relaxed);
+        buffer->threadId = threadId;
+        buffer->allocationsUntilSample = s_AllocationSampleInterval;
+
+        CaptureBuffer* head = s_Buffers.load(baselib::memory_order_relaxed);
+        do
+        {
+            buffer->next = head;
+        }
+        while (!s_Buffers.compare_exchange_weak(head, buffer, baselib::memory_order_release, baselib::memory_order_relaxed));
+
+        return buffer;
+    }
+
+    static CaptureBuffer* GetCurrentThreadBuffer()
+    {
+        void* value;
+        s_CurrentThreadBuffer.GetValue(&value);
+        if (value != NULL)
+            return static_cast<CaptureBuffer*>(value);
+
+        const uint64_t threadId = os::Thread::CurrentThreadId();
+        CaptureBuffer* buffer = NULL;
+
+        for (CaptureBuffer* candidate = s_Buffers.load(baselib::memory_order_acquire); candidate != NULL; candidate = candidate->next)
+        {
+            int32_t expected = kBufferFree;
+            if (candidate->state.compare_exchange_strong(expected, kBufferInUse, baselib::memory_order_acquire, baselib::memory_order_relaxed))
+            {
+                buffer = candidate;
+                buffer->threadId = threadId;
+                buffer->allocationsUntilSample = s_AllocationSampleInterval;
+                break;
+            }
+        }
+
+        if (buffer == NULL)
+            buffer = AllocateBuffer(threadId);
+
+        s_CurrentThreadBuffer.SetValue(buffer);
+        return buffer;
+    }
+
+    static inline uint32_t GetFreeRecordCount(const CaptureBuffer* buffer)
+    {
+        return kRecordsPerBuffer - (buffer->head.load(baselib::memory_order_relaxed) - buffer->tail.load(baselib::memory_order_acquire));
+    }
+
+    static inline void CountDroppedRecord(CaptureBuffer* buffer)
+    {
+        buffer->droppedCount.store(buffer->droppedCount.load(baselib::memory_order_relaxed) + 1, baselib::memory_order_relaxed);
+    }
+
+    // Callers make sure there is room for the record.
+    static inline void WriteRecord(CaptureBuffer* buffer, uint32_t index, int64_t timestamp, CaptureRecordKind kind, uint64_t data, uint32_t value)
+    {
+        CaptureRecord& record = buffer->records[index & (kRecordsPerBuffer - 1)];
+        record.timestamp = static_cast<uint64_t>(timestamp);
+        record.data = data;
+        record.value = value;
+        record.kind = kind;
+    }
+
+    static void AppendRecord(CaptureBuffer* buffer, CaptureRecordKind kind, uint64_t data, uint32_t value)
+    {
+        if (GetFreeRecordCount(buffer) == 0)
+        {
+            CountDroppedRecord(buffer);
+            return;
+        }
+
+        const uint32_t head = buffer->head.load(baselib::memory_order_relaxed);
+        WriteRecord(buffer, head, os::Time::GetTicks100NanosecondsMonotonic(), kind, data, value);
+        buffer->head.store(head + 1, baselib::memory_order_release);
+    }
+
+    void ProfilerCapture::Allocation(Il2CppObject* obj, Il2CppClass* klass)
+    {
+        CaptureBuffer* buffer = GetCurrentThreadBuffer();
+
+        if (--buffer->allocationsUntilSample != 0)
+            return;
+
+        buffer->allocationsUntilSample = s_AllocationSampleInterval;
+
+        // The allocation and its stack are published together, or not at all.
+        if (GetFreeRecordCount(buffer) < 1 + kMaxStackFrames)
+        {
+            CountDroppedRecord(buffer);
+            return;
+        }
+
+        const int64_t timestamp = os::Time::GetTicks100NanosecondsMonotonic();
+        uint32_t head = buffer->head.load(baselib::memory_order_relaxed);
+
+        WriteRecord(buffer, head++, timestamp, kCaptureRecordAllocation, reinterpret_cast<uintptr_t>(klass), Object::GetSize(obj));
+
+        // The innermost frame is the last one.
+        const StackFrames& frames = *StackTrace::GetStackFrames();
+        uint32_t frameCount = 0;
+        for (StackFrames::const_reverse_iterator frame = frames.rbegin(); frame != frames.rend() && frameCount < kMaxStackFrames; ++frame)
+        {
+            if (frame->method == NULL)
+                continue;
+
+            WriteRecord(buffer, head++, timestamp, kCaptureRecordStackFrame, reinterpret_cast<uintptr_t>(frame->method), 0);
+            frameCount++;
+        }
+
+        buffer->head.store(head, baselib::memory_order_release);
+    }
+
+    void ProfilerCapture::MethodEnter(const MethodInfo* method)
+    {
+        AppendRecord(GetCurrentThreadBuffer(), kCaptureRecordMethodEnter, reinterpret_cast<uintptr_t>(method), 0);
+    }
+
+    void ProfilerCapture::MethodExit(const MethodInfo* method)
+    {
+        AppendRecord(GetCurrentThreadBuffer(), kCaptureRecordMethodExit, reinterpret_cast<uintptr_t>(method), 0);
+    }
+
+    // GC events are raised with the GC lock held, possibly while the world is stopped, so they go to
+    // a shared buffer allocated up front rather than to one that might have to be allocated now.
+    void ProfilerCapture::GCEvent(Il2CppGCEvent eventType)
+    {
+        AppendRecord(s_GCBuffer, kCaptureRecordGCEvent, 0, eventType);
+    }
+
+    void ProfilerCapture::GCHeapResize(int64_t newSize)
+    {
+        AppendRecord(s_GCBuffer, kCaptureRecordGCHeapResize, static_cast<uint64_t>(newSize), 0);
+    }
+
+    void ProfilerCapture::ThreadStart(unsigned long tid)
+    {
+        AppendRecord(GetCurrentThreadBuffer(), kCaptureRecordThreadStart, tid, 0);
+    }
+
+    void ProfilerCapture::ThreadEnd(unsigned long tid)
+    {
+        AppendRecord(GetCurrentThreadBuffer(), kCaptureRecordThreadEnd, tid, 0);
+    }
+
+    void ProfilerCapture::ReleaseCurrentThreadBuffer()
+    {
+        void* value;
+        s_CurrentThreadBuffer.GetValue(&value);
+        CaptureBuffer* buffer = static_cast<CaptureBuffer*>(value);
+
+        // During native thread cleanup the thread local value may already be gone, the buffer is then
+        // found by the id of the thread it was handed to.
+        if (buffer == NULL)
+        {
+            const uint64_t threadId = os::Thread::CurrentThreadId();
+            for (CaptureBuffer* candidate = s_Buffers.load(baselib::memory_order_acquire); candidate != NULL; candidate = candidate->next)
+            {
+                if (candidate != s_GCBuffer && candidate->threadId == threadId && candidate->state.load(baselib::memory_order_acquire) == kBufferInUse)
+                {
+                    buffer = candidate;
+                    break;
+                }
+            }
+        }
+
+        if (buffer == NULL)
+            return;
+
+        buffer->state.store(kBufferRetired, baselib::memory_order_release);
+        s_CurrentThreadBuffer.SetValue(NULL);
+    }
+
+    static void AppendOutput(const void* data, size_t size)
+    {
+        const size_t offset = s_Output.size();
+        s_Output.resize_uninitialized(offset + size, true);
+        memcpy(s_Output.data() + offset, data, size);
+    }
+
+    static void AppendRecordOutput(CaptureRecordKind kind, uint64_t data, uint32_t value)
+    {
+        CaptureRecord record = { 0, data, value, static_cast<uint32_t>(kind) };
+        AppendOutput(&record, sizeof(record));
+    }
+
+    static void AppendNameOutput(const void* pointer, const std::string& name)
+    {
+        static const uint8_t padding[8] = {};
+
+        AppendRecordOutput(kCaptureRecordName, reinterpret_cast<uintptr_t>(pointer), static_cast<uint32_t>(name.length()));
+        AppendOutput(name.c_str(), name.length());
+        AppendOutput(padding, (8 - name.length() % 8) % 8);
+    }
+
+    static void DescribePointer(const CaptureRecord& record)
+    {
+        const void* pointer = reinterpret_cast<const void*>(static_cast<uintptr_t>(record.data));
+
+        switch (record.kind)
+        {
+            case kCaptureRecordAllocation:
+                if (s_NamedPointers.insert(pointer).second)
+                {
+                    const Il2CppClass* klass = static_cast<const Il2CppClass*>(pointer);
+                    AppendNameOutput(pointer, Type::GetCachedName(&klass->byval_arg, IL2CPP_TYPE_NAME_FORMAT_FULL_NAME));
+                }
+                break;
+
+            case kCaptureRecordStackFrame:
+            case kCaptureRecordMethodEnter:
+            case kCaptureRecordMethodExit:
+                if (s_NamedPointers.insert(pointer).second)
+                    AppendNameOutput(pointer, Method::GetFullName(static_cast<const MethodInfo*>(pointer)));
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    static void DrainBuffer(CaptureBuffer* buffer)
+    {
+        // Read the state first: a retired buffer does not get any new records, so once everything
+        // up to the head we are about to read is written out, it can be handed to another thread.
+        const int32_t state = buffer->state.load(baselib::memory_order_acquire);
+        const uint32_t head = buffer->head.load(baselib::memory_order_acquire);
+        const uint32_t tail = buffer->tail.load(baselib::memory_order_relaxed);
+        const uint32_t droppedCount = buffer->droppedCount.load(baselib::memory_order_relaxed) - buffer->reportedDroppedCount;
+
+        if (head != tail || droppedCount != 0)
+        {
+            for (uint32_t i = tail; i != head; ++i)
+                DescribePointer(buffer->records[i & (kRecordsPerBuffer - 1)]);
+
+            AppendRecordOutput(kCaptureRecordChunk, buffer->threadId, head - tail + (droppedCount != 0 ? 1 : 0));
+
+            if (droppedCount != 0)
+                AppendRecordOutput(kCaptureRecordDropped, 0, droppedCount);
+
+            const uint32_t first = tail & (kRecordsPerBuffer - 1);
+            const uint32_t count = head - tail;
+            const uint32_t contiguousCount = count < kRecordsPerBuffer - first ? count : kRecordsPerBuffer - first;
+            AppendOutput(&buffer->records[first], contiguousCount * sizeof(CaptureRecord));
+            AppendOutput(&buffer->records[0], (count - contiguousCount) * sizeof(CaptureRecord));
+
+            buffer->reportedDroppedCount += droppedCount;
+            buffer->tail.store(head, baselib::memory_order_release);
+        }
+
+        if (state == kBufferRetired)
+            buffer->state.store(kBufferFree, baselib::memory_order_release);
+    }
+
+    static void DrainBuffers()
+    {
+        for (CaptureBuffer* buffer = s_Buffers.load(baselib::memory_order_acquire); buffer != NULL; buffer = buffer->next)
+            DrainBuffer(buffer);
+
+        if (s_Output.size() != 0 && !s_FileFailed)
+        {
+            int error;
+            os::File::Write(s_File, reinterpret_cast<const char*>(s_Output.data()), static_cast<int>(s_Output.size()), &error);
+            s_FileFailed = error != os::kErrorCodeSuccess;
+        }
+
+        s_Output.resize_uninitialized(0);
+    }
+
+    // Throws away whatever was recorded while no capture was running.
+    static void DiscardBuffers()
+    {
+        for (CaptureBuffer* buffer = s_Buffers.load(baselib::memory_order_acquire); buffer != NULL; buffer = buffer->next)
+        {
+            const int32_t state = buffer->state.load(baselib::memory_order_acquire);
+
+            buffer->reportedDroppedCount = buffer->droppedCount.load(baselib::memory_order_relaxed);
+            buffer->tail.store(buffer->head.load(baselib::memory_order_acquire), baselib::memory_order_release);
+
+            if (state == kBufferRetired)
+                buffer->state.store(kBufferFree, baselib::memory_order_release);
+        }
+    }
+
+    static void DrainThread(void* arg)
+    {
+        s_DrainThread->SetName("IL2CPP Profiler Capture");
+
+        while (s_StopDrainThread.Wait(kDrainIntervalMs) == kWaitStatusTimeout)
+            DrainBuffers();
+
+        DrainBuffers();
+    }
+
+    bool ProfilerCapture::Start(const char* path, Il2CppProfileFlags events, uint32_t allocationSampleInterval)
+    {
+        os::FastAutoLock lock(&s_CaptureMutex);
+
+        if (s_DrainThread != NULL)
+            return false;
+
+        int error;
+        s_File = os::File::Open(path, kFileModeCreate, kFileAccessWrite, kFileShareRead, kFileOptionsNone, &error);
+        if (error != os::kErrorCodeSuccess)
+            return false;
+
+        s_AllocationSampleInterval = allocationSampleInterval != 0 ? allocationSampleInterval : 1;
+
+        CaptureFileHeader header;
+        memcpy(header.magic, "IL2CPPPC", sizeof(header.magic));
+        header.version = 1;
+        header.recordSize = sizeof(CaptureRecord);
+        header.ticksPerSecond = 10000000;
+        header.allocationSampleInterval = s_AllocationSampleInterval;
+        header.reserved = 0;
+        os::File::Write(s_File, reinterpret_cast<const char*>(&header), sizeof(header), &error);
+        s_FileFailed = error != os::kErrorCodeSuccess;
+
+        if (s_GCBuffer == NULL)
+            s_GCBuffer = AllocateBuffer(0);
+
+        DiscardBuffers();
+        s_NamedPointers.clear();
+
+        s_StopDrainThread.Reset();
+        s_DrainThread = new os::Thread();
+        s_DrainThread->Run(DrainThread, NULL);
+
+        s_Events = (Il2CppProfileFlags)(events & kSupportedEvents);
+        return true;
+    }
+
+    void ProfilerCapture::Stop()
+    {
+        os::FastAutoLock lock(&s_CaptureMutex);
+
+        if (s_DrainThread == NULL)
+            return;
+
+        s_Events = IL2CPP_PROFILE_NONE;
+
+        s_StopDrainThread.Set();
+        s_DrainThread->Join();
+        delete s_DrainThread;
+        s_DrainThread = NULL;
+
+        int error;
+        os::File::Close(s_File, &error);
+        s_File = NULL;
+    }
+} /* namespace vm */
+} /* namespace il2cpp */
+
+#endif // IL2CPP_ENABLE_PROFILER
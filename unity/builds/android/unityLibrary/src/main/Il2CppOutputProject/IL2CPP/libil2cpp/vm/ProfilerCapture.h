@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdint.h>
+#include "il2cpp-config.h"
+
+struct Il2CppClass;
+struct MethodInfo;
+struct Il2CppObject;
+
+namespace il2cpp
+{
+namespace vm
+{
+#if IL2CPP_ENABLE_PROFILER
+
+    // Low overhead alternative to the profiler callbacks: events are appended to a ring buffer owned by
+    // the thread that raised them, and a background thread drains all the buffers into a file.
+    //
+    // File layout (native endianness):
+    //   CaptureFileHeader
+    //   then any number of chunks, each starting with a CaptureRecord of kind kCaptureRecordChunk whose
+    //   data is the id of the thread that produced it (0 for GC events) and whose value is the number of
+    //   records that follow.
+    // Class and method pointers are described once, before their first use, by a kCaptureRecordName
+    // record (data is the pointer, value the name length) followed by the name padded to 8 bytes.
+    // When a buffer is full, events are dropped and the next chunk of that thread starts with a
+    // kCaptureRecordDropped record counting them.
+    enum CaptureRecordKind
+    {
+        kCaptureRecordChunk,
+        kCaptureRecordName,
+        kCaptureRecordDropped,
+        kCaptureRecordAllocation,   // data: class, value: object size in bytes
+        kCaptureRecordStackFrame,   // data: method, follows an allocation, innermost frame first
+        kCaptureRecordMethodEnter,  // data: method
+        kCaptureRecordMethodExit,   // data: method
+        kCaptureRecordGCEvent,      // value: Il2CppGCEvent
+        kCaptureRecordGCHeapResize, // data: new heap size
+        kCaptureRecordThreadStart,  // data: managed thread id
+        kCaptureRecordThreadEnd     // data: managed thread id
+    };
+
+    struct CaptureFileHeader
+    {
+        char magic[8];                      // "IL2CPPPC"
+        uint32_t version;
+        uint32_t recordSize;
+        uint64_t ticksPerSecond;
+        uint32_t allocationSampleInterval;  // one allocation out of this many is recorded
+        uint32_t reserved;
+    };
+
+    struct CaptureRecord
+    {
+        uint64_t timestamp;
+        uint64_t data;
+        uint32_t value;
+        uint32_t kind;
+    };
+
+    class ProfilerCapture
+    {
+    public:
+        // events is a combination of IL2CPP_PROFILE_ALLOCATIONS, IL2CPP_PROFILE_ENTER_LEAVE,
+        // IL2CPP_PROFILE_GC and IL2CPP_PROFILE_THREADS.
+        static bool Start(const char* path, Il2CppProfileFlags events, uint32_t allocationSampleInterval);
+        static void Stop();
+
+        static Il2CppProfileFlags GetEvents() { return s_Events; }
+
+        static void Allocation(Il2CppObject* obj, Il2CppClass* klass);
+        static void MethodEnter(const MethodInfo* method);
+        static void MethodExit(const MethodInfo* method);
+        static void GCEvent(Il2CppGCEvent eventType);
+        static void GCHeapResize(int64_t newSize);
+        static void ThreadStart(unsigned long tid);
+        static void ThreadEnd(unsigned long tid);
+
+        // Called at the end of every thread, whatever is being captured, so that the next thread can reuse the
+        // buffer of this one.
+        static void ReleaseCurrentThreadBuffer();
+
+    private:
+        static Il2CppProfileFlags s_Events;
+    };
+
+#endif
+} /* namespace vm */
+} /* namespace il2cpp */
@@ -0,0 +1,242 @@
+#include "il2cpp-config.h"
+
+#if IL2CPP_ENABLE_PROFILER
+
+#include "os/CpuSampler.h"
+#include "os/Event.h"
+#include "os/File.h"
+#include "os/Mutex.h"
+#include "os/Thread.h"
+#include "os/c-api/OSGlobalEnums.h"
+#include "vm/Method.h"
+#include "vm/ProfilerSampler.h"
+#include "vm/StackTrace.h"
+#include "utils/Logging.h"
+#include "vm-utils/DebugSymbolReader.h"
+#include "vm-utils/NativeSymbol.h"
+
+#include "Baselib.h"
+#include "Cpp/ReentrantLock.h"
+
+#include <map>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+namespace il2cpp
+{
+namespace vm
+{
+    static const uint32_t kAggregationIntervalMs = 50;
+    static const char* const kNativeFrameName = "[native]";
+
+    typedef std::map<const void*, std::string> FrameNameMap;
+    typedef std::map<std::string, uint64_t> StackCountMap;
+
+    static baselib::ReentrantLock s_SamplerMutex;
+    static os::Thread* s_AggregationThread;
+    static os::Event s_StopAggregationThread(true, false);
+    static bool s_IncludeLineNumbers;
+
+    // Only touched by the aggregation thread while it runs.
+    static FrameNameMap s_FrameNames;
+    static StackCountMap s_StackCounts;
+
+    static std::string GetFrameName(const Il2CppStackFrameInfo& frame)
+    {
+        std::string name(Method::GetFullName(frame.method));
+
+        if (s_IncludeLineNumbers && frame.filePath != NULL && frame.sourceCodeLineNumber > 0)
+        {
+            char lineNumber[16];
+            snprintf(lineNumber, sizeof(lineNumber), ":%d", frame.sourceCodeLineNumber);
+
+            name += " (";
+            name += frame.filePath;
+            name += lineNumber;
+            name += ")";
+        }
+
+        return name;
+    }
+
+    // Returns the managed frames at the given address, outermost first and separated by ';' as inlined
+    // methods show up as several frames, or an empty string for native code.
+    static const std::string& ResolveFrame(void* address)
+    {
+        std::pair<FrameNameMap::iterator, bool> entry = s_FrameNames.insert(std::make_pair(address, std::string()));
+        if (!entry.second)
+            return entry.first->second;
+
+#if IL2CPP_ENABLE_NATIVE_STACKTRACES && !RUNTIME_TINY
+        StackFrames frames;
+        if (!utils::DebugSymbolReader::AddStackFrames(address, &frames))
+        {
+            const MethodInfo* method = utils::NativeSymbol::GetMethodFromNativeSymbol(reinterpret_cast<Il2CppMethodPointer>(address));
+            if (method != NULL)
+            {
+                Il2CppStackFrameInfo frame;
+                memset(&frame, 0, sizeof(frame));
+                frame.method = method;
+                frames.push_back(frame);
+            }
+        }
+
+        for (StackFrames::const_iterator frame = frames.begin(); frame != frames.end(); ++frame)
+        {
+            if (frame->method == NULL)
+                continue;
+
+            if (!entry.first->second.empty())
+                entry.first->second += ';';
+            entry.first->second += GetFrameName(*frame);
+        }
+#endif
+
+        return entry.first->second;
+    }
+
+    static void AggregateSample(const os::CpuSample& sample)
+    {
+        std::string stack;
+        bool previousFrameIsNative = false;
+
+        for (uint32_t i = sample.frameCount; i > 0; --i)
+        {
+            // Return addresses point past the call, which is the next function when the call is the last
+            // instruction of the caller, so they are looked up one byte back.
+            void* address = sample.frames[i - 1];
+            if (i > 1)
+                address = static_cast<uint8_t*>(address) - 1;
+
+            const std::string& frame = ResolveFrame(address);
+
+            // Runs of native frames are not interesting on their own and would make every stack unique.
+            const bool isNative = frame.empty();
+            if (isNative && previousFrameIsNative)
+                continue;
+
+            if (!stack.empty())
+                stack += ';';
+            stack += isNative ? kNativeFrameName : frame;
+
+            previousFrameIsNative = isNative;
+        }
+
+        s_StackCounts[stack]++;
+    }
+
+    static void AggregateSamples()
+    {
+        os::CpuSample sample;
+        while (os::CpuSampler::ReadSample(&sample))
+            AggregateSample(sample);
+    }
+
+    static void AggregationThread(void* arg)
+    {
+        s_AggregationThread->SetName("IL2CPP Profiler Sampler");
+
+        while (s_StopAggregationThread.Wait(kAggregationIntervalMs) == kWaitStatusTimeout)
+            AggregateSamples();
+
+        AggregateSamples();
+    }
+
+    static bool WriteCollapsedStacks(const char* path)
+    {
+        int error;
+        os::FileHandle* file = os::File::Open(path, kFileModeCreate, kFileAccessWrite, kFileShareRead, kFileOptionsNone, &error);
+        if (error != os::kErrorCodeSuccess)
+            return false;
+
+        std::string output;
+        char count[24];
+
+        for (StackCountMap::const_iterator stack = s_StackCounts.begin(); stack != s_StackCounts.end(); ++stack)
+        {
+            snprintf(count, sizeof(count), " %llu\n", static_cast<unsigned long long>(stack->second));
+            output += stack->first;
+            output += count;
+        }
+
+        const uint32_t droppedSampleCount = os::CpuSampler::GetDroppedSampleCount();
+        if (droppedSampleCount != 0)
+        {
+            snprintf(count, sizeof(count), " %u\n", droppedSampleCount);
+            output += "[dropped]";
+            output += count;
+        }
+
+        // Not a stack either, the count is of threads rather than samples.
+        const uint32_t unsampledThreadCount = os::CpuSampler::GetUnsampledThreadCount();
+        if (unsampledThreadCount != 0)
+        {
+            snprintf(count, sizeof(count), " %u\n", unsampledThreadCount);
+            output += "[unsampled threads]";
+            output += count;
+        }
+
+        os::File::Write(file, output.c_str(), static_cast<int>(output.length()), &error);
+        const bool written = error == os::kErrorCodeSuccess;
+
+        os::File::Close(file, &error);
+        return written;
+    }
+
+    bool ProfilerSampler::Start(uint32_t intervalMicroseconds, bool includeLineNumbers)
+    {
+#if IL2CPP_ENABLE_NATIVE_STACKTRACES && !RUNTIME_TINY
+        os::FastAutoLock lock(&s_SamplerMutex);
+
+        if (s_AggregationThread != NULL)
+            return false;
+
+        s_IncludeLineNumbers = includeLineNumbers;
+        s_FrameNames.clear();
+        s_StackCounts.clear();
+
+        int error;
+        if (!os::CpuSampler::Start(intervalMicroseconds, &error))
+        {
+            utils::Logging::Write("ERROR: Could not start the CPU sampler with an interval of %u us (error %d)", intervalMicroseconds, error);
+            return false;
+        }
+
+        s_StopAggregationThread.Reset();
+        s_AggregationThread = new os::Thread();
+        s_AggregationThread->Run(AggregationThread, NULL);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool ProfilerSampler::Stop(const char* path)
+    {
+        os::FastAutoLock lock(&s_SamplerMutex);
+
+        if (s_AggregationThread == NULL)
+            return false;
+
+        os::CpuSampler::Stop();
+
+        s_StopAggregationThread.Set();
+        s_AggregationThread->Join();
+        delete s_AggregationThread;
+        s_AggregationThread = NULL;
+
+        const uint32_t unsampledThreadCount = os::CpuSampler::GetUnsampledThreadCount();
+        if (unsampledThreadCount != 0)
+            utils::Logging::Write("WARNING: %u threads were not sampled because all the CPU sampler slots were taken", unsampledThreadCount);
+
+        const bool written = path == NULL || WriteCollapsedStacks(path);
+
+        s_FrameNames.clear();
+        s_StackCounts.clear();
+        return written;
+    }
+} /* namespace vm */
+} /* namespace il2cpp */
+
+#endif // IL2CPP_ENABLE_PROFILER
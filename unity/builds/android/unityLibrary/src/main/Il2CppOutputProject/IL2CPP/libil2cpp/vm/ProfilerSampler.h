@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+#include "il2cpp-config.h"
+
+namespace il2cpp
+{
+namespace vm
+{
+#if IL2CPP_ENABLE_PROFILER
+
+    // Statistical CPU profiler for attached threads. Samples are attributed to managed methods (and to
+    // source lines when debug symbols are available) off the sampled threads, and aggregated into the
+    // collapsed stack format understood by flame graph tools: one "outer;...;inner count" line per stack.
+    class ProfilerSampler
+    {
+    public:
+        static bool Start(uint32_t intervalMicroseconds, bool includeLineNumbers);
+
+        // Writes the aggregated stacks to path, unless it is NULL.
+        static bool Stop(const char* path);
+    };
+
+#endif
+} /* namespace vm */
+} /* namespace il2cpp */
@@ -4,6 +4,7 @@
 #include "il2cpp-tabledefs.h"
 #include "gc/GCHandle.h"
 #include "metadata/GenericMetadata.h"
+#include "vm/Class.h"
 #include "vm/Exception.h"
 #include "vm/Field.h"
 #include "vm/GenericClass.h"
@@ -242,7 +243,7 @@ namespace vm
 
         for (uint16_t i = 0; i < uriMethodCount; i++)
         {
-            const MethodInfo* method = systemUriClass->methods[i];
+            const MethodInfo* method = Class::GetMethodAt(systemUriClass, i);
             if (strcmp(method->name, ".ctor") == 0 && method->parameters_count == 1 && method->parameters[0]->type == IL2CPP_TYPE_STRING)
             {
                 uriConstructor = method;
@@ -497,6 +497,7 @@ namespace vm
         os::Uninitialize();
 
         Reflection::ClearStatics();
+        Type::ClearNameCache();
 
 #if IL2CPP_ENABLE_RELOAD
         if (g_ClearMethodMetadataInitializedFlags != NULL)
@@ -893,82 +894,6 @@ namespace vm
             utils::Runtime::Abort();
     }
 
-    static baselib::ReentrantLock s_TypeInitializationLock;
-
-// We currently call Runtime::ClassInit in 4 places:
-// 1. Just after we allocate storage for a new object (Object::NewAllocSpecific)
-// 2. Just before reading any static field
-// 3. Just before calling any static method
-// 4. Just before calling class instance constructor from a derived class instance constructor
-    void Runtime::ClassInit(Il2CppClass *klass)
-    {
-        // Nothing to do if class has no static constructor or already ran.
-        if (klass->cctor_finished_or_no_cctor)
-            return;
-
-        s_TypeInitializationLock.Acquire();
-
-        // See if some thread ran it while we acquired the lock.
-        if (os::Atomic::CompareExchange(&klass->cctor_finished_or_no_cctor, 1, 1) == 1)
-        {
-            s_TypeInitializationLock.Release();
-            return;
-        }
-
-        // See if some other thread got there first and already started running the constructor.
-        if (os::Atomic::CompareExchange(&klass->cctor_started, 1, 1) == 1)
-        {
-            s_TypeInitializationLock.Release();
-
-            // May have been us and we got here through recursion.
-            os::Thread::ThreadId currentThread = os::Thread::CurrentThreadId();
-            if (os::Atomic::CompareExchangePointer((size_t**)&klass->cctor_thread, (size_t*)currentThread, (size_t*)currentThread) == (size_t*)currentThread)
-                return;
-
-            // Wait for other thread to finish executing the constructor.
-            while (os::Atomic::CompareExchange(&klass->cctor_finished_or_no_cctor, 1, 1) != 1 && os::Atomic::CompareExchange(&klass->initializationExceptionGCHandle, 0, 0) == 0)
-            {
-                os::Thread::Sleep(1);
-            }
-        }
-        else
-        {
-            // Let others know we have started executing the constructor.
-            os::Atomic::ExchangePointer((size_t**)&klass->cctor_thread, (size_t*)os::Thread::CurrentThreadId());
-            os::Atomic::Exchange(&klass->cctor_started, 1);
-
-            s_TypeInitializationLock.Release();
-
-            // Run it.
-            Il2CppException* exception = NULL;
-            const MethodInfo* cctor = Class::GetCCtor(klass);
-            if (cctor != NULL)
-            {
-                vm::Runtime::Invoke(cctor, NULL, NULL, &exception);
-            }
-
-            os::Atomic::ExchangePointer((size_t**)&klass->cctor_thread, (size_t*)0);
-
-            // Deal with exceptions.
-            if (exception == NULL)
-            {
-                // Let other threads know we finished.
-                os::Atomic::Exchange(&klass->cctor_finished_or_no_cctor, 1);
-            }
-            else
-            {
-                const Il2CppType *type = Class::GetType(klass);
-                std::string n = il2cpp::utils::StringUtils::Printf("The type initializer for '%s' threw an exception.", Type::GetName(type, IL2CPP_TYPE_NAME_FORMAT_IL).c_str());
-                Class::SetClassInitializationError(klass, Exception::GetTypeInitializationException(n.c_str(), exception));
-            }
-        }
-
-        if (klass->initializationExceptionGCHandle)
-        {
-            il2cpp::vm::Exception::Raise((Il2CppException*)gc::GCHandle::GetTarget(klass->initializationExceptionGCHandle));
-        }
-    }
-
     struct ConstCharCompare
     {
         bool operator()(char const *a, char const *b) const
@@ -1,4 +1,6 @@
 #include "il2cpp-config.h"
+#include "os/Atomic.h"
+#include "os/CpuSampler.h"
 #include "os/Mutex.h"
 #include "os/Thread.h"
 #include "os/ThreadLocalValue.h"
@@ -44,52 +46,35 @@ namespace vm
 
     static baselib::ReentrantLock s_ThreadMutex;
 
-    static std::vector<int32_t> s_ThreadStaticSizes;
-
     static il2cpp::os::ThreadLocalValue s_CurrentThread;
-    static il2cpp::os::ThreadLocalValue s_StaticData; // Cache the static thread data in a local TLS slot for faster lookup
+    il2cpp::os::ThreadLocalValue Thread::s_StaticData;
 
     static baselib::atomic<int32_t> s_NextManagedThreadId = {0};
 
     /*
-        Thread static data is stored in a two level lookup so we can grow the size at runtime
-        without requiring a lock on looking up static data
-
-        We pre-allocate a fixed number of slot pointers - kMaxThreadStaticSlots at startup.
-        Each of these slots can hold kMaxThreadStaticDataPointers data pointer.  These slots
-        are allocated as needed.
+        Every registered thread static class gets an offset, which is an index into a two level table that
+        each thread has: the upper bits select one of kMaxThreadStaticSlots slots and the lower bits one of
+        the kThreadStaticDataPointersPerSlot data pointers in it. The root table of a thread never moves, so
+        it can be read without a lock.
+
+        Nothing but the root table is allocated when a thread starts. The data of a class, a single block laid
+        out with the GC descriptor of its thread static fields, is allocated the first time the thread touches
+        it. Only the slots are GC roots: the data blocks are kept alive by them and are collected once the
+        thread exits and frees its slots, instead of every thread owning one uncollectable root per class.
     */
 
     const int32_t kMaxThreadStaticSlots = 1024;
-    const int32_t kMaxThreadStaticDataPointers = 1024;
-
-    struct ThreadStaticOffset
-    {
-        uint32_t slot;
-        uint32_t index;
-    };
-
-    static ThreadStaticOffset IndexToStaticFieldOffset(int32_t index)
-    {
-        static_assert(kMaxThreadStaticSlots <= 0xFFFF, "Only 65535 base thread static slots are supported");
-        static_assert(kMaxThreadStaticDataPointers <= 0xFFFF, "Only 65535 thread static slots are supported");
-
-        uint32_t value = (uint32_t)index;
-        ThreadStaticOffset offset;
-        offset.slot = value >> 16;
-        offset.index = value & 0xFFFF;
-        return offset;
-    }
 
-    struct ThreadStaticDataSlot
+    struct ThreadStaticInfo
     {
-        void* data[kMaxThreadStaticSlots];
+        int32_t size;
+        void* gcDescriptor;
     };
 
-    struct ThreadStaticData
-    {
-        ThreadStaticDataSlot* slots[kMaxThreadStaticSlots];
-    };
+    // Registered classes, with the same layout as the per thread tables. Entries are written before their
+    // offset is handed out, and never change afterwards.
+    static ThreadStaticInfo* s_ThreadStaticInfos[kMaxThreadStaticSlots];
+    static baselib::atomic<int32_t> s_ThreadStaticCount = {0};
 
     static void
     set_wbarrier_for_attached_threads()
@@ -199,6 +184,7 @@ namespace vm
 #endif
 
 #if IL2CPP_ENABLE_PROFILER
+        os::CpuSampler::RegisterCurrentThread();
         vm::Profiler::ThreadStart(((unsigned long)thread->GetInternalThread()->tid));
 #endif
 
@@ -245,6 +231,7 @@ namespace vm
 
 #if IL2CPP_ENABLE_PROFILER
         vm::Profiler::ThreadEnd(((unsigned long)thread->GetInternalThread()->tid));
+        os::CpuSampler::UnregisterCurrentThread();
 #endif
 
 #if IL2CPP_MONO_DEBUGGER
@@ -453,68 +440,74 @@ namespace vm
         thread->GetInternalThread()->state &= ~state;
     }
 
-    static void AllocThreadDataSlot(ThreadStaticData* staticData, ThreadStaticOffset offset, int32_t size)
-    {
-        if (staticData->slots[offset.slot] == NULL)
-            staticData->slots[offset.slot] = (ThreadStaticDataSlot*)IL2CPP_CALLOC(1, sizeof(ThreadStaticDataSlot));
-
-        if (staticData->slots[offset.slot]->data[offset.index] == NULL)
-            staticData->slots[offset.slot]->data[offset.index] = gc::GarbageCollector::AllocateFixed(size, NULL);
-    }
-
     void Thread::AllocateStaticDataForCurrentThread()
     {
-        AUTO_LOCK_THREADS();
-        int32_t index = 0;
-
-        // Alloc the slotData along with the first slots at once
-        ThreadStaticData* staticData = (ThreadStaticData*)IL2CPP_CALLOC(1, sizeof(ThreadStaticData) + sizeof(ThreadStaticDataSlot));
-        staticData->slots[0] = (ThreadStaticDataSlot*)(staticData + 1);
+        void*** staticData = (void***)IL2CPP_CALLOC(kMaxThreadStaticSlots, sizeof(void**));
 
         Il2CppThread* thread = Current();
         IL2CPP_ASSERT(!thread->GetInternalThread()->static_data);
         thread->GetInternalThread()->static_data = staticData;
         s_StaticData.SetValue(staticData);
-
-        for (std::vector<int32_t>::const_iterator iter = s_ThreadStaticSizes.begin(); iter != s_ThreadStaticSizes.end(); ++iter)
-        {
-            AllocThreadDataSlot(staticData, IndexToStaticFieldOffset(index), *iter);
-            index++;
-        }
     }
 
-    int32_t Thread::AllocThreadStaticData(int32_t size)
+    int32_t Thread::AllocThreadStaticData(int32_t size, void* gcDescriptor)
     {
         AUTO_LOCK_THREADS();
-        int32_t index = (int32_t)s_ThreadStaticSizes.size();
+        int32_t index = s_ThreadStaticCount.load(baselib::memory_order_relaxed);
 
-        IL2CPP_ASSERT(index < kMaxThreadStaticSlots * kMaxThreadStaticDataPointers);
-        if (index >= kMaxThreadStaticSlots * kMaxThreadStaticDataPointers)
+        IL2CPP_ASSERT(index < kMaxThreadStaticSlots * kThreadStaticDataPointersPerSlot);
+        if (index >= kMaxThreadStaticSlots * kThreadStaticDataPointersPerSlot)
             il2cpp::vm::Exception::Raise(Exception::GetExecutionEngineException("Out of thread static storage slots"));
 
-        s_ThreadStaticSizes.push_back(size);
+        ThreadStaticInfo*& infos = s_ThreadStaticInfos[index >> kThreadStaticSlotShift];
+        if (infos == NULL)
+            infos = (ThreadStaticInfo*)IL2CPP_CALLOC(kThreadStaticDataPointersPerSlot, sizeof(ThreadStaticInfo));
+
+        ThreadStaticInfo& info = infos[index & (kThreadStaticDataPointersPerSlot - 1)];
+        info.size = size;
+        info.gcDescriptor = gcDescriptor;
 
-        ThreadStaticOffset offset = IndexToStaticFieldOffset(index);
+        s_ThreadStaticCount.store(index + 1, baselib::memory_order_release);
 
-        for (GCTrackedThreadVector::const_iterator iter = s_AttachedThreads->begin(); iter != s_AttachedThreads->end(); ++iter)
+        // Threads that are already running pick this up the first time they use it.
+        return index;
+    }
+
+    void* Thread::GetOrAllocateThreadStaticData(int32_t offset, void*** staticData)
+    {
+        IL2CPP_ASSERT(offset >= 0 && offset < s_ThreadStaticCount.load(baselib::memory_order_acquire));
+
+        // Usually called from the thread that owns staticData, but the debugger and reflection can read the
+        // thread statics of other threads, so both allocations below may race with the owner.
+        void*** slotPointer = &staticData[offset >> kThreadStaticSlotShift];
+        void** slot = *slotPointer;
+        if (slot == NULL)
         {
-            Il2CppThread* thread = *iter;
-            ThreadStaticData* staticData = reinterpret_cast<ThreadStaticData*>(thread->GetInternalThread()->static_data);
+            void** newSlot = (void**)gc::GarbageCollector::AllocateFixed(kThreadStaticDataPointersPerSlot * sizeof(void*), NULL);
+            slot = os::Atomic::CompareExchangePointer(slotPointer, newSlot, (void**)NULL);
+            if (slot == NULL)
+                slot = newSlot;
+            else
+                gc::GarbageCollector::FreeFixed(newSlot);
+        }
 
-            if (staticData == NULL)
+        void** dataPointer = &slot[offset & (kThreadStaticDataPointersPerSlot - 1)];
+        void* data = *dataPointer;
+        if (data == NULL)
+        {
+            const ThreadStaticInfo& info = s_ThreadStaticInfos[offset >> kThreadStaticSlotShift][offset & (kThreadStaticDataPointersPerSlot - 1)];
+            void* newData = gc::GarbageCollector::AllocateTyped(info.size, info.gcDescriptor);
+
+            // When we lose the race, newData is unreachable and left to the collector.
+            data = os::Atomic::CompareExchangePointer(dataPointer, newData, (void*)NULL);
+            if (data == NULL)
             {
-                // There is a race on staticData for a thread could be NULL here in two cases
-                // 1. The thread hasn't entered AllocateStaticDataForCurrentThread yet
-                // 2. The thread has exited FreeCurrentThreadStaticData but hasn't been remove from the s_AttachedThreads yet
-                // In both cases we can just continue and in 1. the data will be allocated in AllocateStaticDataForCurrentThread
-                // and in 2. we don't want to allocate anything
-                continue;
+                data = newData;
+                gc::GarbageCollector::SetWriteBarrier(dataPointer);
             }
-
-            AllocThreadDataSlot(staticData, offset, size);
         }
 
-        return index;
+        return data;
     }
 
     void Thread::FreeCurrentThreadStaticData(Il2CppThread *thread, bool inNativeThreadCleanup)
@@ -524,9 +517,11 @@ namespace vm
         // because we can't rely on TLS values being valid
         IL2CPP_ASSERT(inNativeThreadCleanup || thread == Current());
 
+        // GetThreadStaticDataForThread allocates into the tables of other threads, so it must not find this one
+        // half freed.
         AUTO_LOCK_THREADS();
 
-        ThreadStaticData* staticData = reinterpret_cast<ThreadStaticData*>(thread->GetInternalThread()->static_data);
+        void*** staticData = reinterpret_cast<void***>(thread->GetInternalThread()->static_data);
 
         thread->GetInternalThread()->static_data = NULL;
         s_StaticData.SetValue(NULL);
@@ -536,50 +531,24 @@ namespace vm
         if (staticData == NULL)
             return;
 
-        for (int slot = 0; slot < kMaxThreadStaticSlots; slot++)
+        // The data blocks are only referenced from the slots, so the collector reclaims them from here.
+        const int32_t slotCount = (s_ThreadStaticCount.load(baselib::memory_order_acquire) + kThreadStaticDataPointersPerSlot - 1) >> kThreadStaticSlotShift;
+        for (int32_t slot = 0; slot < slotCount; slot++)
         {
-            if (!staticData->slots[slot])
-                break;
-
-            for (int i = 0; i < kMaxThreadStaticDataPointers; i++)
-            {
-                if (staticData->slots[slot]->data[i])
-                    break;
-                gc::GarbageCollector::FreeFixed(staticData->slots[slot]->data[i]);
-            }
-
-            // Don't free the first slot because we allocate the first slot along with the root slots
-            if (slot > 0)
-                IL2CPP_FREE(staticData->slots[slot]);
+            if (staticData[slot] != NULL)
+                gc::GarbageCollector::FreeFixed(staticData[slot]);
         }
 
         IL2CPP_FREE(staticData);
     }
 
-    void* Thread::GetThreadStaticData(int32_t offset)
-    {
-        // No lock. We allocate static_data once with a fixed size so we can read it
-        // safely without a lock here.
-        IL2CPP_ASSERT(offset >= 0 && static_cast<uint32_t>(offset) < s_ThreadStaticSizes.size());
-
-        ThreadStaticOffset staticOffset = IndexToStaticFieldOffset(offset);
-
-        ThreadStaticData* staticData;
-        s_StaticData.GetValue((void**)&staticData);
-        IL2CPP_ASSERT(staticData != NULL);
-
-        return staticData->slots[staticOffset.slot]->data[staticOffset.index];
-    }
-
     void* Thread::GetThreadStaticDataForThread(int32_t offset, Il2CppInternalThread* thread)
     {
-        // No lock. We allocate static_data once with a fixed size so we can read it
-        // safely without a lock here.
-        IL2CPP_ASSERT(offset >= 0 && static_cast<uint32_t>(offset) < s_ThreadStaticSizes.size());
+        // Keeps the thread from freeing its table while we may allocate into it. The owner's own lookups
+        // need no lock, it is the only thread that frees the table.
+        AUTO_LOCK_THREADS();
         IL2CPP_ASSERT(thread->static_data != NULL);
-
-        ThreadStaticOffset staticOffset = IndexToStaticFieldOffset(offset);
-        return reinterpret_cast<ThreadStaticData*>(thread->static_data)->slots[staticOffset.slot]->data[staticOffset.index];
+        return GetOrAllocateThreadStaticData(offset, reinterpret_cast<void***>(thread->static_data));
     }
 
     void Thread::Register(Il2CppThread *thread)
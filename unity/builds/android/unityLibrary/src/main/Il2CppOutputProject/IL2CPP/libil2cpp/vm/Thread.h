@@ -5,6 +5,7 @@
 #include <string>
 #include "il2cpp-config.h"
 #include "os/Thread.h"
+#include "os/ThreadLocalValue.h"
 #include "utils/NonCopyable.h"
 
 struct MethodInfo;
@@ -95,8 +96,9 @@ namespace vm
         static void Uninitialize();
 
         static void AllocateStaticDataForCurrentThread();
-        static int32_t AllocThreadStaticData(int32_t size);
-        static void* GetThreadStaticData(int32_t offset);
+        // gcDescriptor comes from GarbageCollector::MakeDescriptorForTypedMemory, NULL when the data holds no references.
+        static int32_t AllocThreadStaticData(int32_t size, void* gcDescriptor);
+        static inline void* GetThreadStaticData(int32_t offset);
         static void* GetThreadStaticDataForThread(int32_t offset, Il2CppInternalThread* thread);
 
         static void Register(Il2CppThread *thread);
@@ -142,8 +144,34 @@ namespace vm
     private:
         static Il2CppThread* s_MainThread;
         static void FreeCurrentThreadStaticData(Il2CppThread *thread, bool inNativeThreadCleanup);
+
+        // Thread static data is found through a two level table per thread: offset >> kThreadStaticSlotShift
+        // picks a slot of pointers, which point at the data of one class each. Both are allocated the first
+        // time the thread touches them.
+        static const int32_t kThreadStaticSlotShift = 8;
+        static const int32_t kThreadStaticDataPointersPerSlot = 1 << kThreadStaticSlotShift;
+
+        static os::ThreadLocalValue s_StaticData; // Cache the static thread data in a local TLS slot for faster lookup
+        static void* GetOrAllocateThreadStaticData(int32_t offset, void*** staticData);
     };
 
+    inline void* Thread::GetThreadStaticData(int32_t offset)
+    {
+        void*** staticData;
+        s_StaticData.GetValue((void**)&staticData);
+        IL2CPP_ASSERT(staticData != NULL);
+
+        void** slot = staticData[offset >> kThreadStaticSlotShift];
+        if (slot != NULL)
+        {
+            void* data = slot[offset & (kThreadStaticDataPointersPerSlot - 1)];
+            if (data != NULL)
+                return data;
+        }
+
+        return GetOrAllocateThreadStaticData(offset, staticData);
+    }
+
     class ThreadStateSetter : il2cpp::utils::NonCopyable
     {
     public:
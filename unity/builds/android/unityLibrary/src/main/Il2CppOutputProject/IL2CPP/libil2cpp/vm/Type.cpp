@@ -7,6 +7,10 @@
 
 #include "gc/WriteBarrier.h"
 #include "metadata/Il2CppTypeCompare.h"
+#include "os/Atomic.h"
+#include "os/Mutex.h"
+#include "utils/HashUtils.h"
+#include "utils/Memory.h"
 #include "utils/StringUtils.h"
 #include "vm/Assembly.h"
 #include "vm/AssemblyName.h"
@@ -26,6 +30,9 @@
 #include "il2cpp-tabledefs.h"
 #include "vm/Array.h"
 
+#include "Baselib.h"
+#include "Cpp/ReentrantLock.h"
+
 static char* copy_name(const char* name)
 {
     const size_t len = strlen(name);
@@ -621,7 +628,8 @@ namespace vm
                 if (format == IL2CPP_TYPE_NAME_FORMAT_ASSEMBLY_QUALIFIED)
                 {
                     const Il2CppAssembly *ta = elementClass->image->assembly;
-                    str += ", " + vm::AssemblyName::AssemblyNameToString(ta->aname);
+                    str += ", ";
+                    str += vm::AssemblyName::AssemblyNameToString(ta->aname);
                 }
 
                 break;
@@ -644,7 +652,8 @@ namespace vm
                 if (format == IL2CPP_TYPE_NAME_FORMAT_ASSEMBLY_QUALIFIED)
                 {
                     const Il2CppAssembly *ta = elementClass->image->assembly;
-                    str += ", " + vm::AssemblyName::AssemblyNameToString(ta->aname);
+                    str += ", ";
+                    str += vm::AssemblyName::AssemblyNameToString(ta->aname);
                 }
                 break;
             }
@@ -665,7 +674,8 @@ namespace vm
                 if (format == IL2CPP_TYPE_NAME_FORMAT_ASSEMBLY_QUALIFIED)
                 {
                     const Il2CppAssembly *ta = Class::FromIl2CppType(type->data.type)->image->assembly;
-                    str += ", " + vm::AssemblyName::AssemblyNameToString(ta->aname);
+                    str += ", ";
+                    str += vm::AssemblyName::AssemblyNameToString(ta->aname);
                 }
                 break;
             }
@@ -760,7 +770,8 @@ namespace vm
                 if ((format == IL2CPP_TYPE_NAME_FORMAT_ASSEMBLY_QUALIFIED) && (type->type != IL2CPP_TYPE_VAR) && (type->type != IL2CPP_TYPE_MVAR))
                 {
                     const Il2CppAssembly *ta = klass->image->assembly;
-                    str += ", " + vm::AssemblyName::AssemblyNameToString(ta->aname);
+                    str += ", ";
+                    str += vm::AssemblyName::AssemblyNameToString(ta->aname);
                 }
                 break;
             }
@@ -774,6 +785,142 @@ namespace vm
         return str;
     }
 
+    // Interned names, keyed by (type, format). Entries are immutable and stay alive until ClearNameCache,
+    // so lookups probe the table without taking a lock. Inserts serialize on s_TypeNameCacheMutex and
+    // publish a copy twice as large once the table is half full. Superseded tables are kept around because
+    // readers may still be probing them.
+    struct TypeNameCacheEntry
+    {
+        const Il2CppType* type;
+        Il2CppTypeNameFormat format;
+        char name[IL2CPP_ZERO_LEN_ARRAY];
+    };
+
+    struct TypeNameCacheTable
+    {
+        TypeNameCacheTable* previous;
+        size_t mask;
+        size_t count;
+        TypeNameCacheEntry* entries[IL2CPP_ZERO_LEN_ARRAY];
+    };
+
+    static const size_t kInitialTypeNameCacheSize = 256;
+    static TypeNameCacheTable* s_TypeNameCache;
+    static baselib::ReentrantLock s_TypeNameCacheMutex;
+
+    static inline size_t TypeNameCacheHash(const Il2CppType* type, Il2CppTypeNameFormat format)
+    {
+        return utils::HashUtils::Combine(utils::HashUtils::AlignedPointerHash(type), format);
+    }
+
+    static TypeNameCacheTable* NewTypeNameCacheTable(size_t size, TypeNameCacheTable* previous)
+    {
+        const size_t tableSize = sizeof(TypeNameCacheTable) + size * sizeof(TypeNameCacheEntry*);
+        TypeNameCacheTable* table = static_cast<TypeNameCacheTable*>(IL2CPP_MALLOC_ZERO(tableSize));
+        table->previous = previous;
+        table->mask = size - 1;
+        return table;
+    }
+
+    static const TypeNameCacheEntry* FindCachedTypeName(const TypeNameCacheTable* table, const Il2CppType* type, Il2CppTypeNameFormat format)
+    {
+        for (size_t i = TypeNameCacheHash(type, format) & table->mask;; i = (i + 1) & table->mask)
+        {
+            const TypeNameCacheEntry* entry = os::Atomic::LoadPointerAcquire(&table->entries[i]);
+            if (entry == NULL)
+                return NULL;
+
+            if (entry->type == type && entry->format == format)
+                return entry;
+        }
+    }
+
+    static void InsertCachedTypeName(TypeNameCacheTable* table, TypeNameCacheEntry* entry)
+    {
+        size_t i = TypeNameCacheHash(entry->type, entry->format) & table->mask;
+        while (table->entries[i] != NULL)
+            i = (i + 1) & table->mask;
+
+        os::Atomic::StorePointerRelease(&table->entries[i], entry);
+        table->count++;
+    }
+
+    const char* Type::GetCachedName(const Il2CppType* type, Il2CppTypeNameFormat format)
+    {
+        const TypeNameCacheTable* table = os::Atomic::LoadPointerAcquire(&s_TypeNameCache);
+        if (table != NULL)
+        {
+            const TypeNameCacheEntry* entry = FindCachedTypeName(table, type, format);
+            if (entry != NULL)
+                return entry->name;
+        }
+
+        // Build the name outside of the lock, GetNameInternal can initialize classes.
+        std::string name;
+        GetNameInternal(name, type, format, false);
+
+        os::FastAutoLock lock(&s_TypeNameCacheMutex);
+
+        TypeNameCacheTable* currentTable = s_TypeNameCache;
+        if (currentTable == NULL)
+        {
+            currentTable = NewTypeNameCacheTable(kInitialTypeNameCacheSize, NULL);
+            os::Atomic::StorePointerRelease(&s_TypeNameCache, currentTable);
+        }
+
+        // Another thread might have won the race while we were building the name.
+        const TypeNameCacheEntry* existingEntry = FindCachedTypeName(currentTable, type, format);
+        if (existingEntry != NULL)
+            return existingEntry->name;
+
+        if ((currentTable->count + 1) * 2 > currentTable->mask + 1)
+        {
+            TypeNameCacheTable* newTable = NewTypeNameCacheTable((currentTable->mask + 1) * 2, currentTable);
+            for (size_t i = 0; i <= currentTable->mask; i++)
+            {
+                if (currentTable->entries[i] != NULL)
+                    InsertCachedTypeName(newTable, currentTable->entries[i]);
+            }
+
+            os::Atomic::StorePointerRelease(&s_TypeNameCache, newTable);
+            currentTable = newTable;
+        }
+
+        TypeNameCacheEntry* entry = static_cast<TypeNameCacheEntry*>(IL2CPP_MALLOC(sizeof(TypeNameCacheEntry) + name.length() + 1));
+        entry->type = type;
+        entry->format = format;
+        memcpy(entry->name, name.c_str(), name.length() + 1);
+
+        InsertCachedTypeName(currentTable, entry);
+
+        return entry->name;
+    }
+
+    void Type::ClearNameCache()
+    {
+        os::FastAutoLock lock(&s_TypeNameCacheMutex);
+
+        TypeNameCacheTable* table = s_TypeNameCache;
+        if (table != NULL)
+        {
+            // Older tables only hold entries that are also in the newest one.
+            for (size_t i = 0; i <= table->mask; i++)
+            {
+                if (table->entries[i] != NULL)
+                    IL2CPP_FREE(table->entries[i]);
+            }
+        }
+
+        while (table != NULL)
+        {
+            TypeNameCacheTable* previous = table->previous;
+            IL2CPP_FREE(table);
+            table = previous;
+        }
+
+        s_TypeNameCache = NULL;
+    }
+
     enum
     {
         //max digits on uint16 is 5(used to convert the number of generic args) + max 3 other slots taken;
@@ -209,6 +209,10 @@ namespace vm
         // exported
         static void GetNameChunkedRecurse(const Il2CppType * type, Il2CppTypeNameFormat format, void(*reportFunc)(void *data, void *userData), void * userData);
         static std::string GetName(const Il2CppType *type, Il2CppTypeNameFormat format);
+        // Same as GetName, but the name is built once per type and format and lives until ClearNameCache.
+        // Only use it with types owned by the runtime metadata.
+        static const char* GetCachedName(const Il2CppType *type, Il2CppTypeNameFormat format);
+        static void ClearNameCache();
         static int GetType(const Il2CppType *type);
         static Il2CppClass* GetClassOrElementClass(const Il2CppType *type);
         static const Il2CppType* GetUnderlyingType(const Il2CppType *type);
@@ -0,0 +1,247 @@
+#include "il2cpp-config.h"
+#include "il2cpp-class-internals.h"
+#include "il2cpp-object-internals.h"
+#include "il2cpp-runtime-stats.h"
+#include "gc/GCHandle.h"
+#include "os/Atomic.h"
+#include "os/Thread.h"
+#include "os/Time.h"
+#include "vm/Class.h"
+#include "vm/Exception.h"
+#include "vm/Runtime.h"
+#include "vm/Type.h"
+#include "utils/HashUtils.h"
+#include "utils/Il2CppHashMap.h"
+#include "utils/Logging.h"
+#include "utils/StringUtils.h"
+
+#include "Baselib.h"
+#include "Cpp/ConditionVariable.h"
+#include "Cpp/Lock.h"
+
+namespace il2cpp
+{
+namespace vm
+{
+    // A thread that finds a type initializer running on another thread blocks on a condition variable of that
+    // class until it finishes. Classes hash to a stripe whose lock guards their initialization state and the
+    // list of classes that currently have threads waiting on them.
+    struct TypeInitializationWait
+    {
+        TypeInitializationWait(Il2CppClass* klass, baselib::Lock& lock) : klass(klass), finished(lock), waiters(0), next(NULL) {}
+
+        Il2CppClass* klass;
+        baselib::ConditionVariable finished;
+        int32_t waiters;
+        TypeInitializationWait* next;
+    };
+
+    struct TypeInitializationStripe
+    {
+        TypeInitializationStripe() : waits(NULL) {}
+
+        baselib::Lock lock;
+        TypeInitializationWait* waits;
+    };
+
+    static const uint32_t kTypeInitializationStripeBits = 5;
+    static TypeInitializationStripe s_TypeInitializationStripes[1 << kTypeInitializationStripeBits];
+
+    // The class each blocked thread waits on, used to detect cycles between type initializers.
+    typedef Il2CppHashMap<os::Thread::ThreadId, Il2CppClass*, utils::PassThroughHash<os::Thread::ThreadId> > TypeInitializationWaitMap;
+    static baselib::Lock s_TypeInitializationWaitMapLock;
+    static TypeInitializationWaitMap s_TypeInitializationWaitMap;
+
+    static inline TypeInitializationStripe& GetTypeInitializationStripe(Il2CppClass* klass)
+    {
+        const uint32_t hash = (uint32_t)(reinterpret_cast<uintptr_t>(klass) >> 4) * 2654435769u;
+        return s_TypeInitializationStripes[hash >> (32 - kTypeInitializationStripeBits)];
+    }
+
+    static inline os::Thread::ThreadId GetTypeInitializerThread(Il2CppClass* klass)
+    {
+        return (os::Thread::ThreadId)os::Atomic::ReadPointer((size_t**)&klass->cctor_thread);
+    }
+
+    // ECMA-335 II.10.5.3.3: a thread must not wait for a type initializer if the thread running it is, directly
+    // or through other initializing threads, waiting for one the first thread is running. Instead it goes ahead
+    // and may observe the type before its initializer completes, as it does on recursion.
+    static bool TryRegisterTypeInitializationWait(Il2CppClass* klass, os::Thread::ThreadId currentThread)
+    {
+        s_TypeInitializationWaitMapLock.Acquire();
+
+        for (os::Thread::ThreadId owner = GetTypeInitializerThread(klass); owner != 0;)
+        {
+            if (owner == currentThread)
+            {
+                s_TypeInitializationWaitMapLock.Release();
+                return false;
+            }
+
+            TypeInitializationWaitMap::const_iterator ownerWait = s_TypeInitializationWaitMap.find(owner);
+            if (ownerWait == s_TypeInitializationWaitMap.end())
+                break;
+
+            owner = GetTypeInitializerThread(ownerWait->second);
+        }
+
+        s_TypeInitializationWaitMap.add(currentThread, klass);
+        s_TypeInitializationWaitMapLock.Release();
+        return true;
+    }
+
+    static void UnregisterTypeInitializationWait(os::Thread::ThreadId currentThread)
+    {
+        s_TypeInitializationWaitMapLock.Acquire();
+        s_TypeInitializationWaitMap.erase(currentThread);
+        s_TypeInitializationWaitMapLock.Release();
+    }
+
+    static inline bool IsTypeInitializationDone(Il2CppClass* klass)
+    {
+        return os::Atomic::CompareExchange(&klass->cctor_finished_or_no_cctor, 1, 1) == 1 || os::Atomic::CompareExchange(&klass->initializationExceptionGCHandle, 0, 0) != 0;
+    }
+
+    // Called and returns with the stripe lock held.
+    static void WaitForTypeInitializer(TypeInitializationStripe& stripe, Il2CppClass* klass, os::Thread::ThreadId currentThread)
+    {
+        if (!TryRegisterTypeInitializationWait(klass, currentThread))
+            return;
+
+        TypeInitializationWait* wait = stripe.waits;
+        while (wait != NULL && wait->klass != klass)
+            wait = wait->next;
+
+        if (wait == NULL)
+        {
+            wait = new TypeInitializationWait(klass, stripe.lock);
+            wait->next = stripe.waits;
+            stripe.waits = wait;
+        }
+
+        const int64_t waitStart = os::Time::GetTicks100NanosecondsMonotonic();
+
+        wait->waiters++;
+        while (!IsTypeInitializationDone(klass))
+            wait->finished.Wait();
+
+        if (--wait->waiters == 0)
+        {
+            TypeInitializationWait** link = &stripe.waits;
+            while (*link != wait)
+                link = &(*link)->next;
+            *link = wait->next;
+
+            delete wait;
+        }
+
+        il2cpp_runtime_stats.type_initializer_wait_time_usecs += (os::Time::GetTicks100NanosecondsMonotonic() - waitStart) / 10;
+
+        UnregisterTypeInitializationWait(currentThread);
+    }
+
+    static void RunTypeInitializer(TypeInitializationStripe& stripe, Il2CppClass* klass)
+    {
+        const int64_t start = os::Time::GetTicks100NanosecondsMonotonic();
+
+        Il2CppException* exception = NULL;
+        const MethodInfo* cctor = Class::GetCCtor(klass);
+        if (cctor != NULL)
+        {
+            vm::Runtime::Invoke(cctor, NULL, NULL, &exception);
+        }
+
+        // Includes the time spent in the initializers of other types this one triggered.
+        const int64_t elapsedUsecs = (os::Time::GetTicks100NanosecondsMonotonic() - start) / 10;
+        ++il2cpp_runtime_stats.type_initializer_count;
+        il2cpp_runtime_stats.type_initializer_time_usecs += elapsedUsecs;
+
+#if IL2CPP_TRACE_TYPE_INITIALIZERS
+        utils::Logging::Write("Type initializer for '%s' ran in %lld us.", Type::GetName(Class::GetType(klass), IL2CPP_TYPE_NAME_FORMAT_FULL_NAME).c_str(), (long long)elapsedUsecs);
+#endif
+
+        // Deal with exceptions.
+        if (exception != NULL)
+        {
+            const Il2CppType *type = Class::GetType(klass);
+            std::string n = il2cpp::utils::StringUtils::Printf("The type initializer for '%s' threw an exception.", Type::GetName(type, IL2CPP_TYPE_NAME_FORMAT_IL).c_str());
+            Class::SetClassInitializationError(klass, Exception::GetTypeInitializationException(n.c_str(), exception));
+        }
+
+        stripe.lock.Acquire();
+
+        os::Atomic::ExchangePointer((size_t**)&klass->cctor_thread, (size_t*)0);
+
+        // Let other threads know we finished.
+        if (exception == NULL)
+            os::Atomic::Exchange(&klass->cctor_finished_or_no_cctor, 1);
+
+        for (TypeInitializationWait* wait = stripe.waits; wait != NULL; wait = wait->next)
+        {
+            if (wait->klass == klass)
+            {
+                wait->finished.NotifyAll();
+                break;
+            }
+        }
+
+        stripe.lock.Release();
+    }
+
+// We currently call Runtime::ClassInit in 4 places:
+// 1. Just after we allocate storage for a new object (Object::NewAllocSpecific)
+// 2. Just before reading any static field
+// 3. Just before calling any static method
+// 4. Just before calling class instance constructor from a derived class instance constructor
+    void Runtime::ClassInit(Il2CppClass *klass)
+    {
+        // Nothing to do if class has no static constructor or already ran.
+        if (klass->cctor_finished_or_no_cctor)
+            return;
+
+        TypeInitializationStripe& stripe = GetTypeInitializationStripe(klass);
+        stripe.lock.Acquire();
+
+        // See if some thread ran it while we acquired the lock.
+        if (os::Atomic::CompareExchange(&klass->cctor_finished_or_no_cctor, 1, 1) == 1)
+        {
+            stripe.lock.Release();
+            return;
+        }
+
+        const os::Thread::ThreadId currentThread = os::Thread::CurrentThreadId();
+
+        // See if some other thread got there first and already started running the constructor.
+        if (os::Atomic::CompareExchange(&klass->cctor_started, 1, 1) == 1)
+        {
+            // May have been us and we got here through recursion.
+            if (GetTypeInitializerThread(klass) == currentThread)
+            {
+                stripe.lock.Release();
+                return;
+            }
+
+            // Wait for other thread to finish executing the constructor.
+            if (!IsTypeInitializationDone(klass))
+                WaitForTypeInitializer(stripe, klass, currentThread);
+
+            stripe.lock.Release();
+        }
+        else
+        {
+            // Let others know we have started executing the constructor.
+            os::Atomic::ExchangePointer((size_t**)&klass->cctor_thread, (size_t*)currentThread);
+            os::Atomic::Exchange(&klass->cctor_started, 1);
+
+            stripe.lock.Release();
+
+            RunTypeInitializer(stripe, klass);
+        }
+
+        if (klass->initializationExceptionGCHandle)
+        {
+            il2cpp::vm::Exception::Raise((Il2CppException*)gc::GCHandle::GetTarget(klass->initializationExceptionGCHandle));
+        }
+    }
+} /* namespace vm */
+} /* namespace il2cpp */
@@ -0,0 +1,208 @@
+// Times CompareInfo::internal_compare_icall, ordinal and ignoring case, and internal_index_icall, which back
+// String.Compare and IndexOf in the invariant culture, against the way they used to work: one character at a time,
+// and a nested loop searching forward. Strings of 8 to 16384 characters that differ only in their last character,
+// and a search for a value at the very end.
+//
+// First checks that both give the same results for 300k random cases mixing ASCII and other characters, with every
+// combination of options, forward and backward.
+//
+// Linux only, see the Makefile.
+
+#include "il2cpp-config.h"
+#include "icalls/mscorlib/System.Globalization/CompareInfo.h"
+#include "icalls/mscorlib/System.Globalization/CompareOptions.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <wctype.h>
+
+using namespace il2cpp::icalls::mscorlib::System::Globalization;
+
+static const int kRandomCases = 300000;
+
+static double GetTimeNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+static int CompareCharAsItWas(Il2CppChar c1, Il2CppChar c2, int options)
+{
+    if (options & CompareOptions_Ordinal)
+        return (int)(c1 - c2);
+
+    const int result = options & CompareOptions_IgnoreCase ? towlower(c1) - towlower(c2) : (int)(c1 - c2);
+    return result < 0 ? -1 : result > 0 ? 1 : 0;
+}
+
+// internal_compare_icall as it was, for strings of at least one character.
+static int32_t CompareAsItWas(const Il2CppChar* str1, int32_t length1, const Il2CppChar* str2, int32_t length2, int32_t options)
+{
+    const int length = std::max(length1, length2);
+    int pos;
+
+    for (pos = 0; pos != length; pos++)
+    {
+        if (pos >= length1 || pos >= length2)
+            break;
+
+        const int charcmp = CompareCharAsItWas(str1[pos], str2[pos], options);
+        if (charcmp != 0)
+            return charcmp;
+    }
+
+    if (pos == length)
+        return CompareCharAsItWas(str1[pos - 1], str2[pos - 1], options);
+
+    if (pos >= length1)
+        return pos >= length2 ? 0 : -1;
+    if (pos >= length2)
+        return 1;
+
+    return CompareCharAsItWas(str1[pos], str2[pos], options);
+}
+
+// internal_index_icall as it was.
+static int32_t IndexOfAsItWas(const Il2CppChar* source, int32_t sindex, int32_t count, const Il2CppChar* value, int32_t value_length, bool first)
+{
+    if (first)
+    {
+        count -= value_length;
+        for (int pos = sindex; pos <= sindex + count; pos++)
+        {
+            for (int i = 0; source[pos + i] == value[i];)
+            {
+                if (++i == value_length)
+                    return pos;
+            }
+        }
+        return -1;
+    }
+
+    for (int pos = sindex - value_length + 1; pos > sindex - count; pos--)
+    {
+        if (memcmp(source + pos, value, value_length * sizeof(Il2CppChar)) == 0)
+            return pos;
+    }
+    return -1;
+}
+
+static Il2CppChar FlipAsciiCase(Il2CppChar c)
+{
+    return (c | 0x20) >= 'a' && (c | 0x20) <= 'z' ? (Il2CppChar)(c ^ 0x20) : c;
+}
+
+static int CheckRandomCases()
+{
+    static const Il2CppChar kAlphabet[] = { 'a', 'b', 'A', 'B', 'z', 'Z', 0xe9, 0xc9, '0', 0x100 };
+    static const int kOptions[] = { 0, CompareOptions_IgnoreCase, CompareOptions_Ordinal, CompareOptions_IgnoreCase | CompareOptions_Ordinal };
+
+    std::mt19937 random(1);
+    std::vector<Il2CppChar> a(64), b(64), source(96), value(8);
+    int mismatches = 0;
+
+    for (int i = 0; i < kRandomCases; ++i)
+    {
+        // Mostly equal strings, some with the case of a letter flipped, drawn from alphabets of 1 to 10 characters.
+        const int length1 = random() % 40 + 1;
+        const int length2 = random() % 3 == 0 ? length1 : random() % 40 + 1;
+        const int alphabetSize = random() % 10 + 1;
+        for (int j = 0; j < length1; ++j)
+            a[j] = kAlphabet[random() % alphabetSize];
+        for (int j = 0; j < length2; ++j)
+        {
+            if (j < length1 && random() % 8 != 0)
+                b[j] = random() % 4 == 0 ? FlipAsciiCase(a[j]) : a[j];
+            else
+                b[j] = kAlphabet[random() % alphabetSize];
+        }
+
+        const int options = kOptions[random() % 4];
+        mismatches += CompareInfo::internal_compare_icall(&a[0], length1, &b[0], length2, options) != CompareAsItWas(&a[0], length1, &b[0], length2, options);
+
+        // Searches in small alphabets, so that partial matches are common.
+        const int sourceLength = random() % 80 + 1;
+        const int searchAlphabetSize = random() % 3 + 1;
+        for (int j = 0; j < sourceLength; ++j)
+            source[j] = kAlphabet[random() % searchAlphabetSize];
+        const int valueLength = random() % 5 + 1;
+        for (int j = 0; j < valueLength; ++j)
+            value[j] = kAlphabet[random() % searchAlphabetSize];
+
+        const bool first = random() % 2 != 0;
+        const int sindex = random() % sourceLength;
+        const int count = first ? random() % (sourceLength - sindex + 1) : random() % (sindex + 2);
+        if (count < valueLength)
+            continue;
+
+        mismatches += CompareInfo::internal_index_icall(&source[0], sindex, count, &value[0], valueLength, first) != IndexOfAsItWas(&source[0], sindex, count, &value[0], valueLength, first);
+    }
+
+    return mismatches;
+}
+
+static volatile int s_Sink;
+
+template<typename Function>
+static double Time(int iterations, Function function)
+{
+    int sum = 0;
+    const double start = GetTimeNs();
+    for (int i = 0; i < iterations; ++i)
+    {
+        // Keeps the compiler from computing the copies of the old code, which it can see into, only once.
+        __asm__ __volatile__ ("" : : : "memory");
+        sum += function();
+    }
+    s_Sink = sum;
+    return (GetTimeNs() - start) / iterations;
+}
+
+static void TimeLength(int length)
+{
+    std::mt19937 random(length);
+    std::vector<Il2CppChar> x(length), y(length), haystack(length);
+    for (int i = 0; i < length; ++i)
+    {
+        x[i] = y[i] = 'a' + i % 26;
+        haystack[i] = 'a' + random() % 20;
+    }
+    y[length - 1] = 'A' + (length - 1) % 26;
+
+    Il2CppChar needle[] = { 'x', 'y', 'z', 'x', 'y', 'z' };
+    std::copy(needle, needle + 6, haystack.end() - 6);
+
+    const int iterations = std::max(1000, 20000000 / length);
+    Il2CppChar* const px = &x[0];
+    Il2CppChar* const py = &y[0];
+    Il2CppChar* const ph = &haystack[0];
+
+    const double ordinal = Time(iterations, [&] { return CompareInfo::internal_compare_icall(px, length, py, length, CompareOptions_Ordinal); });
+    const double ordinalBefore = Time(iterations, [&] { return CompareAsItWas(px, length, py, length, CompareOptions_Ordinal); });
+    const double ignoreCase = Time(iterations, [&] { return CompareInfo::internal_compare_icall(px, length, py, length, CompareOptions_IgnoreCase); });
+    const double ignoreCaseBefore = Time(iterations, [&] { return CompareAsItWas(px, length, py, length, CompareOptions_IgnoreCase); });
+    const double indexOf = Time(iterations, [&] { return CompareInfo::internal_index_icall(ph, 0, length, needle, 6, true); });
+    const double indexOfBefore = Time(iterations, [&] { return IndexOfAsItWas(ph, 0, length, needle, 6, true); });
+
+    printf("%6d %10.1f -> %8.1f %10.1f -> %8.1f %10.1f -> %8.1f\n", length, ordinalBefore, ordinal, ignoreCaseBefore, ignoreCase, indexOfBefore, indexOf);
+}
+
+int main()
+{
+    const int mismatches = CheckRandomCases();
+    printf("%d random cases, %d differ from before\n", kRandomCases, mismatches);
+
+    printf("\nns per call, before -> now\nlength    ordinal               ignore case           IndexOf\n");
+    const int lengths[] = { 8, 32, 128, 1024, 16384 };
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i)
+        TimeLength(lengths[i]);
+
+    printf(mismatches == 0 ? "PASSED\n" : "FAILED\n");
+    return mismatches == 0 ? 0 : 1;
+}
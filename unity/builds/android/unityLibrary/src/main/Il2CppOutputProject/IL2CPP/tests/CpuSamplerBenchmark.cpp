@@ -0,0 +1,296 @@
+// Measures what os::CpuSampler costs the threads it samples. First the CPU time one SIGPROF takes, then the CPU time 4
+// registered threads need for a fixed amount of work, which goes through a few frames like managed code does, with the
+// sampler off and on at 10 ms and 1 ms intervals of process CPU time. A reader thread drains the samples every 50 ms
+// and counts identical stacks, which is what vm::ProfilerSampler does short of naming the frames; its CPU time is
+// reported on its own.
+//
+// Also checks that threads started once all the registration slots are taken are counted as unsampled.
+//
+// Linux only, see the Makefile, which builds this with frame pointers.
+
+#include "il2cpp-config.h"
+#include "os/CpuSampler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace il2cpp;
+
+static const int kThreadCount = 4;
+static const int kIterations = 50000;
+static const int kRuns = 9;
+
+static int64_t GetTimeNs(clockid_t clock)
+{
+    timespec now;
+    clock_gettime(clock, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+__attribute__((noinline)) static double Leaf(double x)
+{
+    for (int i = 0; i < 1000; ++i)
+        x = x * 1.0000001 + 0.5;
+    return x;
+}
+
+__attribute__((noinline)) static double Middle(double x)
+{
+    return Leaf(x) + 1;
+}
+
+__attribute__((noinline)) static double Top(double x)
+{
+    return Middle(x) * 0.5;
+}
+
+struct Worker
+{
+    double result;
+    int64_t cpuNs;
+};
+
+static void* Work(void* context)
+{
+    Worker& worker = *static_cast<Worker*>(context);
+    os::CpuSampler::RegisterCurrentThread();
+    const int64_t cpuStart = GetTimeNs(CLOCK_THREAD_CPUTIME_ID);
+
+    double x = 0;
+    for (int i = 0; i < kIterations; ++i)
+        x = Top(x);
+    worker.result = x;
+
+    // Includes the time spent in the signal handler, which runs on the interrupted thread.
+    worker.cpuNs = GetTimeNs(CLOCK_THREAD_CPUTIME_ID) - cpuStart;
+    os::CpuSampler::UnregisterCurrentThread();
+    return NULL;
+}
+
+struct Reader
+{
+    std::atomic<bool> stop;
+    uint64_t sampleCount;
+    uint64_t frameCount;
+    int64_t cpuNs;
+};
+
+static void* Read(void* context)
+{
+    Reader& reader = *static_cast<Reader*>(context);
+    const int64_t cpuStart = GetTimeNs(CLOCK_THREAD_CPUTIME_ID);
+
+    std::map<std::string, uint64_t> stackCounts;
+    os::CpuSample sample;
+    for (bool last = false; !last;)
+    {
+        last = reader.stop;
+        while (os::CpuSampler::ReadSample(&sample))
+        {
+            stackCounts[std::string(reinterpret_cast<const char*>(sample.frames), sample.frameCount * sizeof(void*))]++;
+            reader.sampleCount++;
+            reader.frameCount += sample.frameCount;
+        }
+
+        if (!last)
+            usleep(50000);
+    }
+
+    reader.cpuNs += GetTimeNs(CLOCK_THREAD_CPUTIME_ID) - cpuStart;
+    return NULL;
+}
+
+// CPU time of all the workers together. Wall time is at the mercy of how the workers get scheduled, the CPU time
+// they need for the same work much less so.
+static double RunWorkers()
+{
+    pthread_t threads[kThreadCount];
+    Worker workers[kThreadCount];
+
+    for (int i = 0; i < kThreadCount; ++i)
+        pthread_create(&threads[i], NULL, Work, &workers[i]);
+
+    int64_t cpuNs = 0;
+    for (int i = 0; i < kThreadCount; ++i)
+    {
+        pthread_join(threads[i], NULL);
+        cpuNs += workers[i].cpuNs;
+    }
+    return cpuNs / 1e6;
+}
+
+static double Median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+// Alternates runs without and with the sampler, so that both see the same drift of the machine.
+static bool TimeSampled(uint32_t intervalMicroseconds)
+{
+    Reader reader;
+    reader.stop = false;
+    reader.sampleCount = 0;
+    reader.frameCount = 0;
+    reader.cpuNs = 0;
+
+    std::vector<double> unsampledMs, sampledMs;
+    int64_t sampledWallNs = 0;
+
+    for (int run = 0; run < kRuns; ++run)
+    {
+        unsampledMs.push_back(RunWorkers());
+
+        int error;
+        if (!os::CpuSampler::Start(intervalMicroseconds, &error))
+        {
+            printf("FAILED: could not start the sampler, error %d\n", error);
+            return false;
+        }
+
+        reader.stop = false;
+        pthread_t readerThread;
+        pthread_create(&readerThread, NULL, Read, &reader);
+
+        const int64_t start = GetTimeNs(CLOCK_MONOTONIC);
+        sampledMs.push_back(RunWorkers());
+        sampledWallNs += GetTimeNs(CLOCK_MONOTONIC) - start;
+
+        os::CpuSampler::Stop();
+        reader.stop = true;
+        pthread_join(readerThread, NULL);
+    }
+
+    const double unsampled = Median(unsampledMs);
+    const double sampled = Median(sampledMs);
+    const double samplesPerSecond = reader.sampleCount / (sampledWallNs / 1e9);
+
+    // The kernel delivers the timer at most once per tick, which caps the rate of short intervals.
+    printf("every %5u us: %.0f samples per second, %.1f frames each, %u dropped in the last run\n", intervalMicroseconds,
+        samplesPerSecond, reader.sampleCount != 0 ? (double)reader.frameCount / reader.sampleCount : 0.0, os::CpuSampler::GetDroppedSampleCount());
+    printf("  median worker CPU time %.1f ms sampled, %.1f ms not, %+.2f%%; reader CPU %.2f%% of the sampled time\n",
+        sampled, unsampled, (sampled / unsampled - 1) * 100, reader.cpuNs / 1e6 / sampled / kRuns * 100);
+
+    return reader.sampleCount != 0;
+}
+
+static int64_t s_SignalCount;
+
+static void* SignalSelf(void* context)
+{
+    os::CpuSampler::RegisterCurrentThread();
+
+    const int64_t start = GetTimeNs(CLOCK_THREAD_CPUTIME_ID);
+    for (int64_t i = 0; i < s_SignalCount; ++i)
+        raise(SIGPROF);
+    *static_cast<int64_t*>(context) = GetTimeNs(CLOCK_THREAD_CPUTIME_ID) - start;
+
+    os::CpuSampler::UnregisterCurrentThread();
+    return NULL;
+}
+
+// What one SIGPROF costs the thread that takes it, through raise so that the number of signals does not depend on
+// the tick rate. The sampler passes these on to the previous handler, which ignores them, so this covers the
+// system call and the delivery of the signal but not the stack walk, which touches a handful of frames.
+static double MeasureSignalCost()
+{
+    s_SignalCount = 200000;
+    signal(SIGPROF, SIG_IGN);
+
+    int error;
+    os::CpuSampler::Start(10000000, &error);
+
+    pthread_t thread;
+    int64_t cpuNs;
+    pthread_create(&thread, NULL, SignalSelf, &cpuNs);
+    pthread_join(thread, NULL);
+
+    os::CpuSampler::Stop();
+    signal(SIGPROF, SIG_DFL);
+
+    return (double)cpuNs / s_SignalCount;
+}
+
+struct Sleeper
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+    bool release;
+};
+
+static void* Sleep(void* context)
+{
+    Sleeper& sleeper = *static_cast<Sleeper*>(context);
+    os::CpuSampler::RegisterCurrentThread();
+
+    pthread_mutex_lock(&sleeper.mutex);
+    while (!sleeper.release)
+        pthread_cond_wait(&sleeper.condition, &sleeper.mutex);
+    pthread_mutex_unlock(&sleeper.mutex);
+
+    os::CpuSampler::UnregisterCurrentThread();
+    return NULL;
+}
+
+// The sampler has 256 slots. Threads that start after that are not sampled, but counted for as long as the sampler
+// runs, even once they have ended.
+static bool CheckUnsampledThreads()
+{
+    static const int kSlotCount = 256;
+    static const int kExtraThreadCount = 10;
+
+    int error;
+    if (!os::CpuSampler::Start(10000, &error))
+        return false;
+
+    Sleeper sleeper = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, false };
+    std::vector<pthread_t> threads(kSlotCount + kExtraThreadCount);
+    for (size_t i = 0; i < threads.size(); ++i)
+        pthread_create(&threads[i], NULL, Sleep, &sleeper);
+
+    // Wait for every thread to have tried to register.
+    while (os::CpuSampler::GetUnsampledThreadCount() < kExtraThreadCount)
+        usleep(1000);
+
+    pthread_mutex_lock(&sleeper.mutex);
+    sleeper.release = true;
+    pthread_cond_broadcast(&sleeper.condition);
+    pthread_mutex_unlock(&sleeper.mutex);
+    for (size_t i = 0; i < threads.size(); ++i)
+        pthread_join(threads[i], NULL);
+
+    const uint32_t unsampledWhileRunning = os::CpuSampler::GetUnsampledThreadCount();
+    os::CpuSampler::Stop();
+
+    // A new session only counts the threads that cannot register from then on.
+    os::CpuSampler::Start(10000, &error);
+    const uint32_t unsampledInNextSession = os::CpuSampler::GetUnsampledThreadCount();
+    os::CpuSampler::Stop();
+
+    printf("%d threads for %d slots: %u unsampled, %u in the next session\n", (int)threads.size(), kSlotCount, unsampledWhileRunning, unsampledInNextSession);
+    return unsampledWhileRunning == kExtraThreadCount && unsampledInNextSession == 0;
+}
+
+int main()
+{
+    printf("%d threads, %d iterations each, medians of %d runs\n", kThreadCount, kIterations, kRuns);
+
+    const double signalNs = MeasureSignalCost();
+    printf("one signal: %.2f us of CPU time\n", signalNs / 1e3);
+
+    bool passed = TimeSampled(10000);
+    passed = TimeSampled(1000) && passed;
+    passed = CheckUnsampledThreads() && passed;
+
+    printf(passed ? "PASSED\n" : "FAILED\n");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+// Times how long utils::DebugSymbolReader takes to find the line of a native address in a usym table of 1M lines,
+// with the Eytzinger ordered index FindLine builds on its first call against the binary search over the line records
+// it used before, and checks that both find the same line for 2M random addresses and the first and last one.
+//
+// The reader's source is included rather than linked, to reach the table and both searches, which are file local.
+// The table is built in memory the way a mapped usym file lays it out, so nothing is read from disk. Linux only, see
+// the Makefile.
+
+#include "vm-utils/DebugSymbolReader.cpp"
+
+#include <random>
+#include <vector>
+
+#include <stdio.h>
+#include <time.h>
+
+// Only used to load a usym file and to name methods, which the benchmark does not do.
+namespace il2cpp
+{
+namespace os
+{
+    std::string Path::GetApplicationFolder() { return std::string(); }
+    void* Image::GetImageBase() { return NULL; }
+#if IL2CPP_ENABLE_NATIVE_INSTRUCTION_POINTER_EMISSION
+    char* Image::GetImageUUID() { return NULL; }
+#endif
+}
+
+namespace utils
+{
+    void Logging::Write(const char* format, ...) {}
+    std::string Runtime::GetDataDir() { return std::string(); }
+}
+
+namespace vm
+{
+    const MethodInfo* GlobalMetadata::GetMethodInfoFromMethodDefinitionIndex(MethodIndex index) { return NULL; }
+}
+}
+
+using namespace il2cpp::utils;
+
+static const uint32_t kLineCount = 1000000;
+static const size_t kLookupCount = 2000000;
+static const int kRuns = 5;
+
+static int64_t NowNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+template<typename Search>
+static double Time(const std::vector<uint64_t>& addresses, Search search)
+{
+    double best = 1e30;
+    for (int run = 0; run < kRuns; ++run)
+    {
+        uint64_t sum = 0;
+        const int64_t start = NowNs();
+        for (size_t i = 0; i < addresses.size(); ++i)
+            sum += search(addresses[i]);
+        const double ns = (double)(NowNs() - start) / addresses.size();
+
+        // Keeps the compiler from dropping the searches.
+        if (sum == 1)
+            printf("\n");
+        if (ns < best)
+            best = ns;
+    }
+    return best;
+}
+
+static uint32_t SearchIndex(uint64_t address)
+{
+    return FindLine(address).line;
+}
+
+static uint32_t SearchRecords(uint64_t address)
+{
+    return s_usym.lines[FindLineIndexBinarySearch(address)].line;
+}
+
+int main()
+{
+    // About one address in four repeats the previous one, as several lines map to the same instruction.
+    std::mt19937_64 random(1);
+    std::vector<usymliteLine> lines(kLineCount);
+    uint64_t address = 0x100000;
+    for (uint32_t i = 0; i < kLineCount; ++i)
+    {
+        if (random() % 4 != 0)
+            address += 1 + random() % 40;
+        lines[i].address = address;
+        lines[i].methodIndex = 0;
+        lines[i].fileName = 0;
+        lines[i].line = i;
+        lines[i].parent = noLine;
+    }
+
+    s_usym.lines = lines.data();
+    s_usym.header.lineCount = kLineCount;
+    s_usym.firstLineAddress = lines.front().address;
+    s_usym.lastLineAddress = lines.back().address;
+
+    std::vector<uint64_t> addresses(kLookupCount);
+    for (size_t i = 0; i < addresses.size(); ++i)
+        addresses[i] = s_usym.firstLineAddress + random() % (s_usym.lastLineAddress - s_usym.firstLineAddress + 1);
+    addresses.push_back(s_usym.firstLineAddress);
+    addresses.push_back(s_usym.lastLineAddress);
+
+    const int64_t buildStart = NowNs();
+    FindLine(addresses[0]);
+    printf("%u lines, index built in %.1f ms\n", kLineCount, (NowNs() - buildStart) / 1e6);
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < addresses.size(); ++i)
+        mismatches += SearchIndex(addresses[i]) != SearchRecords(addresses[i]);
+
+    printf("binary search of the records %6.1f ns per lookup\n", Time(addresses, SearchRecords));
+    printf("Eytzinger index              %6.1f ns per lookup\n", Time(addresses, SearchIndex));
+    printf("%zu of %zu lookups found a different line\n", mismatches, addresses.size());
+
+    printf(mismatches == 0 ? "PASSED\n" : "FAILED\n");
+    return mismatches == 0 ? 0 : 1;
+}
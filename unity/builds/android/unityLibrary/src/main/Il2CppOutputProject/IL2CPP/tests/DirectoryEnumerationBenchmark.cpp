@@ -0,0 +1,151 @@
+// Times os::Directory::FindFirstFile/FindNextFile, which back MonoIO.FindFirstFile/FindNextFile and so
+// Directory.EnumerateFiles, and os::Directory::GetFileSystemEntries against the way they used to get entry
+// attributes: a stat and an lstat of the full path of every entry (File::GetFileAttributes).
+//
+// Linux only, see the Makefile. Run with an optional scratch directory, /tmp by default.
+
+#include "il2cpp-config.h"
+#include "os/Directory.h"
+#include "os/File.h"
+#include "utils/DirectoryUtils.h"
+#include "utils/PathUtils.h"
+
+#include <set>
+#include <string>
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace il2cpp;
+
+static const int kFileCount = 10000;
+static const int kDirectoryCount = 500;
+static const int kRounds = 20;
+
+static double GetTimeNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+// FindNextFile as it was: match the name, then get the attributes through the full path.
+static int FindAllByPath(const std::string& directory)
+{
+    DIR* dir = opendir(directory.c_str());
+    int count = 0;
+
+    while (dirent* entry = readdir(dir))
+    {
+        if (!utils::Match(entry->d_name, "*"))
+            continue;
+
+        int error;
+        const std::string path = utils::PathUtils::Combine(directory, std::string(entry->d_name));
+        os::File::GetFileAttributes(path, &error);
+        if (error == os::kErrorCodeSuccess)
+            count++;
+    }
+
+    closedir(dir);
+    return count;
+}
+
+static int FindAll(const std::string& directory)
+{
+    const std::string pattern = utils::PathUtils::Combine(directory, std::string("*"));
+    os::Directory::FindHandle handle(utils::StringView<char>(pattern.c_str(), pattern.length()));
+    std::string name;
+    int32_t attributes;
+    int count = 0;
+
+    for (os::ErrorCode error = os::Directory::FindFirstFile(&handle, utils::StringView<char>(pattern.c_str(), pattern.length()), &name, &attributes);
+         error == os::kErrorCodeSuccess;
+         error = os::Directory::FindNextFile(&handle, &name, &attributes))
+    {
+        count++;
+    }
+
+    handle.CloseOSHandle();
+    return count;
+}
+
+// GetFileSystemEntries as it was: collect the names, then stat every one of them through its full path.
+static size_t GetDirectoriesByPath(const std::string& directory)
+{
+    std::set<std::string> names;
+    DIR* dir = opendir(directory.c_str());
+    while (dirent* entry = readdir(dir))
+        names.insert(entry->d_name);
+    closedir(dir);
+
+    std::set<std::string> result;
+    for (std::set<std::string>::const_iterator name = names.begin(); name != names.end(); ++name)
+    {
+        if (*name == "." || *name == "..")
+            continue;
+
+        int error;
+        const std::string path = directory + IL2CPP_DIR_SEPARATOR + *name;
+        const int32_t attributes = static_cast<int32_t>(os::File::GetFileAttributes(path, &error));
+        if (error == os::kErrorCodeSuccess && (attributes & kFileAttributeDirectory) != 0)
+            result.insert(path);
+    }
+
+    return result.size();
+}
+
+static size_t GetDirectories(const std::string& directory)
+{
+    int error;
+    return os::Directory::GetFileSystemEntries(directory, directory + "/*", kFileAttributeDirectory, kFileAttributeDirectory, &error).size();
+}
+
+template<typename Result>
+static void Time(const char* name, Result (*enumerate)(const std::string&), const std::string& directory)
+{
+    Result count = enumerate(directory); // warm the dentry and inode caches
+    const double start = GetTimeNs();
+    for (int round = 0; round < kRounds; round++)
+        count = enumerate(directory);
+    const double elapsed = GetTimeNs() - start;
+
+    printf("  %-36s %8.1f ns per entry (%ld results)\n", name, elapsed / kRounds / (kFileCount + kDirectoryCount), (long)count);
+}
+
+int main(int argc, char** argv)
+{
+    char directory[PATH_MAX];
+    snprintf(directory, sizeof(directory), "%s/il2cpp-direnum-XXXXXX", argc > 1 ? argv[1] : "/tmp");
+    if (mkdtemp(directory) == NULL)
+    {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    char path[PATH_MAX];
+    for (int i = 0; i < kFileCount; i++)
+    {
+        snprintf(path, sizeof(path), "%s/file%05d.txt", directory, i);
+        fclose(fopen(path, "w"));
+    }
+    for (int i = 0; i < kDirectoryCount; i++)
+    {
+        snprintf(path, sizeof(path), "%s/dir%05d", directory, i);
+        mkdir(path, 0755);
+    }
+
+    printf("%d files and %d directories\n", kFileCount, kDirectoryCount);
+    Time("FindNextFile, stat by path", FindAllByPath, directory);
+    Time("FindNextFile, fstatat", FindAll, directory);
+    Time("GetFileSystemEntries, stat by path", GetDirectoriesByPath, directory);
+    Time("GetFileSystemEntries, d_type", GetDirectories, directory);
+
+    char command[PATH_MAX + 16];
+    snprintf(command, sizeof(command), "rm -rf '%s'", directory);
+    return system(command);
+}
@@ -0,0 +1,171 @@
+// Checks the ephemeron passes of the Boehm collector, which back ConditionalWeakTable: that a value is kept while its
+// key is reachable and dropped with it otherwise, and that keys outside the GC heap, as frozen string literals are,
+// count as always reachable instead of crashing the collector. Literals are laid out both in a mapped file, as
+// global-metadata-literals.dat is, and in malloc'd metadata memory.
+//
+// Linux only, see the Makefile.
+
+#include "il2cpp-config.h"
+#include "il2cpp-class-internals.h"
+#include "il2cpp-object-internals.h"
+#include "gc/gc_wrapper.h"
+#include "gc/GarbageCollector.h"
+#include "vm/Domain.h"
+#include "vm/Profiler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+using namespace il2cpp;
+
+static const int kEntryCount = 64;
+static const int kDeadKeyCount = 32;
+
+static Il2CppDomain s_Domain;
+
+namespace il2cpp
+{
+namespace vm
+{
+    Il2CppDomain* Domain::GetCurrent()
+    {
+        return &s_Domain;
+    }
+
+    void Profiler::GCEvent(Il2CppGCEvent eventType) {}
+    void Profiler::GCHeapResize(int64_t size) {}
+}
+
+namespace gc
+{
+    void GarbageCollector::NotifyFinalizers() {}
+}
+}
+
+struct Ephemeron
+{
+    Il2CppObject* key;
+    Il2CppObject* value;
+};
+
+static bool s_Passed = true;
+
+static void Check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        printf("FAILED: %s\n", what);
+        s_Passed = false;
+    }
+}
+
+// Without references, as Class::Init lays out Ephemeron, so that only the ephemeron passes look at the entries.
+static Il2CppArray* NewEphemeronArray(int length)
+{
+    const size_t size = kIl2CppSizeOfArray + length * sizeof(Ephemeron);
+    Il2CppArray* array = (Il2CppArray*)GC_MALLOC_ATOMIC(size);
+    memset(array, 0, size);
+    array->max_length = length;
+    return array;
+}
+
+static Ephemeron* GetEphemerons(Il2CppArray* array)
+{
+    return (Ephemeron*)il2cpp_array_addr_with_size(array, 0, sizeof(Ephemeron));
+}
+
+static Il2CppObject* NewObject()
+{
+    return (Il2CppObject*)GC_MALLOC(sizeof(Il2CppObject) + 16);
+}
+
+// Hidden from the collector so that only the ephemerons decide whether a value stays.
+struct Tracked
+{
+    void* link;
+};
+
+static void Track(Tracked* tracked, Il2CppObject* value)
+{
+    tracked->link = (void*)GC_HIDE_POINTER(value);
+    GC_general_register_disappearing_link(&tracked->link, value);
+}
+
+// Kept out of line, so that no dead key is left in a register or on the stack of main.
+static void __attribute__((noinline)) AddDeadKeys(Ephemeron* ephemerons, Tracked* tracked)
+{
+    for (int i = 0; i < kDeadKeyCount; ++i)
+    {
+        ephemerons[i].key = NewObject();
+        ephemerons[i].value = NewObject();
+        Track(&tracked[i], ephemerons[i].value);
+    }
+}
+
+static void __attribute__((noinline)) AddLiveKeys(Ephemeron* ephemerons, Il2CppObject** keys, Il2CppObject** literals, int literalCount, Tracked* tracked)
+{
+    for (int i = 0; i < kEntryCount - kDeadKeyCount; ++i)
+    {
+        ephemerons[kDeadKeyCount + i].key = i < literalCount ? literals[i] : keys[i];
+        ephemerons[kDeadKeyCount + i].value = NewObject();
+        Track(&tracked[kDeadKeyCount + i], ephemerons[kDeadKeyCount + i].value);
+    }
+}
+
+int main()
+{
+    gc::GarbageCollector::Initialize();
+
+    // Roots, allocated before anything they point to.
+    Il2CppArray** arrayRoot = (Il2CppArray**)GC_MALLOC_UNCOLLECTABLE(sizeof(Il2CppArray*));
+    Il2CppObject** keys = (Il2CppObject**)GC_MALLOC_UNCOLLECTABLE(kEntryCount * sizeof(Il2CppObject*));
+    Tracked* tracked = (Tracked*)GC_MALLOC_ATOMIC_UNCOLLECTABLE(kEntryCount * sizeof(Tracked));
+    memset(tracked, 0, kEntryCount * sizeof(Tracked));
+
+    s_Domain.ephemeron_tombstone = (Il2CppObject*)GC_MALLOC_UNCOLLECTABLE(sizeof(Il2CppObject));
+
+    // Frozen literals: half in a mapped page, half in malloc'd memory, neither known to the collector.
+    const int literalCount = 16;
+    char* mapped = (char*)mmap(NULL, 4096, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    Il2CppObject* literals[literalCount];
+    for (int i = 0; i < literalCount; ++i)
+        literals[i] = i % 2 == 0 ? (Il2CppObject*)(mapped + i * 64) : (Il2CppObject*)calloc(1, 64);
+
+    for (int i = 0; i < kEntryCount; ++i)
+        keys[i] = NewObject();
+
+    *arrayRoot = NewEphemeronArray(kEntryCount);
+    Ephemeron* ephemerons = GetEphemerons(*arrayRoot);
+    AddDeadKeys(ephemerons, tracked);
+    AddLiveKeys(ephemerons, keys, literals, literalCount, tracked);
+    Check(gc::GarbageCollector::EphemeronArrayAdd((Il2CppObject*)*arrayRoot), "EphemeronArrayAdd failed");
+
+    // Several collections, so that both the full scan and the pending entries of later passes see the keys.
+    for (int i = 0; i < 4; ++i)
+        GC_gcollect();
+
+    int cleared = 0;
+    for (int i = 0; i < kDeadKeyCount; ++i)
+        cleared += ephemerons[i].key == s_Domain.ephemeron_tombstone && ephemerons[i].value == NULL;
+
+    int kept = 0;
+    for (int i = kDeadKeyCount; i < kEntryCount; ++i)
+        kept += ephemerons[i].key != s_Domain.ephemeron_tombstone && ephemerons[i].value != NULL && tracked[i].link != NULL;
+
+    int keptLiterals = 0;
+    for (int i = 0; i < literalCount; ++i)
+        keptLiterals += ephemerons[kDeadKeyCount + i].key == literals[i] && tracked[kDeadKeyCount + i].link != NULL;
+
+    printf("%d of %d entries with unreachable keys cleared, %d of %d with reachable keys kept, %d of them keyed by literals\n",
+        cleared, kDeadKeyCount, kept, kEntryCount - kDeadKeyCount, keptLiterals);
+
+    // The stack is scanned conservatively, so a stray copy may keep a dead key alive.
+    Check(cleared >= kDeadKeyCount * 3 / 4, "entries with unreachable keys were kept");
+    Check(kept == kEntryCount - kDeadKeyCount, "entries with reachable keys were cleared");
+    Check(keptLiterals == literalCount, "entries keyed by literals were cleared");
+
+    printf(s_Passed ? "PASSED\n" : "FAILED\n");
+    return s_Passed ? 0 : 1;
+}
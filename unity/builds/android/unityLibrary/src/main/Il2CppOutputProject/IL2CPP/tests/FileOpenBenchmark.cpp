@@ -0,0 +1,251 @@
+// Times os::File::Open and Close, which keep the handles open on each file in maps sharded by device and inode, while
+// 0, 1000 and 8000 other files are open, against the way they used to check sharing: walking one list of every open
+// handle under a single lock.
+//
+// Also checks the sharing rules, that IsHandleOpenFileHandle knows which handles are open, and that threads racing to
+// open one file without sharing never get two handles to it at once.
+//
+// Linux only, see the Makefile. Run with an optional scratch directory, /tmp by default.
+
+#include "il2cpp-config.h"
+#include "os/ErrorCodes.h"
+#include "os/File.h"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace il2cpp;
+
+static const int kOpenCounts[] = { 0, 1000, 8000 };
+static const int kRounds = 20000;
+static const int kRaceThreadCount = 4;
+static const int kRaceRounds = 20000;
+
+static double GetTimeNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+struct ListedHandle
+{
+    dev_t device;
+    ino_t inode;
+    int fd;
+    const ListedHandle* oldest;
+};
+
+// The handles as they used to be kept, with the lock that every open and close took.
+static std::mutex s_ListMutex;
+static std::list<ListedHandle> s_List;
+
+// Open as it was: find the oldest handle on the same file by walking every open handle.
+static std::list<ListedHandle>::iterator ListOpen(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(s_ListMutex);
+    ListedHandle handle;
+    handle.fd = open(path.c_str(), O_RDONLY);
+
+    struct stat fileStat;
+    fstat(handle.fd, &fileStat);
+    handle.device = fileStat.st_dev;
+    handle.inode = fileStat.st_ino;
+
+    handle.oldest = NULL;
+    for (std::list<ListedHandle>::iterator it = s_List.begin(); it != s_List.end(); ++it)
+    {
+        if (it->device == handle.device && it->inode == handle.inode)
+        {
+            handle.oldest = &*it;
+            break;
+        }
+    }
+
+    s_List.push_back(handle);
+    return --s_List.end();
+}
+
+static void ListClose(std::list<ListedHandle>::iterator handle)
+{
+    std::lock_guard<std::mutex> lock(s_ListMutex);
+    close(handle->fd);
+    s_List.erase(handle);
+}
+
+static std::string CreateFile(const std::string& directory, int index)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/file%d", index);
+    const std::string path = directory + name;
+
+    int error;
+    os::FileHandle* handle = os::File::Open(path, kFileModeCreate, kFileAccessWrite, kFileShareNone, 0, &error);
+    os::File::Close(handle, &error);
+    return path;
+}
+
+static void TimeOpen(const std::string& directory, int openCount)
+{
+    std::vector<os::FileHandle*> openHandles;
+    std::vector<std::list<ListedHandle>::iterator> listedHandles;
+    for (int i = 0; i < openCount; ++i)
+    {
+        int error;
+        const std::string path = CreateFile(directory, i + 1);
+        openHandles.push_back(os::File::Open(path, kFileModeOpen, kFileAccessRead, kFileShareRead, 0, &error));
+        listedHandles.push_back(ListOpen(path));
+    }
+
+    const std::string path = CreateFile(directory, 0);
+
+    double start = GetTimeNs();
+    for (int i = 0; i < kRounds; ++i)
+    {
+        int error;
+        os::FileHandle* handle = os::File::Open(path, kFileModeOpen, kFileAccessRead, kFileShareRead, 0, &error);
+        os::File::Close(handle, &error);
+    }
+    const double fileNs = (GetTimeNs() - start) / kRounds;
+
+    start = GetTimeNs();
+    for (int i = 0; i < kRounds; ++i)
+        ListClose(ListOpen(path));
+    const double listNs = (GetTimeNs() - start) / kRounds;
+
+    printf("%5d other files open: %8.0f ns per open and close, %8.0f ns walking a list\n", openCount, fileNs, listNs);
+
+    for (int i = 0; i < openCount; ++i)
+    {
+        int error;
+        os::File::Close(openHandles[i], &error);
+        ListClose(listedHandles[i]);
+    }
+}
+
+static bool CheckSharing(const std::string& directory)
+{
+    const std::string path = CreateFile(directory, 0);
+    bool passed = true;
+    int error;
+
+    os::FileHandle* exclusive = os::File::Open(path, kFileModeOpen, kFileAccessRead, kFileShareNone, 0, &error);
+    os::File::Open(path, kFileModeOpen, kFileAccessRead, kFileShareRead, 0, &error);
+    passed = error == il2cpp::os::kErrorCodeSharingViolation && passed;
+    passed = os::File::IsHandleOpenFileHandle((intptr_t)exclusive) && passed;
+    os::File::Close(exclusive, &error);
+
+    os::FileHandle* first = os::File::Open(path, kFileModeOpen, kFileAccessRead, kFileShareRead, 0, &error);
+    passed = error == il2cpp::os::kErrorCodeSuccess && passed;
+    os::FileHandle* second = os::File::Open(path, kFileModeOpen, kFileAccessRead, kFileShareRead, 0, &error);
+    passed = error == il2cpp::os::kErrorCodeSuccess && passed;
+
+    // The oldest handle decides: it does not share writing, so a writer is turned away.
+    os::File::Open(path, kFileModeOpen, kFileAccessWrite, kFileShareReadWrite, 0, &error);
+    passed = error == il2cpp::os::kErrorCodeSharingViolation && passed;
+
+    int notAHandle;
+    passed = !os::File::IsHandleOpenFileHandle((intptr_t)&notAHandle) && passed;
+    os::File::Close(first, &error);
+    os::File::Close(second, &error);
+
+    printf("sharing rules: %s\n", passed ? "kept" : "broken");
+    return passed;
+}
+
+struct Race
+{
+    std::string path;
+    std::atomic<int> holders;
+    std::atomic<int> overlaps;
+    std::atomic<int> opens;
+};
+
+static void* OpenExclusively(void* context)
+{
+    Race& race = *static_cast<Race*>(context);
+    for (int i = 0; i < kRaceRounds; ++i)
+    {
+        int error;
+        os::FileHandle* handle = os::File::Open(race.path, kFileModeOpen, kFileAccessRead, kFileShareNone, 0, &error);
+        if (error != il2cpp::os::kErrorCodeSuccess)
+            continue;
+
+        if (race.holders.fetch_add(1) != 0)
+            race.overlaps++;
+        race.opens++;
+        race.holders--;
+        os::File::Close(handle, &error);
+    }
+    return NULL;
+}
+
+static bool CheckExclusiveRace(const std::string& directory)
+{
+    Race race;
+    race.path = CreateFile(directory, 0);
+    race.holders = 0;
+    race.overlaps = 0;
+    race.opens = 0;
+
+    pthread_t threads[kRaceThreadCount];
+    for (int i = 0; i < kRaceThreadCount; ++i)
+        pthread_create(&threads[i], NULL, OpenExclusively, &race);
+    for (int i = 0; i < kRaceThreadCount; ++i)
+        pthread_join(threads[i], NULL);
+
+    printf("%d threads opening one file without sharing: %d opens, %d while another handle was open\n", kRaceThreadCount, race.opens.load(), race.overlaps.load());
+    return race.overlaps == 0 && race.opens > 0;
+}
+
+int main(int argc, char** argv)
+{
+    // Each open file takes two descriptors, one for File and one for the list.
+    rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+
+    char directory[256];
+    snprintf(directory, sizeof(directory), "%s/il2cpp-file-open-XXXXXX", argc > 1 ? argv[1] : "/tmp");
+    if (mkdtemp(directory) == NULL)
+    {
+        printf("FAILED: could not create a scratch directory in %s\n", argc > 1 ? argv[1] : "/tmp");
+        return 1;
+    }
+
+    for (size_t i = 0; i < sizeof(kOpenCounts) / sizeof(kOpenCounts[0]); ++i)
+    {
+        if ((rlim_t)kOpenCounts[i] * 2 + 64 > limit.rlim_cur)
+        {
+            printf("%5d other files open: skipped, only %llu descriptors allowed\n", kOpenCounts[i], (unsigned long long)limit.rlim_cur);
+            continue;
+        }
+        TimeOpen(directory, kOpenCounts[i]);
+    }
+
+    bool passed = CheckSharing(directory);
+    passed = CheckExclusiveRace(directory) && passed;
+
+    for (int i = 0; i <= kOpenCounts[sizeof(kOpenCounts) / sizeof(kOpenCounts[0]) - 1]; ++i)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "/file%d", i);
+        unlink((std::string(directory) + name).c_str());
+    }
+    rmdir(directory);
+
+    printf(passed ? "PASSED\n" : "FAILED\n");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,548 @@
+// First checks which records os::FileSystemWatcher::CoalesceEvents keeps of hand made inotify buffers. Then creates
+// and modifies 10000 files, watched the way System.IO.FileSystemWatcher watches them: once through the System.Native
+// inotify entry points of libil2cpp (watcher mode 6), once by polling like the class libraries' DefaultWatcher (watcher
+// mode 0), with the tree left alone for a few seconds in between. Checks that every change is reported by the inotify
+// watcher, and that it is both faster to notice changes and cheaper in CPU time than polling.
+//
+// Linux only, see the Makefile. Run with an optional scratch directory, /tmp by default.
+
+#include "il2cpp-config.h"
+#include "os/FileSystemWatcher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+extern "C"
+{
+    intptr_t SystemNative_INotifyInit(void);
+    int32_t SystemNative_INotifyAddWatch(intptr_t fd, const char* pathName, uint32_t mask);
+    int32_t SystemNative_INotifyRemoveWatch(intptr_t fd, int32_t wd);
+    int32_t SystemNative_Read(intptr_t fd, void* buffer, int32_t bufferSize);
+}
+
+static const int kDirectoryCount = 10;
+static const int kFilesPerDirectory = 1000;
+static const int kFileCount = kDirectoryCount * kFilesPerDirectory;
+
+// Same as the class libraries: the mask of a watcher on all notify filters, and the sleep between DefaultWatcher scans.
+static const uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_EXCL_UNLINK | IN_ONLYDIR;
+static const int kPollIntervalMs = 750;
+static const int kReadBufferSize = 16384;
+
+static const int kIdleMs = 5000;
+
+static const char* kSentinelName = "done";
+
+static int64_t NowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int64_t ThreadCpuNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+struct Run
+{
+    std::string root;
+
+    // When the writer made each change, and when the watcher first reported it. Index is the file number.
+    std::vector<int64_t> createdAt;
+    std::vector<int64_t> modifiedAt;
+    std::vector<int64_t> createSeenAt;
+    std::vector<int64_t> modifySeenAt;
+
+    std::atomic<bool> ready;
+    // Set once every creation has been reported, writing the contents of a new file is not the change measured.
+    std::atomic<bool> modifying;
+    int64_t watcherCpuNs;
+    bool failed;
+
+    explicit Run(const std::string& rootPath)
+        : root(rootPath), createdAt(kFileCount), modifiedAt(kFileCount), createSeenAt(kFileCount, 0), modifySeenAt(kFileCount, 0),
+        ready(false), modifying(false), watcherCpuNs(0), failed(false)
+    {
+    }
+};
+
+// Appends one record, with the name padded to 16 bytes like the kernel does.
+static void AddEvent(std::vector<uint8_t>* events, int32_t wd, uint32_t mask, const char* name, uint32_t cookie = 0)
+{
+    const uint32_t nameLength = name == NULL ? 0 : 16;
+    const size_t offset = events->size();
+    events->resize(offset + sizeof(inotify_event) + nameLength, 0);
+
+    inotify_event* event = reinterpret_cast<inotify_event*>(&(*events)[offset]);
+    event->wd = wd;
+    event->mask = mask;
+    event->cookie = cookie;
+    event->len = nameLength;
+    if (name != NULL)
+        strncpy(event->name, name, nameLength - 1);
+}
+
+static std::string DescribeEvents(const uint8_t* events, int32_t length)
+{
+    std::string description;
+    for (int32_t offset = 0; offset < length;)
+    {
+        const inotify_event* event = reinterpret_cast<const inotify_event*>(events + offset);
+        offset += sizeof(inotify_event) + event->len;
+
+        char record[64];
+        snprintf(record, sizeof(record), "%s%d:%s:%x", description.empty() ? "" : " ", event->wd, event->len == 0 ? "-" : event->name, event->mask);
+        description += record;
+    }
+    return description;
+}
+
+static bool CheckCoalesced(const char* label, std::vector<uint8_t> events, const std::vector<uint8_t>& expected)
+{
+    const int32_t length = il2cpp::os::FileSystemWatcher::CoalesceEvents(&events[0], (int32_t)events.size());
+    const std::string kept = DescribeEvents(&events[0], length);
+    const std::string wanted = DescribeEvents(&expected[0], (int32_t)expected.size());
+    if (kept == wanted)
+        return true;
+
+    printf("FAILED: %s kept [%s], expected [%s]\n", label, kept.c_str(), wanted.c_str());
+    return false;
+}
+
+static bool CheckCoalesceEvents()
+{
+    bool passed = true;
+    std::vector<uint8_t> events, expected;
+
+    // Repeated modify and attrib records of one entry collapse into the first, other entries are not affected.
+    AddEvent(&events, 1, IN_CREATE, "a");
+    AddEvent(&events, 1, IN_MODIFY, "a");
+    AddEvent(&events, 1, IN_MODIFY, "a");
+    AddEvent(&events, 1, IN_ATTRIB, "a");
+    AddEvent(&events, 1, IN_MODIFY, "b");
+    AddEvent(&events, 2, IN_MODIFY, "a");
+    AddEvent(&events, 1, IN_MODIFY, "b");
+    AddEvent(&expected, 1, IN_CREATE, "a");
+    AddEvent(&expected, 1, IN_MODIFY, "a");
+    AddEvent(&expected, 1, IN_MODIFY, "b");
+    AddEvent(&expected, 2, IN_MODIFY, "a");
+    passed &= CheckCoalesced("repeated changes", events, expected);
+
+    // A change after anything else is reported again, so the order of create, modify and delete survives.
+    events.clear();
+    expected.clear();
+    AddEvent(&events, 1, IN_MODIFY, "a");
+    AddEvent(&events, 1, IN_DELETE, "a");
+    AddEvent(&events, 1, IN_MODIFY, "a");
+    AddEvent(&events, 1, IN_MODIFY, "a");
+    AddEvent(&expected, 1, IN_MODIFY, "a");
+    AddEvent(&expected, 1, IN_DELETE, "a");
+    AddEvent(&expected, 1, IN_MODIFY, "a");
+    passed &= CheckCoalesced("change after delete", events, expected);
+
+    // Both halves of a rename are kept with their cookie, and so is the change of the renamed entry in between,
+    // even when the same name was changed before.
+    events.clear();
+    expected.clear();
+    AddEvent(&events, 1, IN_MODIFY, "a");
+    AddEvent(&events, 1, IN_MOVED_FROM, "a", 7);
+    AddEvent(&events, 1, IN_MOVED_TO, "b", 7);
+    AddEvent(&events, 1, IN_MODIFY, "b");
+    AddEvent(&events, 1, IN_MOVED_FROM, "b", 8);
+    AddEvent(&events, 2, IN_MOVED_TO, "a", 8);
+    AddEvent(&events, 1, IN_MODIFY, "a");
+    AddEvent(&expected, 1, IN_MODIFY, "a");
+    AddEvent(&expected, 1, IN_MOVED_FROM, "a", 7);
+    AddEvent(&expected, 1, IN_MOVED_TO, "b", 7);
+    AddEvent(&expected, 1, IN_MODIFY, "b");
+    AddEvent(&expected, 1, IN_MOVED_FROM, "b", 8);
+    AddEvent(&expected, 2, IN_MOVED_TO, "a", 8);
+    AddEvent(&expected, 1, IN_MODIFY, "a");
+    passed &= CheckCoalesced("renames", events, expected);
+
+    // Changes of the watched directory itself have no name, and are told apart from those of its entries.
+    events.clear();
+    expected.clear();
+    AddEvent(&events, 1, IN_ATTRIB | IN_ISDIR, NULL);
+    AddEvent(&events, 1, IN_ATTRIB, "a");
+    AddEvent(&events, 1, IN_ATTRIB | IN_ISDIR, NULL);
+    AddEvent(&expected, 1, IN_ATTRIB | IN_ISDIR, NULL);
+    AddEvent(&expected, 1, IN_ATTRIB, "a");
+    passed &= CheckCoalesced("watched directory", events, expected);
+
+    // Overflow notifications, which have no watch, are never dropped, even back to back.
+    events.clear();
+    expected.clear();
+    AddEvent(&events, 1, IN_MODIFY, "a");
+    AddEvent(&events, -1, IN_Q_OVERFLOW, NULL);
+    AddEvent(&events, -1, IN_Q_OVERFLOW, NULL);
+    AddEvent(&events, 1, IN_MODIFY, "a");
+    AddEvent(&expected, 1, IN_MODIFY, "a");
+    AddEvent(&expected, -1, IN_Q_OVERFLOW, NULL);
+    AddEvent(&expected, -1, IN_Q_OVERFLOW, NULL);
+    passed &= CheckCoalesced("overflow", events, expected);
+
+    // A record cut off at the end of the buffer is left out rather than read past the end.
+    events.clear();
+    expected.clear();
+    AddEvent(&events, 1, IN_CREATE, "a");
+    AddEvent(&events, 1, IN_CREATE, "b");
+    events.resize(events.size() - 4);
+    AddEvent(&expected, 1, IN_CREATE, "a");
+    passed &= CheckCoalesced("truncated buffer", events, expected);
+
+    // Past the entries it indexes, the rest of a buffer is passed through as is.
+    events.clear();
+    expected.clear();
+    char name[16];
+    for (int i = 0; i < 3000; ++i)
+    {
+        snprintf(name, sizeof(name), "f%d", i);
+        AddEvent(&events, 1, IN_MODIFY, name);
+        AddEvent(&expected, 1, IN_MODIFY, name);
+        if (i == 0)
+            AddEvent(&events, 1, IN_MODIFY, name);
+    }
+    AddEvent(&events, 1, IN_MODIFY, "f0");
+    AddEvent(&expected, 1, IN_MODIFY, "f0");
+    passed &= CheckCoalesced("large buffer", events, expected);
+
+    return passed;
+}
+
+static std::string DirectoryPath(const Run& run, int directory)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/d%d", directory);
+    return run.root + name;
+}
+
+static int FileNumber(int directory, const char* name)
+{
+    if (name[0] != 'f')
+        return -1;
+    return directory * kFilesPerDirectory + atoi(name + 1);
+}
+
+static void Record(std::vector<int64_t>& seenAt, int file)
+{
+    if (file >= 0 && file < kFileCount && seenAt[file] == 0)
+        seenAt[file] = NowNs();
+}
+
+// What FileSystemWatcher does in mode 6, reduced to the bookkeeping this test needs.
+static void* INotifyWatcher(void* context)
+{
+    Run& run = *static_cast<Run*>(context);
+    const int64_t cpuStart = ThreadCpuNs();
+
+    const intptr_t handle = SystemNative_INotifyInit();
+    if (handle == -1)
+    {
+        printf("SystemNative_INotifyInit failed: %s\n", strerror(errno));
+        run.failed = true;
+        run.ready = true;
+        return NULL;
+    }
+
+    std::map<int32_t, int> directories;
+    const int32_t rootWatch = SystemNative_INotifyAddWatch(handle, run.root.c_str(), kWatchMask);
+    for (int d = 0; d < kDirectoryCount; ++d)
+        directories[SystemNative_INotifyAddWatch(handle, DirectoryPath(run, d).c_str(), kWatchMask)] = d;
+    run.ready = true;
+
+    std::vector<uint8_t> buffer(kReadBufferSize);
+    bool done = false;
+    while (!done)
+    {
+        const int32_t length = SystemNative_Read(handle, &buffer[0], kReadBufferSize);
+        if (length <= 0)
+        {
+            printf("SystemNative_Read returned %d: %s\n", length, strerror(errno));
+            run.failed = true;
+            break;
+        }
+
+        for (int32_t offset = 0; offset < length;)
+        {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(&buffer[offset]);
+            offset += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                printf("inotify queue overflowed\n");
+                run.failed = true;
+                continue;
+            }
+
+            if (event->wd == rootWatch)
+            {
+                done = done || (event->len != 0 && strcmp(event->name, kSentinelName) == 0);
+                continue;
+            }
+
+            std::map<int32_t, int>::const_iterator directory = directories.find(event->wd);
+            if (directory == directories.end() || event->len == 0)
+                continue;
+
+            const int file = FileNumber(directory->second, event->name);
+            if (event->mask & IN_CREATE)
+                Record(run.createSeenAt, file);
+            if ((event->mask & IN_MODIFY) && run.modifying)
+                Record(run.modifySeenAt, file);
+        }
+    }
+
+    run.watcherCpuNs = ThreadCpuNs() - cpuStart;
+    // SafeFileHandle closes the instance through MonoIO, which this test does not link. Process exit closes it.
+    return NULL;
+}
+
+// What FileSystemWatcher does in mode 0: a scan of every watched directory, comparing write times, then a sleep.
+static void* PollingWatcher(void* context)
+{
+    Run& run = *static_cast<Run*>(context);
+    const int64_t cpuStart = ThreadCpuNs();
+
+    std::vector<int64_t> lastWrite(kFileCount, -1);
+    bool initialScan = true;
+    bool done = false;
+    while (!done)
+    {
+        for (int d = 0; d < kDirectoryCount; ++d)
+        {
+            const std::string path = DirectoryPath(run, d);
+            DIR* dir = opendir(path.c_str());
+            if (dir == NULL)
+                continue;
+
+            while (struct dirent* entry = readdir(dir))
+            {
+                const int file = FileNumber(d, entry->d_name);
+                if (file < 0 || file >= kFileCount)
+                    continue;
+
+                struct stat statbuf;
+                if (stat((path + "/" + entry->d_name).c_str(), &statbuf) != 0)
+                    continue;
+
+                const int64_t writeTime = (int64_t)statbuf.st_mtim.tv_sec * 1000000000 + statbuf.st_mtim.tv_nsec;
+                if (lastWrite[file] == -1)
+                    Record(run.createSeenAt, file);
+                else if (lastWrite[file] != writeTime && run.modifying)
+                    Record(run.modifySeenAt, file);
+                lastWrite[file] = writeTime;
+            }
+            closedir(dir);
+        }
+
+        struct stat statbuf;
+        done = stat((run.root + "/" + kSentinelName).c_str(), &statbuf) == 0;
+
+        if (initialScan)
+        {
+            initialScan = false;
+            run.ready = true;
+        }
+
+        if (!done)
+            usleep(kPollIntervalMs * 1000);
+    }
+
+    run.watcherCpuNs = ThreadCpuNs() - cpuStart;
+    return NULL;
+}
+
+static void WriteFile(const std::string& path, const char* contents, int flags)
+{
+    const int fd = open(path.c_str(), O_WRONLY | flags, 0644);
+    if (fd == -1 || write(fd, contents, strlen(contents)) < 0)
+    {
+        printf("Writing %s failed: %s\n", path.c_str(), strerror(errno));
+        exit(1);
+    }
+    close(fd);
+}
+
+static void MakeFileName(char* name, size_t size, int file)
+{
+    snprintf(name, size, "/f%d", file % kFilesPerDirectory);
+}
+
+static void RunWriter(Run& run)
+{
+    char name[32];
+    for (int i = 0; i < kFileCount; ++i)
+    {
+        MakeFileName(name, sizeof(name), i);
+        run.createdAt[i] = NowNs();
+        WriteFile(DirectoryPath(run, i / kFilesPerDirectory) + name, "created\n", O_CREAT | O_TRUNC);
+    }
+
+    // Nothing changes for a while, which is how a watched tree spends most of its time. It also gives the polling
+    // watcher time to see the files before they change.
+    usleep(kIdleMs * 1000);
+    run.modifying = true;
+
+    for (int i = 0; i < kFileCount; ++i)
+    {
+        MakeFileName(name, sizeof(name), i);
+        run.modifiedAt[i] = NowNs();
+        WriteFile(DirectoryPath(run, i / kFilesPerDirectory) + name, "modified\n", O_APPEND);
+    }
+
+    usleep(2 * kPollIntervalMs * 1000);
+    WriteFile(run.root + "/" + kSentinelName, "", O_CREAT | O_TRUNC);
+}
+
+static void CreateTree(const Run& run)
+{
+    if (mkdir(run.root.c_str(), 0755) != 0)
+    {
+        printf("Creating %s failed: %s\n", run.root.c_str(), strerror(errno));
+        exit(1);
+    }
+    for (int d = 0; d < kDirectoryCount; ++d)
+        mkdir(DirectoryPath(run, d).c_str(), 0755);
+}
+
+static void RemoveTree(const Run& run)
+{
+    char name[32];
+    for (int i = 0; i < kFileCount; ++i)
+    {
+        MakeFileName(name, sizeof(name), i);
+        unlink((DirectoryPath(run, i / kFilesPerDirectory) + name).c_str());
+    }
+    for (int d = 0; d < kDirectoryCount; ++d)
+        rmdir(DirectoryPath(run, d).c_str());
+    unlink((run.root + "/" + kSentinelName).c_str());
+    rmdir(run.root.c_str());
+}
+
+struct Latency
+{
+    int missed;
+    double medianMs;
+    double p99Ms;
+    double maxMs;
+};
+
+static void AddDelays(const std::vector<int64_t>& changedAt, const std::vector<int64_t>& seenAt, std::vector<int64_t>* delays, int* missed)
+{
+    for (int i = 0; i < kFileCount; ++i)
+    {
+        if (seenAt[i] == 0)
+            ++*missed;
+        else
+            delays->push_back(std::max<int64_t>(0, seenAt[i] - changedAt[i]));
+    }
+}
+
+static Latency Measure(const std::vector<int64_t>& unsortedDelays, int missed)
+{
+    Latency latency = { missed, 0, 0, 0 };
+    std::vector<int64_t> delays = unsortedDelays;
+
+    if (!delays.empty())
+    {
+        std::sort(delays.begin(), delays.end());
+        latency.medianMs = delays[delays.size() / 2] / 1e6;
+        latency.p99Ms = delays[delays.size() * 99 / 100] / 1e6;
+        latency.maxMs = delays.back() / 1e6;
+    }
+    return latency;
+}
+
+// latency covers both the creations and the modifications. The polling watcher notices a burst of changes somewhere
+// within one interval depending on when its scans fall, over both bursts its tail is comparable from run to run.
+static bool RunWatcher(const char* label, const std::string& root, void* (*watcher)(void*), Latency* latency, int64_t* cpuNs)
+{
+    Run run(root);
+    CreateTree(run);
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, watcher, &run);
+    while (!run.ready)
+        usleep(1000);
+
+    RunWriter(run);
+    pthread_join(thread, NULL);
+    RemoveTree(run);
+
+    std::vector<int64_t> createDelays, modifyDelays;
+    int createMissed = 0, modifyMissed = 0;
+    AddDelays(run.createdAt, run.createSeenAt, &createDelays, &createMissed);
+    AddDelays(run.modifiedAt, run.modifySeenAt, &modifyDelays, &modifyMissed);
+
+    const Latency created = Measure(createDelays, createMissed);
+    const Latency modified = Measure(modifyDelays, modifyMissed);
+    createDelays.insert(createDelays.end(), modifyDelays.begin(), modifyDelays.end());
+    *latency = Measure(createDelays, createMissed + modifyMissed);
+    *cpuNs = run.watcherCpuNs;
+
+    printf("%-8s created: missed %d, median %.2f ms, p99 %.2f ms, max %.2f ms\n", label, created.missed, created.medianMs, created.p99Ms, created.maxMs);
+    printf("%-8s modified: missed %d, median %.2f ms, p99 %.2f ms, max %.2f ms\n", label, modified.missed, modified.medianMs, modified.p99Ms, modified.maxMs);
+    printf("%-8s watcher CPU time %.1f ms\n", label, *cpuNs / 1e6);
+
+    return !run.failed && latency->missed == 0;
+}
+
+int main(int argc, char** argv)
+{
+    const std::string scratch = argc > 1 ? argv[1] : "/tmp";
+    char root[64];
+    snprintf(root, sizeof(root), "/fsw-test-%d", (int)getpid());
+
+    Latency inotifyLatency, pollingLatency;
+    int64_t inotifyCpuNs, pollingCpuNs;
+
+    if (!CheckCoalesceEvents())
+    {
+        printf("FAILED\n");
+        return 1;
+    }
+
+    bool passed = RunWatcher("inotify", scratch + root + "-inotify", INotifyWatcher, &inotifyLatency, &inotifyCpuNs);
+    if (!passed)
+        printf("FAILED: the inotify watcher missed changes\n");
+
+    if (!RunWatcher("polling", scratch + root + "-polling", PollingWatcher, &pollingLatency, &pollingCpuNs))
+        printf("note: the polling watcher missed changes, write times may be too coarse on this file system\n");
+
+    if (inotifyLatency.p99Ms >= pollingLatency.p99Ms)
+    {
+        printf("FAILED: inotify p99 latency %.2f ms is not below the polling p99 %.2f ms\n", inotifyLatency.p99Ms, pollingLatency.p99Ms);
+        passed = false;
+    }
+
+    if (inotifyCpuNs >= pollingCpuNs)
+    {
+        printf("FAILED: inotify watcher CPU time %.1f ms is not below polling %.1f ms\n", inotifyCpuNs / 1e6, pollingCpuNs / 1e6);
+        passed = false;
+    }
+
+    printf(passed ? "PASSED\n" : "FAILED\n");
+    return passed ? 0 : 1;
+}
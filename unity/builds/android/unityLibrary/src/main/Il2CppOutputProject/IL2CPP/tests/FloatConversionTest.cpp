@@ -0,0 +1,241 @@
+// Checks utils::FloatConversion against the C library: that FormatRoundTrip writes text strtod and strtof read back
+// to the same bits, that its digits are the shortest that do (the fewest %.*e digits that round trip), and that
+// Parse reads its own text, %.17g and %.9g text, and random decimal strings of up to 40 digits with exponents up to
+// +-350 to the same bits as strtod and strtof. Random bit patterns include subnormals and short decimals. Also
+// checks the layout of the "R" format for a few values and where Parse stops.
+//
+// Linux only, see the Makefile. Run with an optional number of random cases per check, 1000000 by default.
+
+#include "il2cpp-config.h"
+#include "utils/FloatConversion.h"
+
+#include <cmath>
+#include <random>
+#include <string>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace il2cpp::utils;
+
+static long s_Failures;
+
+static void Fail(const char* what, const char* text)
+{
+    if (s_Failures++ < 20)
+        printf("FAILED: %s: %s\n", what, text);
+}
+
+template<typename T>
+static bool SameBits(T a, T b)
+{
+    return memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+static double ParseWithC(const char* text, double*)
+{
+    return strtod(text, NULL);
+}
+
+static float ParseWithC(const char* text, float*)
+{
+    return strtof(text, NULL);
+}
+
+// The digits of the shortest %.*e text of value that reads back to it, without trailing zeros.
+template<typename T>
+static std::string ShortestDigitsWithC(T value, int maxDigits)
+{
+    char text[64];
+    for (int precision = 1; precision <= maxDigits; ++precision)
+    {
+        snprintf(text, sizeof(text), "%.*e", precision - 1, (double)value);
+        if (ParseWithC(text, (T*)NULL) == value)
+            break;
+    }
+
+    std::string digits;
+    for (const char* c = text; *c != '\0' && *c != 'e'; ++c)
+    {
+        if (*c >= '0' && *c <= '9')
+            digits += *c;
+    }
+    while (digits.size() > 1 && digits[digits.size() - 1] == '0')
+        digits.erase(digits.size() - 1);
+    return digits;
+}
+
+template<typename T>
+static void CheckValue(T value, bool checkShortest, const char* referenceFormat, int maxDigits)
+{
+    char text[64];
+    const int32_t length = FloatConversion::FormatRoundTrip(value, text);
+    text[length] = '\0';
+
+    if (!SameBits(ParseWithC(text, (T*)NULL), value))
+        Fail("the C library reads FormatRoundTrip text back differently", text);
+
+    T parsed;
+    if (FloatConversion::Parse(text, length, &parsed) != length || !SameBits(parsed, value))
+        Fail("Parse reads FormatRoundTrip text back differently", text);
+
+    char reference[64];
+    const int referenceLength = snprintf(reference, sizeof(reference), referenceFormat, (double)value);
+    if (FloatConversion::Parse(reference, referenceLength, &parsed) != referenceLength || !SameBits(parsed, value))
+        Fail("Parse reads printf text differently", reference);
+
+    if (checkShortest && value != 0)
+    {
+        uint64_t significand;
+        int32_t exponent;
+        FloatConversion::ShortestDecimal(std::fabs(value), &significand, &exponent);
+
+        char digits[32];
+        snprintf(digits, sizeof(digits), "%llu", (unsigned long long)significand);
+        if (ShortestDigitsWithC(std::fabs(value), maxDigits) != digits)
+            Fail("ShortestDecimal digits are not the shortest", text);
+    }
+}
+
+static void CheckDoubles(long count, std::mt19937_64& random)
+{
+    for (long i = 0; i < count; ++i)
+    {
+        uint64_t bits = random();
+        if (i % 4 == 1)
+        {
+            // Subnormals and the smallest normal exponents.
+            bits &= 0x800FFFFFFFFFFFFFULL | ((uint64_t)(random() % 8) << 52);
+        }
+        else if (i % 4 == 2)
+        {
+            // Integers and short decimals.
+            const double value = (double)(int64_t)(random() % 2000000) / (1 << (random() % 20));
+            memcpy(&bits, &value, sizeof(bits));
+        }
+
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (std::isfinite(value))
+            CheckValue(value, i % 10 == 0, "%.17g", 17);
+    }
+}
+
+static void CheckFloats(long count, std::mt19937_64& random)
+{
+    for (long i = 0; i < count; ++i)
+    {
+        uint32_t bits = (uint32_t)random();
+        if (i % 4 == 1)
+            bits &= 0x807FFFFFu | ((uint32_t)(random() % 4) << 23);
+
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        if (std::isfinite(value))
+            CheckValue(value, i % 10 == 0, "%.9g", 9);
+    }
+}
+
+static void CheckDecimalStrings(long count, std::mt19937_64& random)
+{
+    std::basic_string<Il2CppChar> wide;
+    for (long i = 0; i < count; ++i)
+    {
+        std::string text;
+        if (random() % 2)
+            text += '-';
+        const int digits = 1 + random() % (i % 10 == 0 ? 40 : 20);
+        const int point = random() % (digits + 1);
+        for (int d = 0; d < digits; ++d)
+        {
+            if (d == point && d != 0)
+                text += '.';
+            text += (char)('0' + random() % 10);
+        }
+        if (random() % 4)
+        {
+            char exponent[16];
+            snprintf(exponent, sizeof(exponent), "e%d", (int)(random() % 700) - 350);
+            text += exponent;
+        }
+
+        double value;
+        if (FloatConversion::Parse(text.c_str(), (int32_t)text.size(), &value) != (int32_t)text.size() || !SameBits(value, strtod(text.c_str(), NULL)))
+            Fail("Parse differs from strtod", text.c_str());
+
+        if (i % 4 == 0)
+        {
+            float single;
+            FloatConversion::Parse(text.c_str(), (int32_t)text.size(), &single);
+            if (!SameBits(single, strtof(text.c_str(), NULL)))
+                Fail("Parse differs from strtof", text.c_str());
+
+            wide.assign(text.begin(), text.end());
+            if (FloatConversion::Parse(wide.c_str(), (int32_t)wide.size(), &value) != (int32_t)wide.size() || !SameBits(value, strtod(text.c_str(), NULL)))
+                Fail("Parse of UTF-16 text differs from strtod", text.c_str());
+        }
+    }
+}
+
+static void CheckLayout()
+{
+    struct DoubleCase { double value; const char* expected; };
+    static const DoubleCase kDoubles[] =
+    {
+        { 0.0, "0" }, { -0.0, "-0" }, { 1.0, "1" }, { 0.1, "0.1" }, { 100.0, "100" }, { 1e14, "100000000000000" },
+        { 1e15, "1E+15" }, { 1e-4, "0.0001" }, { 1e-5, "1E-05" }, { 123456789012345.6, "123456789012345.6" },
+        { 0.30000000000000004, "0.30000000000000004" }, { 5e-324, "5E-324" },
+        { 1.7976931348623157e308, "1.7976931348623157E+308" }, { -2.2250738585072014e-308, "-2.2250738585072014E-308" },
+        { INFINITY, "Infinity" }, { -INFINITY, "-Infinity" }, { NAN, "NaN" },
+    };
+    struct FloatCase { float value; const char* expected; };
+    static const FloatCase kFloats[] =
+    {
+        { 1e6f, "1000000" }, { 1e7f, "1E+07" }, { 0.1f, "0.1" }, { 1e-5f, "1E-05" }, { 16777216.0f, "1.6777216E+07" },
+        { 3.4028235e38f, "3.4028235E+38" }, { 1e-45f, "1E-45" },
+    };
+
+    char text[64];
+    for (size_t i = 0; i < sizeof(kDoubles) / sizeof(kDoubles[0]); ++i)
+    {
+        text[FloatConversion::FormatRoundTrip(kDoubles[i].value, text)] = '\0';
+        if (strcmp(text, kDoubles[i].expected) != 0)
+            Fail("FormatRoundTrip layout", text);
+    }
+    for (size_t i = 0; i < sizeof(kFloats) / sizeof(kFloats[0]); ++i)
+    {
+        text[FloatConversion::FormatRoundTrip(kFloats[i].value, text)] = '\0';
+        if (strcmp(text, kFloats[i].expected) != 0)
+            Fail("FormatRoundTrip layout", text);
+    }
+
+    // How many characters Parse takes, 0 when the text does not start with a number.
+    struct ParseCase { const char* text; int32_t expected; };
+    static const ParseCase kParses[] =
+    {
+        { ".5", 2 }, { "5.", 2 }, { ".", 0 }, { "-.e1", 0 }, { "e5", 0 }, { ".5e", 2 }, { "1e+", 1 },
+        { "+1.5E+3x", 7 }, { "1e400", 5 },
+    };
+    for (size_t i = 0; i < sizeof(kParses) / sizeof(kParses[0]); ++i)
+    {
+        double value;
+        if (FloatConversion::Parse(kParses[i].text, (int32_t)strlen(kParses[i].text), &value) != kParses[i].expected)
+            Fail("Parse took the wrong number of characters", kParses[i].text);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const long count = argc > 1 ? atol(argv[1]) : 1000000;
+    std::mt19937_64 random(42);
+
+    CheckLayout();
+    CheckDoubles(count, random);
+    CheckFloats(count, random);
+    CheckDecimalStrings(count, random);
+
+    printf("%ld random doubles, floats and decimal strings each: %ld failures\n", count, s_Failures);
+    printf(s_Failures == 0 ? "PASSED\n" : "FAILED\n");
+    return s_Failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+// Checks os::File::ReadAt, WriteAt, ReadScatter, WriteGather and Advise: that they read and write at the position
+// they are given and leave the handle's own position alone, that 8 threads can read one handle at random positions at
+// once, that scatter reads stop short at the end of the file, and that invalid handles and handles opened without
+// the access they need are turned away.
+//
+// Linux only, see the Makefile. Run with an optional scratch directory, /tmp by default.
+
+#include "il2cpp-config.h"
+#include "os/ErrorCodes.h"
+#include "os/File.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace il2cpp;
+
+static const uint32_t kWordCount = 1 << 20;
+static const int kThreadCount = 8;
+static const int kReadsPerThread = 10000;
+
+static bool s_Passed = true;
+
+static void Check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        printf("FAILED: %s\n", what);
+        s_Passed = false;
+    }
+}
+
+// The file holds the words 0, 1, 2, ... so every 4 byte aligned position tells what should be read there.
+static bool WriteWords(os::FileHandle* handle)
+{
+    std::vector<uint32_t> words(kWordCount);
+    for (uint32_t i = 0; i < kWordCount; ++i)
+        words[i] = i;
+
+    // Written back to front in two halves, which WriteAt has to put in place without seeking.
+    const int half = kWordCount / 2 * sizeof(uint32_t);
+    int error;
+    return os::File::WriteAt(handle, reinterpret_cast<const char*>(&words[kWordCount / 2]), half, half, &error) == half
+        && os::File::WriteAt(handle, reinterpret_cast<const char*>(&words[0]), half, 0, &error) == half;
+}
+
+struct Reader
+{
+    os::FileHandle* handle;
+    uint32_t seed;
+    std::atomic<int>* failures;
+};
+
+static void* ReadRandomly(void* context)
+{
+    Reader& reader = *static_cast<Reader*>(context);
+    uint32_t random = reader.seed;
+
+    for (int i = 0; i < kReadsPerThread; ++i)
+    {
+        random = random * 1103515245 + 12345;
+        const uint32_t index = (random >> 8) % (kWordCount - 4);
+
+        uint32_t words[4];
+        int error;
+        const int read = os::File::ReadAt(reader.handle, reinterpret_cast<char*>(words), sizeof(words), (int64_t)index * sizeof(uint32_t), &error);
+        if (read != sizeof(words) || words[0] != index || words[3] != index + 3)
+            (*reader.failures)++;
+    }
+
+    return NULL;
+}
+
+static void CheckConcurrentReads(os::FileHandle* handle)
+{
+    std::atomic<int> failures(0);
+    Reader readers[kThreadCount];
+    pthread_t threads[kThreadCount];
+
+    for (int i = 0; i < kThreadCount; ++i)
+    {
+        readers[i].handle = handle;
+        readers[i].seed = i * 7 + 1;
+        readers[i].failures = &failures;
+        pthread_create(&threads[i], NULL, ReadRandomly, &readers[i]);
+    }
+    for (int i = 0; i < kThreadCount; ++i)
+        pthread_join(threads[i], NULL);
+
+    printf("%d threads, %d random reads each: %d wrong\n", kThreadCount, kReadsPerThread, failures.load());
+    Check(failures == 0, "concurrent ReadAt returned the wrong data");
+}
+
+static void CheckScatterGather(os::FileHandle* handle)
+{
+    int error;
+
+    // Three buffers of odd sizes, so the words straddle them.
+    char first[3], second[5], third[8];
+    os::FileIOBuffer buffers[] = { { first, sizeof(first) }, { second, sizeof(second) }, { third, sizeof(third) } };
+    Check(os::File::ReadScatter(handle, buffers, 3, 4, &error) == 16, "ReadScatter read a short count");
+
+    uint32_t words[4];
+    memcpy(words, first, 3);
+    memcpy(reinterpret_cast<char*>(words) + 3, second, 5);
+    memcpy(reinterpret_cast<char*>(words) + 8, third, 8);
+    Check(words[0] == 1 && words[1] == 2 && words[2] == 3 && words[3] == 4, "ReadScatter filled the buffers wrongly");
+
+    // At the end of the file the read stops short, without an error.
+    const int64_t end = (int64_t)kWordCount * sizeof(uint32_t);
+    Check(os::File::ReadScatter(handle, buffers, 3, end - 6, &error) == 6 && error == il2cpp::os::kErrorCodeSuccess, "ReadScatter at the end of the file");
+
+    // Gathered from odd sizes, read back whole.
+    const char patch[] = "0123456789abcdef";
+    os::FileIOBuffer patchBuffers[] = { { const_cast<char*>(patch), 7 }, { const_cast<char*>(patch) + 7, 9 } };
+    Check(os::File::WriteGather(handle, patchBuffers, 2, 4096, &error) == 16, "WriteGather wrote a short count");
+
+    char readBack[16];
+    Check(os::File::ReadAt(handle, readBack, 16, 4096, &error) == 16 && memcmp(readBack, patch, 16) == 0, "WriteGather wrote the wrong data");
+
+    // Many more buffers than one preadv takes.
+    std::vector<uint32_t> many(1000);
+    std::vector<os::FileIOBuffer> manyBuffers(many.size());
+    for (size_t i = 0; i < many.size(); ++i)
+    {
+        manyBuffers[i].buffer = reinterpret_cast<char*>(&many[i]);
+        manyBuffers[i].count = sizeof(uint32_t);
+    }
+    Check(os::File::ReadScatter(handle, &manyBuffers[0], (int32_t)manyBuffers.size(), 8192 * sizeof(uint32_t), &error) == (int64_t)(many.size() * sizeof(uint32_t)), "ReadScatter of 1000 buffers read a short count");
+    Check(many[0] == 8192 && many[999] == 8192 + 999, "ReadScatter of 1000 buffers filled them wrongly");
+}
+
+static void CheckRejected()
+{
+    int error;
+    char buffer[4];
+    os::FileIOBuffer buffers[] = { { buffer, sizeof(buffer) } };
+
+    Check(os::File::ReadAt(NULL, buffer, 4, 0, &error) == 0 && error == il2cpp::os::kErrorCodeInvalidHandle, "ReadAt took a NULL handle");
+    Check(os::File::WriteAt(NULL, buffer, 4, 0, &error) == -1 && error == il2cpp::os::kErrorCodeInvalidHandle, "WriteAt took a NULL handle");
+    Check(os::File::ReadScatter(NULL, buffers, 1, 0, &error) == -1 && error == il2cpp::os::kErrorCodeInvalidHandle, "ReadScatter took a NULL handle");
+    Check(os::File::WriteGather(NULL, buffers, 1, 0, &error) == -1 && error == il2cpp::os::kErrorCodeInvalidHandle, "WriteGather took a NULL handle");
+    Check(!os::File::Advise(NULL, 0, 0, kFileAdviceRandom, &error) && error == il2cpp::os::kErrorCodeInvalidHandle, "Advise took a NULL handle");
+}
+
+int main(int argc, char** argv)
+{
+    const std::string path = std::string(argc > 1 ? argv[1] : "/tmp") + "/il2cpp-positional-io.bin";
+    int error;
+
+    os::FileHandle* handle = os::File::Open(path, kFileModeCreate, kFileAccessReadWrite, kFileShareNone, 0, &error);
+    if (error != il2cpp::os::kErrorCodeSuccess)
+    {
+        printf("FAILED: could not create %s\n", path.c_str());
+        return 1;
+    }
+
+    Check(WriteWords(handle), "WriteAt wrote a short count");
+    Check(os::File::Seek(handle, 0, kFileSeekOriginCurrent, &error) == 0, "WriteAt moved the file position");
+
+    Check(os::File::Advise(handle, 0, 0, kFileAdviceRandom, &error), "Advise failed");
+    CheckConcurrentReads(handle);
+    CheckScatterGather(handle);
+    Check(os::File::Seek(handle, 0, kFileSeekOriginCurrent, &error) == 0, "the positional calls moved the file position");
+    os::File::Close(handle, &error);
+
+    handle = os::File::Open(path, kFileModeOpen, kFileAccessRead, kFileShareRead, 0, &error);
+    char buffer[4] = {};
+    os::FileIOBuffer buffers[] = { { buffer, sizeof(buffer) } };
+    Check(os::File::WriteAt(handle, buffer, 4, 0, &error) == -1 && error == il2cpp::os::kErrorCodeAccessDenied, "WriteAt wrote to a read only handle");
+    Check(os::File::WriteGather(handle, buffers, 1, 0, &error) == -1 && error == il2cpp::os::kErrorCodeAccessDenied, "WriteGather wrote to a read only handle");
+    os::File::Close(handle, &error);
+
+    CheckRejected();
+    unlink(path.c_str());
+
+    printf(s_Passed ? "PASSED\n" : "FAILED\n");
+    return s_Passed ? 0 : 1;
+}
@@ -0,0 +1,215 @@
+// Times what allocation tracking adds to every allocation of 4 threads: recording it with vm::ProfilerCapture, for
+// every allocation, one in 16 and one in 256, against a profiler callback that appends the allocation to a list under a lock,
+// the way a callback profiler has to when it is called from many threads. Then reads the capture back and checks that
+// every allocation was either recorded or counted as dropped. The capture of the last run is left in the scratch
+// directory for tools/DecodeProfilerCapture.
+//
+// The class, method and stack lookups of the runtime are replaced by fixed ones, the drain thread does not have to
+// name anything but one class and three methods. Linux only, see the Makefile. Run with an optional scratch
+// directory, /tmp by default.
+
+#include "il2cpp-config.h"
+#include "il2cpp-class-internals.h"
+#include "os/Thread.h"
+#include "vm/Method.h"
+#include "vm/Object.h"
+#include "vm/ProfilerCapture.h"
+#include "vm/StackTrace.h"
+#include "vm/Type.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+using namespace il2cpp;
+
+static const int kThreadCount = 4;
+static const int kAllocationsPerThread = 2000000;
+// Writes to a small object after every allocation, which makes an allocation take about as long as a small one of the
+// GC does.
+static const int kWorkPerAllocation = 16;
+
+namespace il2cpp
+{
+namespace vm
+{
+    static StackFrames s_StackFrames;
+
+    const StackFrames* StackTrace::GetStackFrames()
+    {
+        return &s_StackFrames;
+    }
+
+    uint32_t Object::GetSize(Il2CppObject* obj)
+    {
+        return 24;
+    }
+
+    const char* Type::GetCachedName(const Il2CppType* type, Il2CppTypeNameFormat format)
+    {
+        return "Benchmark.AllocatedClass";
+    }
+
+    std::string Method::GetFullName(const MethodInfo* method)
+    {
+        return "Benchmark.Program::Method";
+    }
+}
+}
+
+static Il2CppClass s_Class;
+static MethodInfo s_Methods[3];
+
+static int64_t NowNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+struct CallbackAllocation
+{
+    Il2CppClass* klass;
+    uint32_t size;
+};
+
+static std::mutex s_CallbackMutex;
+static std::vector<CallbackAllocation> s_CallbackAllocations;
+
+static void AllocationCallback(Il2CppObject* obj, Il2CppClass* klass)
+{
+    std::lock_guard<std::mutex> lock(s_CallbackMutex);
+    CallbackAllocation allocation = { klass, vm::Object::GetSize(obj) };
+    s_CallbackAllocations.push_back(allocation);
+}
+
+// Stands in for the allocation itself, so that the compiler keeps the loop.
+static void NoTracking(Il2CppObject* obj, Il2CppClass* klass)
+{
+    __asm__ __volatile__ ("" : : "r" (klass) : "memory");
+}
+
+typedef void (*AllocationFunction)(Il2CppObject* obj, Il2CppClass* klass);
+
+static void* Allocate(void* context)
+{
+    os::Thread::Init();
+    AllocationFunction allocation = reinterpret_cast<AllocationFunction>(context);
+
+    volatile uint64_t object[8] = {};
+    for (int i = 0; i < kAllocationsPerThread; i++)
+    {
+        allocation(NULL, &s_Class);
+        for (int j = 0; j < kWorkPerAllocation; j++)
+            object[j & 7] = object[j & 7] + i;
+    }
+
+    vm::ProfilerCapture::ReleaseCurrentThreadBuffer();
+    return NULL;
+}
+
+static double Time(AllocationFunction allocation)
+{
+    pthread_t threads[kThreadCount];
+    const int64_t start = NowNs();
+
+    for (int i = 0; i < kThreadCount; i++)
+        pthread_create(&threads[i], NULL, Allocate, reinterpret_cast<void*>(allocation));
+    for (int i = 0; i < kThreadCount; i++)
+        pthread_join(threads[i], NULL);
+
+    return (double)(NowNs() - start) / ((int64_t)kThreadCount * kAllocationsPerThread);
+}
+
+static bool Read(FILE* file, void* data, size_t size)
+{
+    return fread(data, 1, size, file) == size;
+}
+
+// Every allocation must be in the capture or counted as dropped, and every recorded one followed by its stack.
+static bool CheckCapture(const char* path, uint32_t sampleInterval)
+{
+    FILE* file = fopen(path, "rb");
+    vm::CaptureFileHeader header;
+    if (file == NULL || !Read(file, &header, sizeof(header)) || header.allocationSampleInterval != sampleInterval)
+    {
+        printf("FAILED: could not read the header of %s\n", path);
+        return false;
+    }
+
+    uint64_t allocations = 0, frames = 0, dropped = 0;
+    vm::CaptureRecord record;
+    while (Read(file, &record, sizeof(record)))
+    {
+        if (record.kind == vm::kCaptureRecordName)
+        {
+            fseek(file, (record.value + 7) / 8 * 8, SEEK_CUR);
+            continue;
+        }
+
+        vm::CaptureRecord chunkRecord;
+        for (uint32_t i = 0; i < record.value && Read(file, &chunkRecord, sizeof(chunkRecord)); i++)
+        {
+            allocations += chunkRecord.kind == vm::kCaptureRecordAllocation;
+            frames += chunkRecord.kind == vm::kCaptureRecordStackFrame;
+            dropped += chunkRecord.kind == vm::kCaptureRecordDropped ? chunkRecord.value : 0;
+        }
+    }
+    fclose(file);
+
+    const uint64_t sampled = (uint64_t)kThreadCount * (kAllocationsPerThread / sampleInterval);
+    printf("                 %llu of %llu sampled allocations recorded, %llu dropped\n", (unsigned long long)allocations, (unsigned long long)sampled, (unsigned long long)dropped);
+    if (allocations + dropped != sampled || frames != allocations * 3)
+    {
+        printf("FAILED: expected %llu allocations with 3 frames each\n", (unsigned long long)sampled);
+        return false;
+    }
+    return true;
+}
+
+static bool TimeCapture(const std::string& path, uint32_t sampleInterval, double baselineNs)
+{
+    if (!vm::ProfilerCapture::Start(path.c_str(), IL2CPP_PROFILE_ALLOCATIONS, sampleInterval))
+    {
+        printf("FAILED: could not start a capture into %s\n", path.c_str());
+        return false;
+    }
+
+    const double ns = Time(vm::ProfilerCapture::Allocation);
+    vm::ProfilerCapture::Stop();
+
+    printf("capture, 1 in %-3u %8.1f ns per allocation, %6.1f ns over none\n", sampleInterval, ns, ns - baselineNs);
+    return CheckCapture(path.c_str(), sampleInterval);
+}
+
+int main(int argc, char** argv)
+{
+    os::Thread::Init();
+    for (int i = 0; i < 3; i++)
+    {
+        Il2CppStackFrameInfo frame = {};
+        frame.method = &s_Methods[i];
+        vm::s_StackFrames.push_back(frame);
+    }
+
+    const std::string path = std::string(argc > 1 ? argv[1] : "/tmp") + "/il2cpp-profiler-capture.bin";
+    printf("%d threads, %d allocations each, 3 frame stacks\n", kThreadCount, kAllocationsPerThread);
+
+    const double baselineNs = Time(NoTracking);
+    printf("none             %8.1f ns per allocation\n", baselineNs);
+
+    const double callbackNs = Time(AllocationCallback);
+    printf("callback         %8.1f ns per allocation, %6.1f ns over none\n", callbackNs, callbackNs - baselineNs);
+
+    bool passed = TimeCapture(path, 1, baselineNs);
+    passed = TimeCapture(path, 16, baselineNs) && passed;
+    passed = TimeCapture(path, 256, baselineNs) && passed;
+
+    printf(passed ? "PASSED\n" : "FAILED\n");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,394 @@
+// Times vm::PlatformInvoke::MarshalStringBuilder and MarshalStringBuilderResult, which encode a StringBuilder's chunks
+// straight into the native buffer and decode the result straight into its chunk array, against the way they used to
+// work: a std::string for every chunk, to its full capacity, copied into the buffer, and a UTF16String for the result,
+// copied a character at a time into a new array. Builders of 1 to 64 chunks of 256 characters, mostly ASCII and with
+// one character in eight outside it.
+//
+// First checks, for 200k random strings, that StringUtils' length and buffer conversions agree with its std::string
+// ones and that it finds the same strings valid UTF-8 as utf8::is_valid. Then, for 20k random builders with chunks
+// that are not full, that the marshaled string is the builder's text and that marshaling it back gives the same
+// characters.
+//
+// The managed objects are plain memory. Linux only, see the Makefile.
+
+#include "il2cpp-config.h"
+#include "il2cpp-class-internals.h"
+#include "il2cpp-object-internals.h"
+#include "gc/WriteBarrier.h"
+#include "os/LibraryLoader.h"
+#include "os/MarshalStringAlloc.h"
+#include "vm/Array.h"
+#include "vm/Class.h"
+#include "vm/Exception.h"
+#include "vm/MarshalAlloc.h"
+#include "vm/MetadataCache.h"
+#include "vm/Method.h"
+#include "vm/Object.h"
+#include "vm/PlatformInvoke.h"
+#include "vm/Runtime.h"
+#include "vm/String.h"
+#include "vm/Type.h"
+#include "utils/StringUtils.h"
+#include "utils/utf8-cpp/source/utf8/core.h"
+#include "vm-utils/VmStringUtils.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+using namespace il2cpp;
+using il2cpp::utils::StringUtils;
+
+static const int kRandomStrings = 200000;
+static const int kRandomBuilders = 20000;
+static const int kChunkLength = 256;
+
+Il2CppDefaults il2cpp_defaults;
+
+// Only the StringBuilder marshaling is run, the rest of PlatformInvoke needs none of these.
+namespace il2cpp
+{
+namespace gc
+{
+    void WriteBarrier::GenericStore(void** ptr, void* value)
+    {
+        *ptr = value;
+    }
+}
+
+namespace os
+{
+    Baselib_DynamicLibrary_Handle LibraryLoader::LoadDynamicLibrary(const utils::StringView<Il2CppNativeChar> nativeDynamicLibrary, std::string& detailedError) { abort(); }
+    Il2CppMethodPointer LibraryLoader::GetFunctionPointer(Baselib_DynamicLibrary_Handle handle, const PInvokeArguments& pinvokeArgs, std::string& detailedError) { abort(); }
+    void LibraryLoader::SetFindPluginCallback(Il2CppSetFindPlugInCallback method) { abort(); }
+    Il2CppMethodPointer LibraryLoader::GetHardcodedPInvokeDependencyFunctionPointer(const il2cpp::utils::StringView<Il2CppNativeChar>& nativeDynamicLibrary, const il2cpp::utils::StringView<char>& entryPoint, Il2CppCharSet charSet) { abort(); }
+    il2cpp_hresult_t MarshalStringAlloc::AllocateBStringLength(const Il2CppChar* text, int32_t length, Il2CppChar** bstr) { abort(); }
+    il2cpp_hresult_t MarshalStringAlloc::GetBStringLength(const Il2CppChar* bstr, int32_t* length) { abort(); }
+    il2cpp_hresult_t MarshalStringAlloc::FreeBString(Il2CppChar* bstr) { abort(); }
+}
+
+namespace utils
+{
+    bool VmStringUtils::CaseSensitiveEquals(const char* left, const char* right) { abort(); }
+}
+
+namespace vm
+{
+    void* MarshalAlloc::Allocate(size_t size)
+    {
+        return malloc(size);
+    }
+
+    void MarshalAlloc::Free(void* ptr)
+    {
+        free(ptr);
+    }
+
+    // Every array the benchmark makes holds characters.
+    Il2CppArray* Array::New(Il2CppClass* elementTypeInfo, il2cpp_array_size_t length)
+    {
+        Il2CppArray* array = static_cast<Il2CppArray*>(calloc(1, kIl2CppSizeOfArray + length * sizeof(Il2CppChar)));
+        array->max_length = length;
+        return array;
+    }
+
+    char* Array::GetFirstElementAddress(Il2CppArray* array)
+    {
+        return reinterpret_cast<char*>(array) + kIl2CppSizeOfArray;
+    }
+
+    const char* Class::GetName(Il2CppClass* klass) { abort(); }
+    const char* Class::GetNamespace(Il2CppClass* klass) { abort(); }
+    bool Class::HasParent(Il2CppClass* klass, Il2CppClass* parent) { abort(); }
+    Il2CppMethodPointer MetadataCache::GetReversePInvokeWrapper(const Il2CppImage* image, const MethodInfo* method) { abort(); }
+    bool Method::IsInstance(const MethodInfo* method) { abort(); }
+    std::string Method::GetFullName(const MethodInfo* method) { abort(); }
+    const char* Method::GetParamName(const MethodInfo* method, uint32_t index) { abort(); }
+    bool Method::HasFullGenericSharingSignature(const MethodInfo* method) { abort(); }
+    Il2CppObject* Object::New(Il2CppClass* klass) { abort(); }
+    Il2CppString* String::New(const char* str) { abort(); }
+    Il2CppString* String::NewUtf16(const Il2CppChar* text, int32_t len) { abort(); }
+    const MethodInfo* Runtime::GetDelegateInvoke(Il2CppClass* klass) { abort(); }
+    std::string Type::GetName(const Il2CppType* type, Il2CppTypeNameFormat format) { abort(); }
+    void Type::ConstructClosedDelegate(Il2CppDelegate* delegate, Il2CppObject* target, Il2CppMethodPointer addr, const MethodInfo* method) { abort(); }
+    Il2CppException* Exception::GetArgumentException(const char* arg, const char* msg) { abort(); }
+    Il2CppException* Exception::GetDllNotFoundException(const char* msg) { abort(); }
+    Il2CppException* Exception::GetNotSupportedException(const char* msg) { abort(); }
+    Il2CppException* Exception::GetMarshalDirectiveException(const char* msg) { abort(); }
+    Il2CppException* Exception::GetEntryPointNotFoundException(const char* msg) { abort(); }
+    void Exception::Raise(Il2CppException* ex, MethodInfo* lastManagedFrame) { abort(); }
+    void Exception::Raise(il2cpp_hresult_t hresult, bool defaultToCOMException) { abort(); }
+}
+}
+
+static double GetTimeNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+static Il2CppChar* GetChunkChars(Il2CppStringBuilder* chunk)
+{
+    return reinterpret_cast<Il2CppChar*>(vm::Array::GetFirstElementAddress(chunk->chunkChars));
+}
+
+// MarshalStringBuilder as it was, with the MarshalEmptyStringBuilder overload it called.
+static char* MarshalStringBuilderAsItWas(Il2CppStringBuilder* stringBuilder)
+{
+    size_t stringLength = 0;
+    std::vector<std::string> utf8Chunks;
+    std::vector<Il2CppStringBuilder*> builders;
+
+    for (Il2CppStringBuilder* currentBuilder = stringBuilder; currentBuilder != NULL; currentBuilder = currentBuilder->chunkPrevious)
+    {
+        std::string utf8String = StringUtils::Utf16ToUtf8(GetChunkChars(currentBuilder), (int)currentBuilder->chunkChars->max_length);
+        utf8Chunks.push_back(utf8String);
+        builders.push_back(currentBuilder);
+        stringLength += std::max((size_t)currentBuilder->chunkChars->max_length, utf8String.size());
+    }
+
+    char* nativeString = vm::PlatformInvoke::MarshalAllocateStringBuffer<char>(stringLength + 1);
+    memset(nativeString, 0, sizeof(char) * (stringLength + 1));
+
+    if (stringLength > 0)
+    {
+        int offsetAdjustment = 0;
+        for (int i = (int)utf8Chunks.size() - 1; i >= 0; i--)
+        {
+            std::string utf8String = utf8Chunks[i];
+            memcpy(nativeString + builders[i]->chunkOffset + offsetAdjustment, utf8String.c_str(), (int)utf8String.size());
+            offsetAdjustment += (int)utf8String.size() - builders[i]->chunkLength;
+        }
+    }
+
+    return nativeString;
+}
+
+// MarshalStringBuilderResult as it was.
+static void MarshalStringBuilderResultAsItWas(Il2CppStringBuilder* stringBuilder, char* buffer)
+{
+    UTF16String utf16String = StringUtils::Utf8ToUtf16(buffer);
+
+    stringBuilder->chunkChars = vm::Array::New(il2cpp_defaults.char_class, (int)utf16String.size() + 1);
+    for (int i = 0; i < (int)utf16String.size(); i++)
+        il2cpp_array_set(stringBuilder->chunkChars, Il2CppChar, i, utf16String[i]);
+    il2cpp_array_set(stringBuilder->chunkChars, Il2CppChar, (int)utf16String.size(), '\0');
+
+    stringBuilder->chunkLength = (int)utf16String.size();
+    stringBuilder->chunkOffset = 0;
+    stringBuilder->chunkPrevious = NULL;
+}
+
+// A character drawn from one to four byte UTF-8, or ASCII every time when asciiOnly.
+static void AppendRandomChar(std::mt19937& random, bool asciiOnly, UTF16String& text)
+{
+    const int kind = asciiOnly ? 0 : random() % 10;
+    if (kind < 5)
+        text.push_back('a' + random() % 26);
+    else if (kind < 7)
+        text.push_back(0x80 + random() % 0x780);
+    else if (kind < 9)
+        text.push_back(0x800 + random() % 0xd000);
+    else
+    {
+        text.push_back(0xd800 + random() % 0x400);
+        text.push_back(0xdc00 + random() % 0x400);
+    }
+}
+
+static int CheckConversions()
+{
+    std::mt19937 random(3);
+    int mismatches = 0;
+
+    for (int i = 0; i < kRandomStrings; ++i)
+    {
+        UTF16String text;
+        const int length = random() % 70;
+        const bool asciiOnly = random() % 4 == 0;
+        while ((int)text.size() < length)
+            AppendRandomChar(random, asciiOnly, text);
+
+        const std::string expected = StringUtils::Utf16ToUtf8(text);
+        const size_t utf8Length = StringUtils::Utf16ToUtf8Length(text.c_str(), text.size());
+        std::vector<char> utf8(utf8Length + 16, 0x55);
+        const size_t written = StringUtils::Utf16ToUtf8(text.c_str(), text.size(), &utf8[0]);
+        mismatches += utf8Length != expected.size() || written != utf8Length || memcmp(&utf8[0], expected.data(), utf8Length) != 0 || utf8[utf8Length] != 0x55;
+
+        const size_t utf16Length = StringUtils::Utf8ToUtf16Length(expected.data(), expected.size());
+        std::vector<Il2CppChar> utf16(utf16Length + 4, 0x5555);
+        const size_t decoded = StringUtils::Utf8ToUtf16(expected.data(), expected.size(), &utf16[0]);
+        mismatches += utf16Length != text.size() || decoded != utf16Length || memcmp(&utf16[0], text.data(), utf16Length * sizeof(Il2CppChar)) != 0;
+
+        // Mostly ASCII bytes with a few others, which are often not valid UTF-8.
+        std::string bytes = expected;
+        for (int j = random() % 3; j > 0 && !bytes.empty(); --j)
+            bytes[random() % bytes.size()] = (char)(0x80 + random() % 0x80);
+        mismatches += StringUtils::IsValidUtf8(bytes.data(), bytes.size()) != utf8::is_valid(bytes.begin(), bytes.end());
+    }
+
+    return mismatches;
+}
+
+// Links chunks of the given lengths and capacities into a builder, the way StringBuilder does, and returns its last
+// chunk. The characters past each chunk's length are filled with junk, which must not reach the native string.
+static Il2CppStringBuilder* MakeBuilder(std::mt19937& random, bool asciiOnly, const std::vector<int>& lengths, int capacity, UTF16String& text)
+{
+    Il2CppStringBuilder* previous = NULL;
+    int offset = 0;
+    for (size_t i = 0; i < lengths.size(); ++i)
+    {
+        UTF16String chars;
+        while ((int)chars.size() < lengths[i])
+            AppendRandomChar(random, asciiOnly, chars);
+        // A surrogate pair may not be split between chunks.
+        if ((int)chars.size() > lengths[i])
+            chars.resize(lengths[i] - 1);
+
+        Il2CppStringBuilder* chunk = static_cast<Il2CppStringBuilder*>(calloc(1, sizeof(Il2CppStringBuilder)));
+        chunk->chunkChars = vm::Array::New(il2cpp_defaults.char_class, std::max(capacity, (int)chars.size()));
+        Il2CppChar* chunkChars = GetChunkChars(chunk);
+        std::fill(chunkChars, chunkChars + chunk->chunkChars->max_length, (Il2CppChar)'#');
+        std::copy(chars.begin(), chars.end(), chunkChars);
+
+        chunk->chunkLength = (int)chars.size();
+        chunk->chunkOffset = offset;
+        chunk->chunkPrevious = previous;
+        offset += chunk->chunkLength;
+        previous = chunk;
+        text += chars;
+    }
+    return previous;
+}
+
+static void FreeBuilder(Il2CppStringBuilder* stringBuilder)
+{
+    while (stringBuilder != NULL)
+    {
+        Il2CppStringBuilder* previous = stringBuilder->chunkPrevious;
+        free(stringBuilder->chunkChars);
+        free(stringBuilder);
+        stringBuilder = previous;
+    }
+}
+
+static int CheckBuilders()
+{
+    std::mt19937 random(5);
+    int mismatches = 0;
+
+    for (int i = 0; i < kRandomBuilders; ++i)
+    {
+        std::vector<int> lengths(random() % 6 + 1);
+        for (size_t j = 0; j < lengths.size(); ++j)
+            lengths[j] = random() % 40;
+
+        UTF16String text;
+        Il2CppStringBuilder* builder = MakeBuilder(random, random() % 4 == 0, lengths, 40, text);
+
+        const std::string expected = StringUtils::Utf16ToUtf8(text);
+        char* native = vm::PlatformInvoke::MarshalStringBuilder(builder);
+        mismatches += strcmp(native, expected.c_str()) != 0;
+
+        vm::PlatformInvoke::MarshalStringBuilderResult(builder, native);
+        mismatches += builder->chunkPrevious != NULL || builder->chunkOffset != 0 || builder->chunkLength != (int)text.size()
+            || text.compare(0, text.size(), GetChunkChars(builder), builder->chunkLength) != 0;
+
+        free(native);
+        FreeBuilder(builder);
+    }
+
+    // A result that is not valid UTF-8 leaves the builder empty.
+    UTF16String text;
+    Il2CppStringBuilder* builder = MakeBuilder(random, true, std::vector<int>(2, 10), 10, text);
+    char invalid[] = "abcdefgh\xc3(";
+    vm::PlatformInvoke::MarshalStringBuilderResult(builder, invalid);
+    mismatches += builder->chunkPrevious != NULL || builder->chunkLength != 0;
+    FreeBuilder(builder);
+
+    return mismatches;
+}
+
+static volatile size_t s_Sink;
+
+template<typename Function>
+static double Time(int iterations, Function function)
+{
+    size_t sum = 0;
+    const double start = GetTimeNs();
+    for (int i = 0; i < iterations; ++i)
+        sum += function();
+    s_Sink = sum;
+    return (GetTimeNs() - start) / iterations;
+}
+
+static bool TimeChunks(int chunkCount, bool asciiOnly)
+{
+    std::mt19937 random(chunkCount);
+    UTF16String text;
+    Il2CppStringBuilder* builder = MakeBuilder(random, true, std::vector<int>(chunkCount, kChunkLength), kChunkLength, text);
+
+    // One character in eight replaced with a two byte one.
+    if (!asciiOnly)
+    {
+        for (Il2CppStringBuilder* chunk = builder; chunk != NULL; chunk = chunk->chunkPrevious)
+        {
+            for (int i = 0; i < chunk->chunkLength; i += 8)
+                GetChunkChars(chunk)[i] = 0xe9;
+        }
+    }
+
+    // The old marshaling got full chunks right, so both have to agree on these.
+    char* before = MarshalStringBuilderAsItWas(builder);
+    char* now = vm::PlatformInvoke::MarshalStringBuilder(builder);
+    const bool same = strcmp(before, now) == 0;
+    free(before);
+
+    const int iterations = 400000 / chunkCount;
+    const double marshalBefore = Time(iterations, [&] { char* native = MarshalStringBuilderAsItWas(builder); const size_t first = native[0]; free(native); return first; });
+    const double marshal = Time(iterations, [&] { char* native = vm::PlatformInvoke::MarshalStringBuilder(builder); const size_t first = native[0]; free(native); return first; });
+
+    // Results always land in a single chunk, the old way allocated a new array each time.
+    Il2CppStringBuilder* result = static_cast<Il2CppStringBuilder*>(calloc(1, sizeof(Il2CppStringBuilder)));
+    result->chunkChars = vm::Array::New(il2cpp_defaults.char_class, 1);
+    const double resultBefore = Time(iterations, [&] { free(result->chunkChars); MarshalStringBuilderResultAsItWas(result, now); return (size_t)result->chunkLength; });
+    const double resultNow = Time(iterations, [&] { vm::PlatformInvoke::MarshalStringBuilderResult(result, now); return (size_t)result->chunkLength; });
+
+    printf("%6d %6d %10.0f -> %8.0f %10.0f -> %8.0f\n", chunkCount, chunkCount * kChunkLength, marshalBefore, marshal, resultBefore, resultNow);
+
+    free(now);
+    FreeBuilder(result);
+    FreeBuilder(builder);
+    return same;
+}
+
+int main()
+{
+    static Il2CppClass charClass;
+    il2cpp_defaults.char_class = &charClass;
+
+    const int conversionMismatches = CheckConversions();
+    printf("%d random strings, %d converted differently from the std::string conversions\n", kRandomStrings, conversionMismatches);
+    const int builderMismatches = CheckBuilders();
+    printf("%d random builders, %d marshaled wrongly\n", kRandomBuilders, builderMismatches);
+
+    bool passed = conversionMismatches == 0 && builderMismatches == 0;
+    const bool kinds[] = { true, false };
+    const int chunkCounts[] = { 1, 4, 16, 64 };
+    for (int kind = 0; kind < 2; ++kind)
+    {
+        printf("\n%s, ns per call, before -> now\nchunks  chars    to native               result\n", kinds[kind] ? "ASCII" : "one character in eight not ASCII");
+        for (size_t i = 0; i < sizeof(chunkCounts) / sizeof(chunkCounts[0]); ++i)
+            passed = TimeChunks(chunkCounts[i], kinds[kind]) && passed;
+    }
+
+    printf(passed ? "PASSED\n" : "FAILED\n");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,437 @@
+// Times Marshal::PtrToStructure and StructureToPtr, which read the marshal functions, whether a type is blittable and
+// a formatted class's default constructor off a descriptor built on first use and kept on the class, against the way
+// they used to work: the interop data, native size and enum checks on every call, and for classes a walk of the
+// methods to find out whether there is a default constructor and another to find it. A blittable 16 byte struct, a
+// struct with marshal functions and a class with marshal functions and 13 methods.
+//
+// First checks that both give the same bytes and raise the same exceptions for those, for an enum, a string, a class
+// without a default constructor and void, and that DestroyStructure calls the cleanup function the same way.
+//
+// Class::HasDefaultConstructor and GetMethodFromName are stand-ins that walk the methods the way vm::Class does
+// without the method name index. The managed objects are plain memory. Linux only, see the Makefile.
+
+#include "il2cpp-config.h"
+#include "il2cpp-class-internals.h"
+#include "il2cpp-object-internals.h"
+#include "gc/GarbageCollector.h"
+#include "icalls/mscorlib/System.Runtime.InteropServices/Marshal.h"
+#include "os/MarshalStringAlloc.h"
+#include "vm/Array.h"
+#include "vm/Class.h"
+#include "vm/Exception.h"
+#include "vm/Field.h"
+#include "vm/LastError.h"
+#include "vm/MarshalAlloc.h"
+#include "vm/Object.h"
+#include "vm/PlatformInvoke.h"
+#include "vm/RCW.h"
+#include "vm/String.h"
+#include "vm/Type.h"
+#include "utils/MarshalingUtils.h"
+#include "utils/StringUtils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+using namespace il2cpp;
+using il2cpp::icalls::mscorlib::System::Runtime::InteropServices::Marshal;
+
+static const int kIterations = 2000000;
+static const int kMethodCount = 13;
+
+Il2CppDefaults il2cpp_defaults;
+
+// Exceptions are raised as C++ exceptions carrying the message, which is all the checks compare.
+struct RaisedException
+{
+    const char* message;
+};
+
+static Il2CppClass* s_Classes[8];
+static int s_ClassCount;
+
+namespace il2cpp
+{
+namespace gc
+{
+    Il2CppIUnknown* GarbageCollector::GetOrCreateCCW(Il2CppObject* obj, const Il2CppGuid& iid) { abort(); }
+    GarbageCollector::FinalizerCallback GarbageCollector::RegisterFinalizerWithCallback(Il2CppObject* obj, FinalizerCallback callback) { abort(); }
+}
+
+namespace os
+{
+    il2cpp_hresult_t MarshalStringAlloc::AllocateBStringLength(const Il2CppChar* text, int32_t length, Il2CppChar** bstr) { abort(); }
+}
+
+namespace vm
+{
+    Il2CppClass* Class::FromIl2CppType(const Il2CppType* type, bool throwOnError)
+    {
+        for (int i = 0; i < s_ClassCount; ++i)
+        {
+            if (&s_Classes[i]->byval_arg == type)
+                return s_Classes[i];
+        }
+        abort();
+    }
+
+    // As Class::HasDefaultConstructor, with Class::GetMethods reduced to reading the methods.
+    bool Class::HasDefaultConstructor(Il2CppClass* klass)
+    {
+        const char ctorName[] = ".ctor";
+        for (uint16_t i = 0; i < klass->method_count; ++i)
+        {
+            const MethodInfo* method = klass->methods[i];
+            if (strncmp(method->name, ctorName, utils::StringUtils::LiteralLength(ctorName)) == 0 && method->parameters_count == 0)
+                return true;
+        }
+        return false;
+    }
+
+    // As Class::GetMethodFromName without the method name index, for classes without a parent.
+    const MethodInfo* Class::GetMethodFromName(Il2CppClass* klass, const char* name, int argsCount)
+    {
+        for (uint16_t i = 0; i < klass->method_count; ++i)
+        {
+            const MethodInfo* method = klass->methods[i];
+            if (method->name[0] == name[0] && !strcmp(name, method->name) && method->parameters_count == argsCount)
+                return method;
+        }
+        return NULL;
+    }
+
+    FieldInfo* Class::GetFields(Il2CppClass* klass, void** iter) { abort(); }
+    FieldInfo* Class::GetFieldFromName(Il2CppClass* klass, const char* name) { abort(); }
+    int Class::GetFieldMarshaledSize(const FieldInfo* field) { abort(); }
+    int Class::GetFieldMarshaledAlignment(const FieldInfo* field) { abort(); }
+    bool Class::IsGeneric(const Il2CppClass* klass) { abort(); }
+    const char* Field::GetName(FieldInfo* field) { abort(); }
+    int Field::GetFlags(FieldInfo* field) { abort(); }
+
+    Il2CppObject* Object::New(Il2CppClass* klass)
+    {
+        Il2CppObject* object = static_cast<Il2CppObject*>(calloc(1, klass->instance_size));
+        object->klass = klass;
+        return object;
+    }
+
+    void* Object::Unbox(Il2CppObject* obj)
+    {
+        return obj + 1;
+    }
+
+    Il2CppException* Exception::GetArgumentException(const char* arg, const char* msg) { return reinterpret_cast<Il2CppException*>(const_cast<char*>(msg)); }
+    Il2CppException* Exception::GetArgumentException(const utils::StringView<Il2CppChar>& arg, const utils::StringView<Il2CppChar>& msg) { abort(); }
+    Il2CppException* Exception::GetArgumentNullException(const char* arg) { return reinterpret_cast<Il2CppException*>(const_cast<char*>("ArgumentNullException")); }
+    Il2CppException* Exception::GetNotSupportedException(const char* msg) { return reinterpret_cast<Il2CppException*>(const_cast<char*>(msg)); }
+    Il2CppException* Exception::GetMissingMethodException(const char* msg) { return reinterpret_cast<Il2CppException*>(const_cast<char*>(msg)); }
+    void Exception::RaiseOutOfMemoryException() { abort(); }
+
+    void Exception::Raise(Il2CppException* ex, MethodInfo* lastManagedFrame)
+    {
+        RaisedException raised = { reinterpret_cast<const char*>(ex) };
+        throw raised;
+    }
+
+    uint32_t LastError::GetLastError() { abort(); }
+    void LastError::SetLastError(uint32_t error) { abort(); }
+    void* MarshalAlloc::Allocate(size_t size) { abort(); }
+    void* MarshalAlloc::ReAlloc(void* ptr, size_t size) { abort(); }
+    void MarshalAlloc::Free(void* ptr) { abort(); }
+    void* MarshalAlloc::AllocateHGlobal(size_t size) { abort(); }
+    void* MarshalAlloc::ReAllocHGlobal(void* ptr, size_t size) { abort(); }
+    void MarshalAlloc::FreeHGlobal(void* ptr) { abort(); }
+    intptr_t PlatformInvoke::MarshalDelegate(Il2CppDelegate* d) { abort(); }
+    Il2CppDelegate* PlatformInvoke::MarshalFunctionPointerToDelegate(void* functionPtr, Il2CppClass* delegateType) { abort(); }
+    Il2CppChar* PlatformInvoke::MarshalCSharpStringToCppBString(Il2CppString* managedString) { abort(); }
+    Il2CppString* PlatformInvoke::MarshalCppBStringToCSharpStringResult(const Il2CppChar* value) { abort(); }
+    void PlatformInvoke::MarshalFreeBString(Il2CppChar* value) { abort(); }
+    Il2CppObject* RCW::GetOrCreateFromIUnknown(Il2CppIUnknown* unknown, Il2CppClass* fallbackClass) { abort(); }
+    Il2CppString* String::New(const char* str) { abort(); }
+    Il2CppString* String::NewLen(const char* str, uint32_t length) { abort(); }
+    Il2CppString* String::NewUtf16(const Il2CppChar* text, int32_t len) { abort(); }
+    std::string Type::GetName(const Il2CppType* type, Il2CppTypeNameFormat format) { abort(); }
+    bool Type::IsStruct(const Il2CppType* type) { abort(); }
+}
+
+namespace utils
+{
+    std::string StringUtils::Printf(const char* format, ...) { abort(); }
+    std::string StringUtils::Utf16ToUtf8(const Il2CppChar* utf16String) { abort(); }
+    UTF16String StringUtils::Utf8ToUtf16(const char* utf8String) { abort(); }
+}
+}
+
+extern "C" int il2cpp_array_element_size(const Il2CppClass* ac) { abort(); }
+
+// PtrToStructure as it was.
+static Il2CppObject* PtrToStructureAsItWas(intptr_t ptr, Il2CppReflectionType* structureType)
+{
+    Il2CppClass* type = vm::Class::FromIl2CppType(structureType->type);
+    Il2CppTypeEnum typeType = structureType->type->type;
+
+    if (typeType == IL2CPP_TYPE_STRING || typeType == IL2CPP_TYPE_SZARRAY || (typeType == IL2CPP_TYPE_CLASS && !vm::Class::HasDefaultConstructor(type)))
+        vm::Exception::Raise(vm::Exception::GetMissingMethodException("No parameterless constructor defined for this object."));
+
+    if (type->interopData != NULL && type->interopData->pinvokeMarshalFromNativeFunction != NULL)
+    {
+        Il2CppObject* result = vm::Object::New(type);
+
+        if (typeType == IL2CPP_TYPE_CLASS)
+        {
+            typedef void (*Constructor)(Il2CppObject*);
+            Constructor ctor = reinterpret_cast<Constructor>(vm::Class::GetMethodFromName(type, ".ctor", 0)->virtualMethodPointer);
+            ctor(result);
+            utils::MarshalingUtils::MarshalStructFromNative(reinterpret_cast<void*>(ptr), result, type->interopData);
+        }
+        else
+        {
+            utils::MarshalingUtils::MarshalStructFromNative(reinterpret_cast<void*>(ptr), vm::Object::Unbox(result), type->interopData);
+        }
+
+        return result;
+    }
+
+    if (type->native_size != -1)
+    {
+        if (structureType->type->type == IL2CPP_TYPE_VOID)
+            vm::Exception::Raise(vm::Exception::GetNotSupportedException("Cannot dynamically create an instance of System.Void."));
+
+        if (!type->enumtype)
+        {
+            Il2CppObject* result = vm::Object::New(type);
+            memcpy(vm::Object::Unbox(result), reinterpret_cast<void*>(ptr), type->native_size);
+            return result;
+        }
+    }
+
+    if (type->generic_class != NULL || type->is_generic)
+        vm::Exception::Raise(vm::Exception::GetArgumentException("structure", "The specified object must not be an instance of a generic type."));
+
+    vm::Exception::Raise(vm::Exception::GetArgumentException("structure", "The specified structure must be blittable or have layout information."));
+    return NULL;
+}
+
+// StructureToPtr as it was.
+static void StructureToPtrAsItWas(Il2CppObject* structure, intptr_t ptr, bool deleteOld)
+{
+    Il2CppClass* type = structure->klass;
+
+    if (type->interopData != NULL && type->interopData->pinvokeMarshalToNativeFunction != NULL)
+    {
+        if (deleteOld)
+            utils::MarshalingUtils::MarshalFreeStruct(reinterpret_cast<void*>(ptr), type->interopData);
+
+        void* objectPtr = (type->byval_arg.type == IL2CPP_TYPE_CLASS) ? structure : vm::Object::Unbox(structure);
+        utils::MarshalingUtils::MarshalStructToNative(objectPtr, reinterpret_cast<void*>(ptr), type->interopData);
+        return;
+    }
+
+    if (type->native_size != -1)
+    {
+        if (!type->enumtype && type->byval_arg.type != IL2CPP_TYPE_STRING)
+        {
+            memcpy(reinterpret_cast<void*>(ptr), vm::Object::Unbox(structure), type->native_size);
+            return;
+        }
+    }
+
+    if (type->generic_class != NULL || type->is_generic)
+        vm::Exception::Raise(vm::Exception::GetArgumentException("structure", "The specified object must not be an instance of a generic type."));
+
+    vm::Exception::Raise(vm::Exception::GetArgumentException("structure", "The specified structure must be blittable or have layout information."));
+}
+
+// The native side of the marshaled types: 16 bytes, read and written with the bytes reversed so that a plain copy
+// would give a different answer. The managed side of the class starts after its object header.
+static int s_Cleanups;
+static int s_Constructions;
+
+static void ReverseBytes(const void* source, void* destination)
+{
+    for (int i = 0; i < 16; ++i)
+        static_cast<uint8_t*>(destination)[i] = static_cast<const uint8_t*>(source)[15 - i];
+}
+
+static void StructToNative(void* managed, void* native) { ReverseBytes(managed, native); }
+static void StructFromNative(void* native, void* managed) { ReverseBytes(native, managed); }
+static void ClassToNative(void* managed, void* native) { ReverseBytes(static_cast<Il2CppObject*>(managed) + 1, native); }
+static void ClassFromNative(void* native, void* managed) { ReverseBytes(native, static_cast<Il2CppObject*>(managed) + 1); }
+static void Cleanup(void* native) { s_Cleanups++; }
+static void Construct(Il2CppObject* object) { s_Constructions++; }
+
+static Il2CppInteropData s_StructInterop = { NULL, StructToNative, StructFromNative, Cleanup, NULL, NULL };
+static Il2CppInteropData s_ClassInterop = { NULL, ClassToNative, ClassFromNative, Cleanup, NULL, NULL };
+
+static const char* const kMethodNames[kMethodCount] = { "get_X", "set_X", "get_Y", "set_Y", "get_Z", "set_Z", "Equals", "GetHashCode", "ToString", "Normalize", "Dot", ".ctor", ".ctor" };
+static MethodInfo s_Methods[kMethodCount];
+static const MethodInfo* s_MethodTable[kMethodCount];
+
+static Il2CppClass* AddClass(Il2CppTypeEnum type, int32_t nativeSize, const Il2CppInteropData* interopData, bool enumType)
+{
+    Il2CppClass* klass = static_cast<Il2CppClass*>(calloc(1, sizeof(Il2CppClass)));
+    klass->byval_arg.type = type;
+    klass->native_size = nativeSize;
+    klass->instance_size = sizeof(Il2CppObject) + 16;
+    klass->interopData = interopData;
+    klass->enumtype = enumType;
+    klass->is_blittable = nativeSize != -1 && interopData == NULL;
+    s_Classes[s_ClassCount++] = klass;
+    return klass;
+}
+
+static Il2CppReflectionType* ReflectionTypeOf(Il2CppClass* klass)
+{
+    Il2CppReflectionType* reflectionType = static_cast<Il2CppReflectionType*>(calloc(1, sizeof(Il2CppReflectionType)));
+    reflectionType->type = &klass->byval_arg;
+    return reflectionType;
+}
+
+template<typename Function>
+static const char* Outcome(Function function, uint8_t* result)
+{
+    try
+    {
+        Il2CppObject* object = function();
+        if (object != NULL)
+        {
+            memcpy(result, vm::Object::Unbox(object), 16);
+            free(object);
+        }
+        return "returned";
+    }
+    catch (const RaisedException& raised)
+    {
+        return raised.message;
+    }
+}
+
+static bool CheckSame(const char* what, Il2CppReflectionType* type, const uint8_t* native)
+{
+    uint8_t before[16] = {};
+    uint8_t now[16] = {};
+    const int constructionsBefore = s_Constructions;
+    const char* outcomeBefore = Outcome([&] { return PtrToStructureAsItWas((intptr_t)native, type); }, before);
+    const int constructionsAsItWas = s_Constructions - constructionsBefore;
+    const char* outcomeNow = Outcome([&] { return Marshal::PtrToStructure((intptr_t)native, type); }, now);
+    const int constructionsNow = s_Constructions - constructionsBefore - constructionsAsItWas;
+
+    bool same = strcmp(outcomeBefore, outcomeNow) == 0 && memcmp(before, now, 16) == 0 && constructionsAsItWas == constructionsNow;
+
+    // StructureToPtr of an object of the type, cleaning up what was there first.
+    Il2CppClass* klass = vm::Class::FromIl2CppType(type->type);
+    Il2CppObject* object = vm::Object::New(klass);
+    memcpy(vm::Object::Unbox(object), native, 16);
+    uint8_t nativeBefore[16] = {};
+    uint8_t nativeNow[16] = {};
+    const int cleanupsBefore = s_Cleanups;
+    outcomeBefore = Outcome([&] { StructureToPtrAsItWas(object, (intptr_t)nativeBefore, true); return (Il2CppObject*)NULL; }, NULL);
+    const int cleanupsAsItWas = s_Cleanups - cleanupsBefore;
+    outcomeNow = Outcome([&] { Marshal::StructureToPtr(object, (intptr_t)nativeNow, true); return (Il2CppObject*)NULL; }, NULL);
+    const int cleanupsNow = s_Cleanups - cleanupsBefore - cleanupsAsItWas;
+    same = strcmp(outcomeBefore, outcomeNow) == 0 && memcmp(nativeBefore, nativeNow, 16) == 0 && cleanupsAsItWas == cleanupsNow && same;
+    free(object);
+
+    printf("  %-36s %s\n", what, same ? "same" : "DIFFERENT");
+    return same;
+}
+
+static volatile uint8_t s_Sink;
+
+static double TimePtrToStructure(Il2CppObject* (*ptrToStructure)(intptr_t, Il2CppReflectionType*), Il2CppReflectionType* type, const uint8_t* native)
+{
+    uint8_t sum = 0;
+    timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < kIterations; ++i)
+    {
+        Il2CppObject* object = ptrToStructure((intptr_t)native, type);
+        sum += static_cast<uint8_t*>(vm::Object::Unbox(object))[0];
+        free(object);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    s_Sink = sum;
+    return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / kIterations;
+}
+
+static double TimeStructureToPtr(void (*structureToPtr)(Il2CppObject*, intptr_t, bool), Il2CppObject* object, uint8_t* native)
+{
+    timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < kIterations; ++i)
+    {
+        structureToPtr(object, (intptr_t)native, false);
+        __asm__ __volatile__ ("" : : : "memory");
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    s_Sink = native[0];
+    return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / kIterations;
+}
+
+static void Time(const char* what, Il2CppReflectionType* type, const uint8_t* native)
+{
+    const double ptrToStructureBefore = TimePtrToStructure(PtrToStructureAsItWas, type, native);
+    const double ptrToStructure = TimePtrToStructure(Marshal::PtrToStructure, type, native);
+
+    Il2CppObject* object = vm::Object::New(vm::Class::FromIl2CppType(type->type));
+    uint8_t destination[16];
+    const double structureToPtrBefore = TimeStructureToPtr(StructureToPtrAsItWas, object, destination);
+    const double structureToPtr = TimeStructureToPtr(Marshal::StructureToPtr, object, destination);
+    free(object);
+
+    printf("  %-24s %6.1f -> %6.1f      %6.1f -> %6.1f\n", what, ptrToStructureBefore, ptrToStructure, structureToPtrBefore, structureToPtr);
+}
+
+int main()
+{
+    for (int i = 0; i < kMethodCount; ++i)
+    {
+        s_Methods[i].name = kMethodNames[i];
+        s_Methods[i].parameters_count = i == kMethodCount - 2 ? 1 : 0;
+        s_Methods[i].virtualMethodPointer = reinterpret_cast<Il2CppMethodPointer>(Construct);
+        s_MethodTable[i] = &s_Methods[i];
+    }
+
+    Il2CppClass* blittable = AddClass(IL2CPP_TYPE_VALUETYPE, 16, NULL, false);
+    Il2CppClass* marshaledStruct = AddClass(IL2CPP_TYPE_VALUETYPE, 16, &s_StructInterop, false);
+    Il2CppClass* formattedClass = AddClass(IL2CPP_TYPE_CLASS, 16, &s_ClassInterop, false);
+    formattedClass->methods = s_MethodTable;
+    formattedClass->method_count = kMethodCount;
+    Il2CppClass* enumType = AddClass(IL2CPP_TYPE_VALUETYPE, 4, NULL, true);
+    Il2CppClass* stringType = AddClass(IL2CPP_TYPE_STRING, sizeof(void*), NULL, false);
+    Il2CppClass* classWithoutConstructor = AddClass(IL2CPP_TYPE_CLASS, 16, &s_ClassInterop, false);
+    classWithoutConstructor->methods = s_MethodTable;
+    classWithoutConstructor->method_count = kMethodCount - 2;
+    Il2CppClass* voidType = AddClass(IL2CPP_TYPE_VOID, 1, NULL, false);
+
+    uint8_t native[16];
+    for (int i = 0; i < 16; ++i)
+        native[i] = (uint8_t)(i * 17 + 3);
+
+    printf("Il2CppClass is %zu bytes, marshalDescriptor %zu of them\n", sizeof(Il2CppClass), sizeof(blittable->marshalDescriptor));
+    printf("PtrToStructure and StructureToPtr, before and now:\n");
+    bool passed = CheckSame("blittable struct", ReflectionTypeOf(blittable), native);
+    passed = CheckSame("struct with marshal functions", ReflectionTypeOf(marshaledStruct), native) && passed;
+    passed = CheckSame("class with marshal functions", ReflectionTypeOf(formattedClass), native) && passed;
+    passed = CheckSame("enum", ReflectionTypeOf(enumType), native) && passed;
+    passed = CheckSame("string", ReflectionTypeOf(stringType), native) && passed;
+    passed = CheckSame("class without default constructor", ReflectionTypeOf(classWithoutConstructor), native) && passed;
+    passed = CheckSame("void", ReflectionTypeOf(voidType), native) && passed;
+
+    const int cleanupsBefore = s_Cleanups;
+    Marshal::DestroyStructure((intptr_t)native, ReflectionTypeOf(marshaledStruct));
+    Marshal::DestroyStructure((intptr_t)native, ReflectionTypeOf(blittable));
+    const bool destroyed = s_Cleanups == cleanupsBefore + 1;
+    printf("  %-36s %s\n", "DestroyStructure cleans up", destroyed ? "once" : "WRONGLY");
+    passed = destroyed && passed;
+
+    printf("\nns per call, before -> now   PtrToStructure      StructureToPtr\n");
+    Time("blittable struct", ReflectionTypeOf(blittable), native);
+    Time("struct, marshal functions", ReflectionTypeOf(marshaledStruct), native);
+    Time("class, 13 methods", ReflectionTypeOf(formattedClass), native);
+
+    printf(passed ? "PASSED\n" : "FAILED\n");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,322 @@
+// Times what thread statics cost with vm::Thread: attaching and detaching a thread while 2000 classes with 64 bytes of
+// thread statics each are registered, when the thread touches none of them, ten, and all of them, which is what
+// attaching cost when every thread got the data of every class up front. Then the lookup that generated code does
+// through il2cpp_codegen_get_thread_static_data, inline as it is and through a call as it was, and the first lookup
+// of a class on a thread, which allocates its data.
+//
+// Also checks that every thread gets its own zeroed data, and that another thread's data can be read through
+// GetThreadStaticDataForThread while that thread runs.
+//
+// The collector is replaced by malloc, so the allocations cost what malloc costs, and the managed thread objects are
+// plain memory. Linux only, see the Makefile.
+
+#include "il2cpp-config.h"
+#include "il2cpp-class-internals.h"
+#include "il2cpp-object-internals.h"
+#include "gc/GarbageCollector.h"
+#include "gc/WriteBarrier.h"
+#include "vm/Domain.h"
+#include "vm/Exception.h"
+#include "vm/Object.h"
+#include "vm/Profiler.h"
+#include "vm/Runtime.h"
+#include "vm/StackTrace.h"
+#include "vm/Thread.h"
+
+#include <atomic>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+using namespace il2cpp;
+
+static const int kClassCount = 2000;
+static const int32_t kClassSize = 64;
+static const int kLookups = 50000000;
+
+Il2CppDefaults il2cpp_defaults;
+
+namespace il2cpp
+{
+namespace gc
+{
+    void* GarbageCollector::AllocateFixed(size_t size, void *descr)
+    {
+        return calloc(1, size);
+    }
+
+    void GarbageCollector::FreeFixed(void* addr)
+    {
+        free(addr);
+    }
+
+    // The collector would reclaim the data once the slots that point at it are freed, malloc needs the benchmark
+    // to do it, see FreeTouchedData.
+    void* GarbageCollector::AllocateTyped(size_t size, void *descr)
+    {
+        return calloc(1, size);
+    }
+
+    void GarbageCollector::RegisterThread()
+    {
+    }
+
+    bool GarbageCollector::UnregisterThread()
+    {
+        return true;
+    }
+
+    bool GarbageCollector::IsFinalizerThread(Il2CppThread* thread)
+    {
+        return false;
+    }
+
+    void WriteBarrier::GenericStore(void** ptr, void* value)
+    {
+        *ptr = value;
+    }
+}
+
+namespace vm
+{
+    static Il2CppDomain s_Domain;
+
+    Il2CppDomain* Domain::GetCurrent()
+    {
+        return &s_Domain;
+    }
+
+    void Domain::ContextSet(Il2CppAppContext* context)
+    {
+    }
+
+    Il2CppObject* Object::New(Il2CppClass* klass)
+    {
+        return static_cast<Il2CppObject*>(calloc(1, klass->instance_size));
+    }
+
+    bool Runtime::IsShuttingDown()
+    {
+        return false;
+    }
+
+    void Runtime::UnhandledException(Il2CppException* exc)
+    {
+        abort();
+    }
+
+    void Profiler::ThreadStart(unsigned long tid)
+    {
+    }
+
+    void Profiler::ThreadEnd(unsigned long tid)
+    {
+    }
+
+    void StackTrace::InitializeStackTracesForCurrentThread()
+    {
+    }
+
+    void StackTrace::CleanupStackTracesForCurrentThread()
+    {
+    }
+
+    void Exception::Raise(Il2CppException* ex, MethodInfo* lastManagedFrame)
+    {
+        abort();
+    }
+
+    Il2CppException* Exception::GetThreadAbortException() { abort(); }
+    Il2CppException* Exception::GetThreadStateException(const char* msg) { abort(); }
+    Il2CppException* Exception::GetExecutionEngineException(const char* msg) { abort(); }
+    Il2CppException* Exception::GetInvalidOperationException(const char* msg) { abort(); }
+    Il2CppException* Exception::GetThreadInterruptedException() { abort(); }
+}
+}
+
+static Il2CppClass s_ThreadClass;
+static Il2CppClass s_InternalThreadClass;
+static int32_t s_Offsets[kClassCount];
+static volatile int64_t s_Sum;
+
+static int64_t NowNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+// How il2cpp_codegen_get_thread_static_data looked up the data when it was defined out of line.
+__attribute__((noinline)) static void* GetThreadStaticDataThroughCall(int32_t offset)
+{
+    return vm::Thread::GetThreadStaticData(offset);
+}
+
+static void FreeTouchedData(int touched)
+{
+    for (int i = 0; i < touched; ++i)
+        free(vm::Thread::GetThreadStaticData(s_Offsets[i]));
+}
+
+static void* AttachTouchDetach(void* context)
+{
+    const int touched = *static_cast<int*>(context);
+    Il2CppThread* thread = vm::Thread::Attach(vm::Domain::GetCurrent());
+
+    for (int i = 0; i < touched; ++i)
+        static_cast<int64_t*>(vm::Thread::GetThreadStaticData(s_Offsets[i]))[0]++;
+
+    FreeTouchedData(touched);
+    vm::Thread::Detach(thread);
+    return NULL;
+}
+
+static void TimeThreads(const char* label, int touched, int threadCount)
+{
+    const int64_t start = NowNs();
+    for (int i = 0; i < threadCount; ++i)
+    {
+        pthread_t thread;
+        pthread_create(&thread, NULL, AttachTouchDetach, &touched);
+        pthread_join(thread, NULL);
+    }
+    printf("  %-30s %8.2f us per thread\n", label, (NowNs() - start) / 1e3 / threadCount);
+}
+
+static void* DoNothing(void* context)
+{
+    return NULL;
+}
+
+// What starting and joining the thread costs without attaching it.
+static void TimeBareThreads(int threadCount)
+{
+    const int64_t start = NowNs();
+    for (int i = 0; i < threadCount; ++i)
+    {
+        pthread_t thread;
+        pthread_create(&thread, NULL, DoNothing, NULL);
+        pthread_join(thread, NULL);
+    }
+    printf("  %-30s %8.2f us per thread\n", "not attached", (NowNs() - start) / 1e3 / threadCount);
+}
+
+static void TimeLookups()
+{
+    Il2CppThread* thread = vm::Thread::Attach(vm::Domain::GetCurrent());
+    static const int kTouched = 16;
+    for (int i = 0; i < kTouched; ++i)
+        vm::Thread::GetThreadStaticData(s_Offsets[i * (kClassCount / kTouched)]);
+
+    int64_t sum = 0;
+    int64_t start = NowNs();
+    for (int i = 0; i < kLookups; ++i)
+        sum += static_cast<int64_t*>(vm::Thread::GetThreadStaticData(s_Offsets[(i & (kTouched - 1)) * (kClassCount / kTouched)]))[0]++;
+    printf("  %-30s %8.2f ns per lookup\n", "inline", (double)(NowNs() - start) / kLookups);
+
+    start = NowNs();
+    for (int i = 0; i < kLookups; ++i)
+        sum += static_cast<int64_t*>(GetThreadStaticDataThroughCall(s_Offsets[(i & (kTouched - 1)) * (kClassCount / kTouched)]))[0]++;
+    printf("  %-30s %8.2f ns per lookup\n", "through a call", (double)(NowNs() - start) / kLookups);
+
+    int firstLookups = 0;
+    start = NowNs();
+    for (int i = 0; i < kClassCount; ++i)
+    {
+        if (i % (kClassCount / kTouched) != 0)
+        {
+            sum += static_cast<int64_t*>(vm::Thread::GetThreadStaticData(s_Offsets[i]))[0];
+            firstLookups++;
+        }
+    }
+    printf("  %-30s %8.2f ns per lookup\n", "first, allocates", (double)(NowNs() - start) / firstLookups);
+
+    s_Sum = sum;
+    FreeTouchedData(kClassCount);
+    vm::Thread::Detach(thread);
+}
+
+struct Owner
+{
+    std::atomic<bool> written;
+    std::atomic<bool> read;
+    Il2CppInternalThread* thread;
+};
+
+static void* WriteOwnData(void* context)
+{
+    Owner& owner = *static_cast<Owner*>(context);
+    Il2CppThread* thread = vm::Thread::Attach(vm::Domain::GetCurrent());
+    owner.thread = thread->GetInternalThread();
+
+    static_cast<int64_t*>(vm::Thread::GetThreadStaticData(s_Offsets[7]))[1] = 7;
+    owner.written = true;
+    while (!owner.read)
+        sched_yield();
+
+    FreeTouchedData(kClassCount);
+    vm::Thread::Detach(thread);
+    return NULL;
+}
+
+static bool CheckData()
+{
+    Il2CppThread* thread = vm::Thread::Attach(vm::Domain::GetCurrent());
+    char zero[kClassSize] = {};
+    bool passed = true;
+
+    for (int i = 0; i < kClassCount; ++i)
+        passed = memcmp(vm::Thread::GetThreadStaticData(s_Offsets[i]), zero, kClassSize) == 0 && passed;
+    static_cast<int64_t*>(vm::Thread::GetThreadStaticData(s_Offsets[7]))[1] = 3;
+
+    Owner owner;
+    owner.written = false;
+    owner.read = false;
+    pthread_t other;
+    pthread_create(&other, NULL, WriteOwnData, &owner);
+    while (!owner.written)
+        sched_yield();
+
+    // Reading another thread's data allocates the classes it has not touched, which come back zeroed.
+    passed = static_cast<int64_t*>(vm::Thread::GetThreadStaticDataForThread(s_Offsets[7], owner.thread))[1] == 7 && passed;
+    passed = memcmp(vm::Thread::GetThreadStaticDataForThread(s_Offsets[8], owner.thread), zero, kClassSize) == 0 && passed;
+    owner.read = true;
+    pthread_join(other, NULL);
+
+    passed = static_cast<int64_t*>(vm::Thread::GetThreadStaticData(s_Offsets[7]))[1] == 3 && passed;
+
+    FreeTouchedData(kClassCount);
+    vm::Thread::Detach(thread);
+    printf("every thread has its own zeroed data: %s\n", passed ? "yes" : "no");
+    return passed;
+}
+
+int main()
+{
+    s_ThreadClass.instance_size = sizeof(Il2CppThread);
+    s_InternalThreadClass.instance_size = sizeof(Il2CppInternalThread);
+    il2cpp_defaults.thread_class = &s_ThreadClass;
+    il2cpp_defaults.internal_thread_class = &s_InternalThreadClass;
+
+    os::Thread::Init();
+    vm::Thread::Initialize();
+    for (int i = 0; i < kClassCount; ++i)
+        s_Offsets[i] = vm::Thread::AllocThreadStaticData(kClassSize, NULL);
+
+    printf("%d classes with %d bytes of thread statics each\n", kClassCount, kClassSize);
+    printf("Starting a thread, attaching, touching classes, detaching\n");
+    TimeBareThreads(2000);
+    TimeThreads("no classes", 0, 2000);
+    TimeThreads("10 classes", 10, 2000);
+    TimeThreads("every class, as up front", kClassCount, 200);
+
+    printf("Looking up one of 16 classes\n");
+    TimeLookups();
+
+    const bool passed = CheckData();
+    printf(passed ? "PASSED\n" : "FAILED\n");
+    return passed ? 0 : 1;
+}
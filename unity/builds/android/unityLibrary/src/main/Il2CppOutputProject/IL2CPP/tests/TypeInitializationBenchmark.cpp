@@ -0,0 +1,330 @@
+// Times Runtime::ClassInit while 2 to 16 threads race to initialize the same 64 types, each visiting them in its own
+// random order, with type initializers that each block for 20 us, as one reading a file would, so that the threads
+// interleave even on one CPU. Threads that find an initializer running on another thread block on a condition
+// variable of that class, and are compared with the way they used to wait: one lock for every type and a 1 ms sleep
+// until the initializer finished. Reports how long a round takes and how long after an initializer finished the
+// threads waiting for it got going again.
+//
+// Also checks that every initializer runs exactly once and has finished when ClassInit returns, that an initializer
+// touching its own type goes ahead, and that two initializers each waiting for the other's type on another thread,
+// which used to hang, complete.
+//
+// Type initializers are plain functions run through a stand-in for Runtime::Invoke. Linux only, see the Makefile.
+
+#include "il2cpp-config.h"
+#include "il2cpp-class-internals.h"
+#include "il2cpp-object-internals.h"
+#include "gc/GCHandle.h"
+#include "os/Atomic.h"
+#include "os/Thread.h"
+#include "vm/Class.h"
+#include "vm/Exception.h"
+#include "vm/Runtime.h"
+#include "vm/Type.h"
+#include "utils/StringUtils.h"
+
+#include "Baselib.h"
+#include "Cpp/ReentrantLock.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace il2cpp;
+
+static const int kClassCount = 64;
+static const int kInitializerUs = 20;
+static const int kRounds = 20;
+
+static int64_t NowNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+// A type with its initializer, which runs body and records when it finished.
+struct TestClass
+{
+    Il2CppClass klass;
+    MethodInfo cctor;
+    void (*body)(TestClass* testClass);
+    std::atomic<int> runs;
+    std::atomic<int64_t> finishedNs;
+};
+
+namespace il2cpp
+{
+namespace vm
+{
+    const MethodInfo* Class::GetCCtor(Il2CppClass* klass)
+    {
+        return &reinterpret_cast<TestClass*>(klass)->cctor;
+    }
+
+    Il2CppObject* Runtime::Invoke(const MethodInfo* method, void* obj, void** params, Il2CppException** exc)
+    {
+        TestClass* testClass = reinterpret_cast<TestClass*>(method->klass);
+        testClass->body(testClass);
+        testClass->runs++;
+        testClass->finishedNs = NowNs();
+        return NULL;
+    }
+
+    // Only reached when an initializer throws, which none of these do.
+    void Class::SetClassInitializationError(Il2CppClass* klass, Il2CppException* error) { abort(); }
+    std::string Type::GetName(const Il2CppType* type, Il2CppTypeNameFormat format) { abort(); }
+    Il2CppException* Exception::GetTypeInitializationException(const char* msg, Il2CppException* innerException) { abort(); }
+    void Exception::Raise(Il2CppException* ex, MethodInfo* lastManagedFrame) { abort(); }
+}
+
+namespace gc
+{
+    Il2CppObject* GCHandle::GetTarget(uint32_t gchandle) { abort(); }
+}
+
+namespace utils
+{
+    std::string StringUtils::Printf(const char* format, ...) { abort(); }
+}
+}
+
+// Runtime::ClassInit as it was, without the exception handling. os::Thread::Sleep needs an attached thread, usleep
+// sleeps as long.
+static baselib::ReentrantLock s_TypeInitializationLock;
+
+static void ClassInitAsItWas(Il2CppClass* klass)
+{
+    if (klass->cctor_finished_or_no_cctor)
+        return;
+
+    s_TypeInitializationLock.Acquire();
+
+    if (os::Atomic::CompareExchange(&klass->cctor_finished_or_no_cctor, 1, 1) == 1)
+    {
+        s_TypeInitializationLock.Release();
+        return;
+    }
+
+    if (os::Atomic::CompareExchange(&klass->cctor_started, 1, 1) == 1)
+    {
+        s_TypeInitializationLock.Release();
+
+        os::Thread::ThreadId currentThread = os::Thread::CurrentThreadId();
+        if (os::Atomic::CompareExchangePointer((size_t**)&klass->cctor_thread, (size_t*)currentThread, (size_t*)currentThread) == (size_t*)currentThread)
+            return;
+
+        while (os::Atomic::CompareExchange(&klass->cctor_finished_or_no_cctor, 1, 1) != 1 && os::Atomic::CompareExchange(&klass->initializationExceptionGCHandle, 0, 0) == 0)
+            usleep(1000);
+    }
+    else
+    {
+        os::Atomic::ExchangePointer((size_t**)&klass->cctor_thread, (size_t*)os::Thread::CurrentThreadId());
+        os::Atomic::Exchange(&klass->cctor_started, 1);
+
+        s_TypeInitializationLock.Release();
+
+        Il2CppException* exception = NULL;
+        vm::Runtime::Invoke(vm::Class::GetCCtor(klass), NULL, NULL, &exception);
+
+        os::Atomic::ExchangePointer((size_t**)&klass->cctor_thread, (size_t*)0);
+        os::Atomic::Exchange(&klass->cctor_finished_or_no_cctor, 1);
+    }
+}
+
+static void Block(TestClass* testClass)
+{
+    usleep(kInitializerUs);
+}
+
+static TestClass* NewTestClass(void (*body)(TestClass* testClass))
+{
+    TestClass* testClass = new TestClass();
+    testClass->cctor.klass = &testClass->klass;
+    testClass->body = body;
+    testClass->runs = 0;
+    testClass->finishedNs = 0;
+    return testClass;
+}
+
+static void Reset(TestClass* testClass)
+{
+    testClass->klass.cctor_started = 0;
+    testClass->klass.cctor_finished_or_no_cctor = 0;
+    testClass->klass.cctor_thread = 0;
+    testClass->runs = 0;
+}
+
+struct Race
+{
+    void (*classInit)(Il2CppClass* klass);
+    TestClass** classes;
+    std::atomic<int> ready;
+    std::atomic<bool> go;
+    std::atomic<int64_t> wakeNs;
+    std::atomic<int> waits;
+    std::atomic<int> unfinished;
+};
+
+struct Racer
+{
+    Race* race;
+    uint32_t seed;
+};
+
+static void* TouchClasses(void* context)
+{
+    Racer& racer = *static_cast<Racer*>(context);
+    Race& race = *racer.race;
+
+    std::vector<int> order(kClassCount);
+    for (int i = 0; i < kClassCount; ++i)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(racer.seed));
+
+    race.ready++;
+    while (!race.go)
+        sched_yield();
+
+    for (int i = 0; i < kClassCount; ++i)
+    {
+        TestClass* testClass = race.classes[order[i]];
+        const bool running = testClass->klass.cctor_started && !testClass->klass.cctor_finished_or_no_cctor;
+
+        race.classInit(&testClass->klass);
+
+        if (!testClass->klass.cctor_finished_or_no_cctor)
+            race.unfinished++;
+        if (running)
+        {
+            race.wakeNs += NowNs() - testClass->finishedNs;
+            race.waits++;
+        }
+    }
+    return NULL;
+}
+
+// Runs the race kRounds times and prints the average round and the average wake up after a wait.
+static bool TimeRace(const char* label, void (*classInit)(Il2CppClass* klass), TestClass** classes, int threadCount)
+{
+    Race race;
+    race.classInit = classInit;
+    race.classes = classes;
+    race.wakeNs = 0;
+    race.waits = 0;
+    race.unfinished = 0;
+
+    bool passed = true;
+    int64_t totalNs = 0;
+    std::vector<pthread_t> threads(threadCount);
+    std::vector<Racer> racers(threadCount);
+
+    for (int round = 0; round < kRounds; ++round)
+    {
+        for (int i = 0; i < kClassCount; ++i)
+            Reset(classes[i]);
+        race.ready = 0;
+        race.go = false;
+
+        for (int i = 0; i < threadCount; ++i)
+        {
+            racers[i].race = &race;
+            racers[i].seed = round * 100 + i;
+            pthread_create(&threads[i], NULL, TouchClasses, &racers[i]);
+        }
+        while (race.ready != threadCount)
+            sched_yield();
+
+        const int64_t start = NowNs();
+        race.go = true;
+        for (int i = 0; i < threadCount; ++i)
+            pthread_join(threads[i], NULL);
+        totalNs += NowNs() - start;
+
+        for (int i = 0; i < kClassCount; ++i)
+            passed = classes[i]->runs == 1 && passed;
+    }
+
+    passed = race.unfinished == 0 && passed;
+    const int waits = race.waits;
+    printf("  %2d threads %-14s %8.2f ms per round %6d waits, woken %8.1f us after the initializer finished\n",
+        threadCount, label, totalNs / 1e6 / kRounds, waits, waits != 0 ? race.wakeNs / 1e3 / waits : 0.0);
+    return passed;
+}
+
+// Two initializers that each, once both have started, touch the other's type.
+static TestClass* s_First;
+static TestClass* s_Second;
+static std::atomic<int> s_Started;
+
+static void TouchOther(TestClass* testClass)
+{
+    s_Started++;
+    while (s_Started != 2)
+        sched_yield();
+
+    vm::Runtime::ClassInit(testClass == s_First ? &s_Second->klass : &s_First->klass);
+}
+
+static void* InitClass(void* context)
+{
+    vm::Runtime::ClassInit(&static_cast<TestClass*>(context)->klass);
+    return NULL;
+}
+
+static void TouchSelf(TestClass* testClass)
+{
+    vm::Runtime::ClassInit(&testClass->klass);
+}
+
+static bool CheckCycles()
+{
+    TestClass* self = NewTestClass(TouchSelf);
+    vm::Runtime::ClassInit(&self->klass);
+    const bool recursed = self->runs == 1 && self->klass.cctor_finished_or_no_cctor;
+
+    // Hung before: each thread slept until the other's initializer finished.
+    s_First = NewTestClass(TouchOther);
+    s_Second = NewTestClass(TouchOther);
+    s_Started = 0;
+    pthread_t first, second;
+    pthread_create(&first, NULL, InitClass, s_First);
+    pthread_create(&second, NULL, InitClass, s_Second);
+    pthread_join(first, NULL);
+    pthread_join(second, NULL);
+    const bool crossed = s_First->runs == 1 && s_Second->runs == 1 && s_First->klass.cctor_finished_or_no_cctor && s_Second->klass.cctor_finished_or_no_cctor;
+
+    printf("initializer touching its own type: %s, two initializers touching each other's: %s\n", recursed ? "ran" : "FAILED", crossed ? "ran" : "FAILED");
+    return recursed && crossed;
+}
+
+int main()
+{
+    // A hang in the cycle check fails the run instead of blocking it.
+    alarm(120);
+
+    std::vector<TestClass*> classes(kClassCount);
+    for (int i = 0; i < kClassCount; ++i)
+        classes[i] = NewTestClass(Block);
+
+    bool passed = CheckCycles();
+
+    printf("%d types with %d us initializers, %d rounds\n", kClassCount, kInitializerUs, kRounds);
+    const int threadCounts[] = { 2, 4, 8, 16 };
+    for (size_t i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); ++i)
+    {
+        passed = TimeRace("sleep and poll", ClassInitAsItWas, &classes[0], threadCounts[i]) && passed;
+        passed = TimeRace("blocking wait", vm::Runtime::ClassInit, &classes[0], threadCounts[i]) && passed;
+    }
+
+    printf(passed ? "PASSED\n" : "FAILED\n");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+// Times how long os::Handle::WaitAny and WaitAll, which back WaitHandle.WaitAny and WaitAll, take to wake up after
+// another thread signals one of their handles. Every case runs twice: with the events and semaphores as they are, which
+// wake the waiter through their WaitObject, and wrapped in a handle without a WaitObject, which makes Handle poll them
+// every 10 ms the way it did for all handles before.
+//
+// Linux only, see the Makefile.
+
+#include "il2cpp-config.h"
+#include "os/Event.h"
+#include "os/Handle.h"
+#include "os/Semaphore.h"
+#include "os/Thread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace il2cpp;
+
+static const int kWakeups = 200;
+static const int kPingPongs = 2000;
+
+static int64_t NowNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+// Forwards to another handle, but has no WaitObject, so Handle::WaitAny and WaitAll have to poll it.
+class PollingHandle : public os::Handle
+{
+public:
+    explicit PollingHandle(os::Handle* handle) : m_Handle(handle) {}
+
+    virtual bool Wait() { return m_Handle->Wait(); }
+    virtual bool Wait(uint32_t ms) { return m_Handle->Wait(ms); }
+    virtual os::WaitStatus Wait(bool interruptible) { return m_Handle->Wait(interruptible); }
+    virtual os::WaitStatus Wait(uint32_t ms, bool interruptible) { return m_Handle->Wait(ms, interruptible); }
+    virtual void Signal() { m_Handle->Signal(); }
+
+private:
+    os::Handle* m_Handle;
+};
+
+struct Handles
+{
+    os::EventHandle autoReset;
+    os::EventHandle manualReset;
+    os::SemaphoreHandle semaphore;
+    PollingHandle pollingAutoReset;
+    PollingHandle pollingManualReset;
+    PollingHandle pollingSemaphore;
+
+    Handles()
+        : autoReset(new os::Event(false, false)), manualReset(new os::Event(true, false)), semaphore(new os::Semaphore(0, 1000)),
+        pollingAutoReset(&autoReset), pollingManualReset(&manualReset), pollingSemaphore(&semaphore)
+    {
+    }
+};
+
+struct Signaler
+{
+    std::vector<os::Handle*> handles;
+    std::atomic<int64_t> signaledAt;
+    std::atomic<bool> waiting;
+    std::atomic<bool> done;
+};
+
+// Signals the handles one after the other, each once the waiter is back in its wait, after a short pause so the
+// waiter has gone to sleep.
+static void* Signal(void* context)
+{
+    os::Thread::Init();
+    Signaler& signaler = *static_cast<Signaler*>(context);
+
+    while (!signaler.done)
+    {
+        if (!signaler.waiting.exchange(false))
+        {
+            sched_yield();
+            continue;
+        }
+
+        usleep(2000);
+        for (size_t i = 0; i < signaler.handles.size(); ++i)
+        {
+            if (i == signaler.handles.size() - 1)
+                signaler.signaledAt = NowNs();
+            signaler.handles[i]->Signal();
+        }
+    }
+
+    return NULL;
+}
+
+static void PrintLatency(const char* label, std::vector<int64_t>& latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+    printf("  %-28s median %8.3f ms, p99 %8.3f ms, max %8.3f ms\n", label,
+        latencies[latencies.size() / 2] / 1e6, latencies[latencies.size() * 99 / 100] / 1e6, latencies.back() / 1e6);
+}
+
+// Latency from the last Signal a wait needs to the wait returning.
+static void TimeWakeup(const char* label, os::Handle** handles, int32_t count, os::Handle** signaled, int32_t signaledCount, bool waitAll, os::Handle* manualReset)
+{
+    Signaler signaler;
+    signaler.handles.assign(signaled, signaled + signaledCount);
+    signaler.waiting = false;
+    signaler.done = false;
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, Signal, &signaler);
+
+    std::vector<int64_t> latencies;
+    for (int i = 0; i < kWakeups; ++i)
+    {
+        signaler.waiting = true;
+        if (waitAll)
+            os::Handle::WaitAll(handles, count, -1);
+        else
+            os::Handle::WaitAny(handles, count, -1);
+        latencies.push_back(NowNs() - signaler.signaledAt);
+
+        if (manualReset != NULL)
+            static_cast<os::EventHandle*>(manualReset)->Get().Reset();
+    }
+
+    signaler.done = true;
+    pthread_join(thread, NULL);
+    PrintLatency(label, latencies);
+}
+
+struct PingPong
+{
+    os::Handle* ping[2];
+    os::Handle* pong[2];
+};
+
+static void* Pong(void* context)
+{
+    os::Thread::Init();
+    PingPong& pingPong = *static_cast<PingPong*>(context);
+    for (int i = 0; i < kPingPongs; ++i)
+    {
+        os::Handle::WaitAny(pingPong.ping, 2, -1);
+        pingPong.pong[1]->Signal();
+    }
+    return NULL;
+}
+
+// Two threads handing control back and forth, each waiting on its event and one that is never signaled.
+static void TimePingPong(const char* label, os::Handle* idle, os::Handle* ping, os::Handle* pong)
+{
+    PingPong pingPong = { { idle, ping }, { idle, pong } };
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, Pong, &pingPong);
+
+    const int64_t start = NowNs();
+    for (int i = 0; i < kPingPongs; ++i)
+    {
+        ping->Signal();
+        os::Handle::WaitAny(pingPong.pong, 2, -1);
+    }
+    const int64_t elapsed = NowNs() - start;
+
+    pthread_join(thread, NULL);
+    printf("  %-28s %8.3f ms per round trip\n", label, elapsed / 1e6 / kPingPongs);
+}
+
+int main()
+{
+    os::Thread::Init();
+    Handles handles;
+
+    printf("WaitAny, woken by one of an auto reset event, a manual reset event and a semaphore\n");
+    {
+        os::Handle* waited[] = { &handles.autoReset, &handles.manualReset, &handles.semaphore };
+        os::Handle* signaled[] = { &handles.semaphore };
+        TimeWakeup("wait objects", waited, 3, signaled, 1, false, NULL);
+
+        os::Handle* polled[] = { &handles.pollingAutoReset, &handles.pollingManualReset, &handles.pollingSemaphore };
+        TimeWakeup("polling", polled, 3, signaled, 1, false, NULL);
+    }
+
+    printf("WaitAll, woken by the last of the three\n");
+    {
+        os::Handle* waited[] = { &handles.autoReset, &handles.manualReset, &handles.semaphore };
+        os::Handle* signaled[] = { &handles.autoReset, &handles.manualReset, &handles.semaphore };
+        TimeWakeup("wait objects", waited, 3, signaled, 3, true, &handles.manualReset);
+
+        os::Handle* polled[] = { &handles.pollingAutoReset, &handles.pollingManualReset, &handles.pollingSemaphore };
+        TimeWakeup("polling", polled, 3, signaled, 3, true, &handles.manualReset);
+    }
+
+    printf("WaitAny ping pong between two threads\n");
+    {
+        os::EventHandle idle(new os::Event(true, false));
+        os::EventHandle ping(new os::Event(false, false));
+        os::EventHandle pong(new os::Event(false, false));
+        TimePingPong("wait objects", &idle, &ping, &pong);
+
+        PollingHandle pollingIdle(&idle), pollingPing(&ping), pollingPong(&pong);
+        TimePingPong("polling", &pollingIdle, &pollingPing, &pollingPong);
+    }
+
+    return 0;
+}
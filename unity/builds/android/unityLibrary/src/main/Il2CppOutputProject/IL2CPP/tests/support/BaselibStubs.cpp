@@ -0,0 +1,58 @@
+// The few baselib functions the programs in this directory need, for Linux hosts. libil2cpp links against the
+// prebuilt baselib library of the platform, which is not part of this tree.
+
+#include "il2cpp-config.h"
+#include "Baselib.h"
+#include "C/Baselib_SystemFutex.h"
+#include "C/Baselib_Thread.h"
+#include "C/Baselib_Timer.h"
+
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace il2cpp_baselib
+{
+    void Baselib_SystemFutex_Notify(int32_t* address, uint32_t count, Baselib_WakeupFallbackStrategy)
+    {
+        syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+    }
+
+    void Baselib_SystemFutex_Wait(int32_t* address, int32_t expected, uint32_t timeoutInMilliseconds)
+    {
+        timespec timeout = { (time_t)(timeoutInMilliseconds / 1000), (long)(timeoutInMilliseconds % 1000) * 1000000 };
+        syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, timeoutInMilliseconds == UINT32_MAX ? NULL : &timeout, NULL, 0);
+    }
+
+    Baselib_Thread_Id Baselib_Thread_GetCurrentThreadId()
+    {
+        return (Baselib_Thread_Id)pthread_self();
+    }
+
+    void Baselib_Thread_YieldExecution()
+    {
+        sched_yield();
+    }
+
+    Baselib_Timer_Ticks Baselib_Timer_GetHighPrecisionTimerTicks()
+    {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (Baselib_Timer_Ticks)now.tv_sec * 1000000000 + now.tv_nsec;
+    }
+
+    const double Baselib_Timer_TickToNanosecondsConversionFactor = 1.0;
+
+    void detail_AssertLog(const char* format, ...)
+    {
+        va_list arguments;
+        va_start(arguments, format);
+        vfprintf(stderr, format, arguments);
+        va_end(arguments);
+    }
+}
@@ -0,0 +1,275 @@
+// Reads a file written by il2cpp_profiler_start_capture, see vm/ProfilerCapture.h for the layout, and prints either
+// every record, one per line, or with -s a summary: the sampled allocations by class, scaled up by the sample interval,
+// the most entered methods, the GC events and the records dropped because a buffer was full.
+//
+// Build from this directory with:
+//   g++ -std=c++11 -O2 -DIL2CPP_ENABLE_PROFILER=1 -I../libil2cpp -I../libil2cpp/pch -I../external/baselib/Include
+//       -I../external/baselib/Platforms/<host platform>/Include DecodeProfilerCapture.cpp -o DecodeProfilerCapture
+// and run as
+//   DecodeProfilerCapture [-s] <capture file>
+// on a host with the endianness of the device that wrote the file.
+
+#include "il2cpp-config.h"
+#include "vm/ProfilerCapture.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+using il2cpp::vm::CaptureFileHeader;
+using il2cpp::vm::CaptureRecord;
+
+struct AllocationTotal
+{
+    uint64_t count;
+    uint64_t bytes;
+};
+
+struct Capture
+{
+    CaptureFileHeader header;
+    std::map<uint64_t, std::string> names;
+
+    bool summarize;
+    std::map<uint64_t, AllocationTotal> allocations;
+    std::map<uint64_t, uint64_t> methodEnters;
+    std::map<uint32_t, uint64_t> gcEvents;
+    std::map<uint64_t, uint64_t> recordsByThread;
+    uint64_t droppedCount;
+    uint64_t recordCount;
+};
+
+static const char* kGCEventNames[] =
+{
+    "start", "mark start", "mark end", "reclaim start", "reclaim end", "end",
+    "pre stop world", "post stop world", "pre start world", "post start world"
+};
+
+static const char* GetGCEventName(uint32_t event)
+{
+    return event < sizeof(kGCEventNames) / sizeof(kGCEventNames[0]) ? kGCEventNames[event] : "unknown";
+}
+
+static std::string GetName(const Capture& capture, uint64_t pointer)
+{
+    std::map<uint64_t, std::string>::const_iterator name = capture.names.find(pointer);
+    if (name != capture.names.end())
+        return name->second;
+
+    char unnamed[32];
+    snprintf(unnamed, sizeof(unnamed), "0x%" PRIx64, pointer);
+    return unnamed;
+}
+
+static void PrintRecord(const Capture& capture, uint64_t threadId, const CaptureRecord& record)
+{
+    printf("%.7f %" PRIu64 " ", (double)record.timestamp / capture.header.ticksPerSecond, threadId);
+
+    switch (record.kind)
+    {
+        case il2cpp::vm::kCaptureRecordDropped:
+            printf("dropped %u\n", record.value);
+            break;
+        case il2cpp::vm::kCaptureRecordAllocation:
+            printf("alloc %s %u\n", GetName(capture, record.data).c_str(), record.value);
+            break;
+        case il2cpp::vm::kCaptureRecordStackFrame:
+            printf("  at %s\n", GetName(capture, record.data).c_str());
+            break;
+        case il2cpp::vm::kCaptureRecordMethodEnter:
+            printf("enter %s\n", GetName(capture, record.data).c_str());
+            break;
+        case il2cpp::vm::kCaptureRecordMethodExit:
+            printf("exit %s\n", GetName(capture, record.data).c_str());
+            break;
+        case il2cpp::vm::kCaptureRecordGCEvent:
+            printf("gc %s\n", GetGCEventName(record.value));
+            break;
+        case il2cpp::vm::kCaptureRecordGCHeapResize:
+            printf("gc heap resize %" PRIu64 "\n", record.data);
+            break;
+        case il2cpp::vm::kCaptureRecordThreadStart:
+            printf("thread start %" PRIu64 "\n", record.data);
+            break;
+        case il2cpp::vm::kCaptureRecordThreadEnd:
+            printf("thread end %" PRIu64 "\n", record.data);
+            break;
+        default:
+            printf("unknown record %u\n", record.kind);
+            break;
+    }
+}
+
+static void CountRecord(Capture* capture, uint64_t threadId, const CaptureRecord& record)
+{
+    capture->recordCount++;
+    capture->recordsByThread[threadId]++;
+
+    switch (record.kind)
+    {
+        case il2cpp::vm::kCaptureRecordDropped:
+            capture->droppedCount += record.value;
+            break;
+        case il2cpp::vm::kCaptureRecordAllocation:
+        {
+            AllocationTotal& total = capture->allocations[record.data];
+            total.count++;
+            total.bytes += record.value;
+            break;
+        }
+        case il2cpp::vm::kCaptureRecordMethodEnter:
+            capture->methodEnters[record.data]++;
+            break;
+        case il2cpp::vm::kCaptureRecordGCEvent:
+            capture->gcEvents[record.value]++;
+            break;
+        default:
+            break;
+    }
+}
+
+static bool Read(FILE* file, void* data, size_t size)
+{
+    return fread(data, 1, size, file) == size;
+}
+
+static bool ReadCapture(FILE* file, Capture* capture)
+{
+    CaptureRecord record;
+    while (Read(file, &record, sizeof(record)))
+    {
+        if (record.kind == il2cpp::vm::kCaptureRecordName)
+        {
+            std::string name(record.value, '\0');
+            char padding[8];
+            if (!Read(file, &name[0], name.length()) || !Read(file, padding, (8 - name.length() % 8) % 8))
+                return false;
+            capture->names[record.data] = name;
+            continue;
+        }
+
+        if (record.kind != il2cpp::vm::kCaptureRecordChunk)
+        {
+            fprintf(stderr, "Expected a chunk, found a record of kind %u\n", record.kind);
+            return false;
+        }
+
+        const uint64_t threadId = record.data;
+        for (uint32_t i = 0; i < record.value; i++)
+        {
+            CaptureRecord chunkRecord;
+            if (!Read(file, &chunkRecord, sizeof(chunkRecord)))
+                return false;
+
+            if (capture->summarize)
+                CountRecord(capture, threadId, chunkRecord);
+            else
+                PrintRecord(*capture, threadId, chunkRecord);
+        }
+    }
+
+    return feof(file) != 0;
+}
+
+template<typename Value>
+static bool IsGreater(const std::pair<uint64_t, Value>& left, const std::pair<uint64_t, Value>& right)
+{
+    return left.first > right.first;
+}
+
+static void PrintSummary(const Capture& capture)
+{
+    const uint64_t interval = capture.header.allocationSampleInterval;
+    printf("%" PRIu64 " records from %zu threads, %" PRIu64 " dropped\n", capture.recordCount, capture.recordsByThread.size(), capture.droppedCount);
+
+    if (!capture.allocations.empty())
+    {
+        std::vector<std::pair<uint64_t, std::string> > rows;
+        for (std::map<uint64_t, AllocationTotal>::const_iterator it = capture.allocations.begin(); it != capture.allocations.end(); ++it)
+        {
+            char row[64];
+            snprintf(row, sizeof(row), "%12" PRIu64 " %14" PRIu64 "  ", it->second.count * interval, it->second.bytes * interval);
+            rows.push_back(std::make_pair(it->second.bytes, row + GetName(capture, it->first)));
+        }
+        std::sort(rows.begin(), rows.end(), IsGreater<std::string>);
+
+        printf("\nAllocations, one in %" PRIu64 " sampled\n%12s %14s  class\n", interval, "count", "bytes");
+        for (size_t i = 0; i < rows.size(); i++)
+            printf("%s\n", rows[i].second.c_str());
+    }
+
+    if (!capture.methodEnters.empty())
+    {
+        std::vector<std::pair<uint64_t, uint64_t> > rows;
+        for (std::map<uint64_t, uint64_t>::const_iterator it = capture.methodEnters.begin(); it != capture.methodEnters.end(); ++it)
+            rows.push_back(std::make_pair(it->second, it->first));
+        std::sort(rows.begin(), rows.end(), IsGreater<uint64_t>);
+
+        printf("\nMethod calls\n%12s  method\n", "count");
+        for (size_t i = 0; i < rows.size() && i < 50; i++)
+            printf("%12" PRIu64 "  %s\n", rows[i].first, GetName(capture, rows[i].second).c_str());
+    }
+
+    if (!capture.gcEvents.empty())
+    {
+        printf("\nGC events\n");
+        for (std::map<uint32_t, uint64_t>::const_iterator it = capture.gcEvents.begin(); it != capture.gcEvents.end(); ++it)
+            printf("%12" PRIu64 "  %s\n", it->second, GetGCEventName(it->first));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Capture capture;
+    capture.summarize = argc == 3 && strcmp(argv[1], "-s") == 0;
+    capture.droppedCount = 0;
+    capture.recordCount = 0;
+
+    if (argc != 2 && !capture.summarize)
+    {
+        fprintf(stderr, "usage: %s [-s] <capture file>\n", argv[0]);
+        return 2;
+    }
+
+    const char* path = argv[argc - 1];
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Could not open %s\n", path);
+        return 1;
+    }
+
+    if (!Read(file, &capture.header, sizeof(capture.header)) || memcmp(capture.header.magic, "IL2CPPPC", sizeof(capture.header.magic)) != 0)
+    {
+        fprintf(stderr, "%s is not a profiler capture\n", path);
+        fclose(file);
+        return 1;
+    }
+
+    if (capture.header.version != 1 || capture.header.recordSize != sizeof(CaptureRecord) || capture.header.ticksPerSecond == 0)
+    {
+        fprintf(stderr, "%s is a version %u capture with %u byte records, this tool reads version 1 with %zu byte records\n",
+            path, capture.header.version, capture.header.recordSize, sizeof(CaptureRecord));
+        fclose(file);
+        return 1;
+    }
+
+    const bool complete = ReadCapture(file, &capture);
+    fclose(file);
+
+    if (capture.summarize)
+        PrintSummary(capture);
+
+    if (!complete)
+    {
+        fprintf(stderr, "%s ends in the middle of a record\n", path);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+// Writes Metadata/global-metadata-literals.dat, which a runtime built with IL2CPP_ENABLE_FROZEN_STRING_LITERALS uses in
+// place of transcoding the string literals of global-metadata.dat: every literal laid out as an Il2CppString of the
+// target, see Il2CppFrozenStringLiteralsHeader. Run it after il2cpp has written global-metadata.dat, once per pointer
+// size the build targets, and put the output next to global-metadata.dat. A file that does not match the
+// global-metadata.dat next to it is ignored by the runtime.
+//
+// Build from this directory with:
+//   g++ -std=c++11 -O2 -I../libil2cpp -I../libil2cpp/pch -I../external/xxHash -I../external/baselib/Include
+//       -I../external/baselib/Platforms/<host platform>/Include FreezeStringLiterals.cpp -o FreezeStringLiterals
+// and run as
+//   FreezeStringLiterals <global-metadata.dat> <target pointer size, 4 or 8> <global-metadata-literals.dat>
+
+#include "il2cpp-config.h"
+#include "vm/GlobalMetadataFileInternals.h"
+#include "utils/utf8-cpp/source/utf8.h"
+
+#define XXH_INLINE_ALL
+#include "xxhash.h"
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool ReadFile(const char* path, std::vector<char>* contents)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+        return false;
+
+    bool read = fseek(file, 0, SEEK_END) == 0;
+    const long size = read ? ftell(file) : -1;
+    read = size >= 0 && fseek(file, 0, SEEK_SET) == 0;
+    if (read)
+    {
+        contents->resize(size);
+        read = fread(contents->data(), 1, size, file) == (size_t)size;
+    }
+
+    fclose(file);
+    return read;
+}
+
+static bool IsInFile(const std::vector<char>& file, int32_t offset, int32_t size)
+{
+    return offset >= 0 && size >= 0 && (int64_t)offset + size <= (int64_t)file.size();
+}
+
+template<typename T>
+static void Append(std::vector<char>* output, const T& value)
+{
+    output->insert(output->end(), (const char*)&value, (const char*)&value + sizeof(value));
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 4 || (strcmp(argv[2], "4") != 0 && strcmp(argv[2], "8") != 0))
+    {
+        fprintf(stderr, "usage: %s <global-metadata.dat> <target pointer size, 4 or 8> <global-metadata-literals.dat>\n", argv[0]);
+        return 2;
+    }
+
+    const int32_t pointerSize = atoi(argv[2]);
+
+    std::vector<char> metadata;
+    if (!ReadFile(argv[1], &metadata) || metadata.size() < sizeof(Il2CppGlobalMetadataHeader))
+    {
+        fprintf(stderr, "Could not read %s\n", argv[1]);
+        return 1;
+    }
+
+    const Il2CppGlobalMetadataHeader* metadataHeader = (const Il2CppGlobalMetadataHeader*)metadata.data();
+    if (metadataHeader->sanity != (int32_t)0xFAB11BAF
+        || !IsInFile(metadata, metadataHeader->stringLiteralOffset, metadataHeader->stringLiteralSize)
+        || !IsInFile(metadata, metadataHeader->stringLiteralDataOffset, metadataHeader->stringLiteralDataSize))
+    {
+        fprintf(stderr, "%s is not a global-metadata.dat file\n", argv[1]);
+        return 1;
+    }
+
+    const Il2CppStringLiteral* stringLiterals = (const Il2CppStringLiteral*)(metadata.data() + metadataHeader->stringLiteralOffset);
+    const char* stringLiteralData = metadata.data() + metadataHeader->stringLiteralDataOffset;
+    const int32_t stringLiteralCount = metadataHeader->stringLiteralSize / sizeof(Il2CppStringLiteral);
+
+    // Must match HashStringLiterals in vm/GlobalMetadata.cpp.
+    const uint64_t stringLiteralHash = XXH64(metadata.data() + metadataHeader->stringLiteralOffset, metadataHeader->stringLiteralSize, 0);
+
+    Il2CppFrozenStringLiteralsHeader header;
+    memset(&header, 0, sizeof(header));
+    header.sanity = metadataHeader->sanity;
+    header.version = metadataHeader->version;
+    header.pointerSize = pointerSize;
+    header.stringLiteralCount = stringLiteralCount;
+    header.stringOffsetsOffset = sizeof(header);
+    header.stringLiteralsHash = XXH64(stringLiteralData, metadataHeader->stringLiteralDataSize, stringLiteralHash);
+
+    std::vector<char> output(sizeof(header) + stringLiteralCount * sizeof(int32_t));
+    std::vector<uint16_t> chars;
+
+    for (int32_t i = 0; i < stringLiteralCount; i++)
+    {
+        const Il2CppStringLiteral& stringLiteral = stringLiterals[i];
+        int32_t stringOffset = 0;
+
+        // The runtime never looks empty literals up, they are all String.Empty.
+        if (stringLiteral.length != 0)
+        {
+            if ((int64_t)stringLiteral.dataIndex + stringLiteral.length > metadataHeader->stringLiteralDataSize)
+            {
+                fprintf(stderr, "String literal %d is out of the bounds of %s\n", i, argv[1]);
+                return 1;
+            }
+
+            // Same as StringUtils::Utf8ToUtf16, which leaves invalid UTF-8 empty.
+            const char* utf8 = stringLiteralData + stringLiteral.dataIndex;
+            chars.clear();
+            if (utf8::is_valid(utf8, utf8 + stringLiteral.length))
+                utf8::unchecked::utf8to16(utf8, utf8 + stringLiteral.length, std::back_inserter(chars));
+
+            output.resize((output.size() + pointerSize - 1) & ~(size_t)(pointerSize - 1));
+            stringOffset = (int32_t)output.size();
+
+            // A zeroed Il2CppObject (klass and monitor), the length, then the NUL terminated characters.
+            output.resize(output.size() + 2 * pointerSize);
+            Append(&output, (int32_t)chars.size());
+            output.insert(output.end(), (const char*)chars.data(), (const char*)(chars.data() + chars.size()));
+            Append(&output, (uint16_t)0);
+        }
+
+        memcpy(output.data() + header.stringOffsetsOffset + i * sizeof(int32_t), &stringOffset, sizeof(stringOffset));
+    }
+
+    if (output.size() > INT32_MAX)
+    {
+        fprintf(stderr, "The string literals of %s do not fit in one file\n", argv[1]);
+        return 1;
+    }
+
+    header.fileSize = (int32_t)output.size();
+    memcpy(output.data(), &header, sizeof(header));
+
+    FILE* file = fopen(argv[3], "wb");
+    const bool written = file != NULL && fwrite(output.data(), 1, output.size(), file) == output.size();
+    if (file == NULL || fclose(file) != 0 || !written)
+    {
+        fprintf(stderr, "Could not write %s\n", argv[3]);
+        return 1;
+    }
+
+    printf("Wrote %d string literals for %d byte pointers, %d bytes\n", stringLiteralCount, pointerSize, header.fileSize);
+    return 0;
+}